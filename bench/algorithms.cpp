@@ -101,6 +101,231 @@ void BM_isop_dynamic( benchmark::State& state )
   }
 }
 
+void BM_isop_dynamic_large( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    state.ResumeTiming();
+    isop( tt );
+  }
+}
+
+void BM_isop_engine_static( benchmark::State& state )
+{
+  static_truth_table<6> tt;
+  isop_engine engine;
+  std::vector<cube> cubes;
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    state.ResumeTiming();
+    engine.run( tt, cubes );
+  }
+}
+
+void BM_isop_engine_dynamic( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  isop_engine engine( tt.num_vars() );
+  std::vector<cube> cubes;
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    state.ResumeTiming();
+    engine.run( tt, cubes );
+  }
+}
+
+/* outputs that share a subfunction in the positive cofactor of the top variable,
+   second argument is the smallest number of variables of cached subproblems (0 = no cache) */
+void BM_isop_engine_cached( benchmark::State& state )
+{
+  const auto num_vars = static_cast<uint32_t>( state.range( 0 ) );
+  dynamic_truth_table shared( num_vars ), x( num_vars ), y( num_vars );
+  create_nth_var( x, num_vars - 1 );
+  create_nth_var( y, num_vars - 2 );
+  std::vector<dynamic_truth_table> outputs( 8u, shared );
+
+  isop_cache_params ps;
+  ps.min_vars = state.range( 1 );
+  isop_cache cache( ps );
+  isop_engine engine( num_vars, state.range( 1 ) ? &cache : nullptr );
+  std::vector<cube> cubes;
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( shared );
+    for ( auto& tt : outputs )
+    {
+      create_random( tt );
+      tt = ( x & shared & y ) | ( ~x & tt & ~y );
+    }
+    state.ResumeTiming();
+    for ( const auto& tt : outputs )
+    {
+      engine.run( tt, cubes );
+    }
+  }
+  state.counters["hit_rate"] = cache.statistics().hit_rate();
+}
+
+void BM_parallel_isop( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  parallel_isop_params ps;
+  ps.num_threads = state.range( 1 );
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    state.ResumeTiming();
+    benchmark::DoNotOptimize( parallel_isop( tt, ps ) );
+  }
+}
+
+void BM_espresso( benchmark::State& state )
+{
+  dynamic_truth_table on( state.range( 0 ) ), dc( state.range( 0 ) ), r( state.range( 0 ) );
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( on );
+    create_random( dc );
+    create_random( r );
+    dc &= r; /* about a quarter of the minterms are don't cares */
+    state.ResumeTiming();
+    benchmark::DoNotOptimize( espresso( on, dc ) );
+  }
+}
+
+void BM_esop_from_optimum_pkrm( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    state.ResumeTiming();
+    benchmark::DoNotOptimize( esop_from_optimum_pkrm( tt ) );
+  }
+}
+
+void BM_exorcism( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    state.ResumeTiming();
+    benchmark::DoNotOptimize( exorcism( tt ) );
+  }
+}
+
+void BM_cnf_characteristic( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_random( tt );
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( cnf_characteristic( tt ) );
+  }
+}
+
+void BM_cnf_mux_encoding( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_random( tt );
+  std::vector<int> inputs( tt.num_vars() );
+  std::iota( inputs.begin(), inputs.end(), 1 );
+  clause_arena arena;
+  while ( state.KeepRunning() )
+  {
+    arena.clear();
+    for ( auto i = 0u; i < tt.num_vars(); ++i )
+    {
+      arena.add_variable();
+    }
+    benchmark::DoNotOptimize( cnf_mux_encoding( tt, inputs, arena ) );
+  }
+}
+
+void BM_minimize_spp( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    state.ResumeTiming();
+    benchmark::DoNotOptimize( minimize_spp( tt ) );
+  }
+}
+
+void BM_algebraic_normal_form( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_random( tt );
+  while ( state.KeepRunning() )
+  {
+    algebraic_normal_form_inplace( tt, static_cast<uint32_t>( state.range( 1 ) ) );
+    benchmark::DoNotOptimize( tt );
+  }
+}
+
+void BM_polynomial_degree( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_random( tt );
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( polynomial_degree( tt ) );
+  }
+}
+
+void BM_exact_sop( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) ), r( state.range( 0 ) );
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt );
+    if ( state.range( 1 ) == 0 )
+    {
+      create_random( r );
+      tt &= r;
+      create_random( r );
+      tt &= r; /* sparse onset, about an eighth of the minterms */
+    }
+    state.ResumeTiming();
+    benchmark::DoNotOptimize( exact_sop( tt ) );
+  }
+}
+
+void BM_find_resubstitution( benchmark::State& state )
+{
+  /* 1024 simulation patterns, target depends on three of the last divisors */
+  std::vector<partial_truth_table> divisors( state.range( 0 ), partial_truth_table( 1024u ) );
+  for ( auto i = 0u; i < divisors.size(); ++i )
+  {
+    create_random( divisors[i], i );
+  }
+  const auto n = divisors.size();
+  const auto target = ternary_majority( divisors[n - 1u], divisors[n - 2u], divisors[n - 3u] ) ^ divisors[n - 2u];
+
+  resubstitution_params ps;
+  ps.num_threads = static_cast<uint32_t>( state.range( 1 ) );
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( find_resubstitution( target, divisors, ps ) );
+  }
+}
+
 BENCHMARK( BM_exact_npn_canonization_static );
 BENCHMARK( BM_exact_npn_canonization_dynamic );
 
@@ -109,5 +334,21 @@ BENCHMARK( BM_exact_spectral_canonization_dynamic );
 
 BENCHMARK( BM_isop_static );
 BENCHMARK( BM_isop_dynamic );
+BENCHMARK( BM_isop_dynamic_large )->Arg( 10 )->Arg( 12 )->Arg( 14 )->Arg( 16 );
+BENCHMARK( BM_isop_engine_static );
+BENCHMARK( BM_isop_engine_dynamic )->Arg( 6 )->Arg( 10 )->Arg( 12 )->Arg( 14 )->Arg( 16 );
+BENCHMARK( BM_isop_engine_cached )->Args( { 12, 0 } )->Args( { 12, 10 } )->Args( { 16, 0 } )->Args( { 16, 10 } )->Args( { 16, 14 } );
+BENCHMARK( BM_espresso )->Arg( 6 )->Arg( 8 )->Arg( 10 );
+BENCHMARK( BM_esop_from_optimum_pkrm )->Arg( 8 )->Arg( 12 )->Arg( 16 );
+BENCHMARK( BM_exorcism )->Arg( 6 )->Arg( 8 )->Arg( 10 );
+BENCHMARK( BM_cnf_characteristic )->Arg( 10 )->Arg( 14 );
+BENCHMARK( BM_cnf_mux_encoding )->Arg( 10 )->Arg( 14 )->Arg( 18 );
+BENCHMARK( BM_minimize_spp )->Arg( 8 )->Arg( 12 )->Arg( 16 )->Unit( benchmark::kMillisecond );
+BENCHMARK( BM_algebraic_normal_form )->Args( { 16, 1 } )->Args( { 20, 1 } )->Args( { 24, 1 } )->Args( { 24, 0 } )->UseRealTime();
+BENCHMARK( BM_polynomial_degree )->Arg( 10 )->Arg( 16 )->Arg( 20 );
+BENCHMARK( BM_exact_sop )->Args( { 8, 0 } )->Args( { 12, 0 } )->Args( { 14, 0 } )->Args( { 8, 1 } )->Args( { 10, 1 } )->Args( { 12, 1 } )->Unit( benchmark::kMillisecond );
+BENCHMARK( BM_parallel_isop )->Args( { 18, 1 } )->Args( { 18, 0 } )->Args( { 20, 1 } )->Args( { 20, 0 } )->Unit( benchmark::kMillisecond )->UseRealTime();
+
+BENCHMARK( BM_find_resubstitution )->Args( { 50, 1 } )->Args( { 200, 1 } )->Args( { 200, 0 } )->UseRealTime();
 
 BENCHMARK_MAIN()
@@ -0,0 +1,154 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <kitty/kitty.hpp>
+
+using namespace kitty;
+
+/* previous hash function, combining the words one at a time */
+static std::size_t hash_combined( const dynamic_truth_table& tt )
+{
+  auto it = tt.cbegin();
+  auto seed = hash_block( *it++ );
+  while ( it != tt.cend() )
+  {
+    hash_combine( seed, hash_block( *it++ ) );
+  }
+  return seed;
+}
+
+/* structured functions: all functions with one or two minterms, and all symmetric functions */
+static std::vector<dynamic_truth_table> structured_functions( uint32_t num_vars )
+{
+  std::vector<dynamic_truth_table> tts;
+  const auto num_bits = 1u << num_vars;
+  for ( auto i = 0u; i < num_bits; ++i )
+  {
+    for ( auto j = i; j < num_bits; ++j )
+    {
+      tts.emplace_back( num_vars );
+      set_bit( tts.back(), i );
+      set_bit( tts.back(), j );
+    }
+  }
+
+  for ( auto counts = 0u; counts < ( 1u << ( num_vars + 1u ) ); ++counts )
+  {
+    tts.emplace_back( num_vars );
+    for ( auto i = 0u; i < num_bits; ++i )
+    {
+      if ( ( counts >> __builtin_popcount( i ) ) & 1 )
+      {
+        set_bit( tts.back(), i );
+      }
+    }
+  }
+  return tts;
+}
+
+/* inserts the hash values of all structured functions into an open-addressing
+   table with linear probing and reports the average and maximum probe length */
+template<typename Fn>
+void hash_collisions( benchmark::State& state, Fn&& fn )
+{
+  const auto tts = structured_functions( state.range( 0 ) );
+  std::vector<std::size_t> table;
+  uint64_t total_probes{}, max_probes{};
+
+  while ( state.KeepRunning() )
+  {
+    table.assign( 2u * tts.size(), ~std::size_t( 0 ) );
+    total_probes = max_probes = 0u;
+    for ( const auto& tt : tts )
+    {
+      const auto h = fn( tt );
+      auto probes = 1u;
+      for ( auto i = h % table.size(); table[i] != ~std::size_t( 0 ); i = ( i + 1u ) % table.size() )
+      {
+        ++probes;
+      }
+      for ( auto i = h % table.size();; i = ( i + 1u ) % table.size() )
+      {
+        if ( table[i] == ~std::size_t( 0 ) )
+        {
+          table[i] = h;
+          break;
+        }
+      }
+      total_probes += probes;
+      max_probes = std::max<uint64_t>( max_probes, probes );
+    }
+  }
+
+  state.counters["avg_probes"] = static_cast<double>( total_probes ) / tts.size();
+  state.counters["max_probes"] = static_cast<double>( max_probes );
+}
+
+void BM_hash_collisions_combined( benchmark::State& state )
+{
+  hash_collisions( state, hash_combined );
+}
+
+void BM_hash_collisions_words( benchmark::State& state )
+{
+  hash_collisions( state, hash<dynamic_truth_table>() );
+}
+
+void BM_hash_throughput_combined( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_random( tt );
+
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( hash_combined( tt ) );
+  }
+  state.SetBytesProcessed( state.iterations() * tt.num_blocks() * sizeof( uint64_t ) );
+}
+
+void BM_hash_throughput_words( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_random( tt );
+
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( hash<dynamic_truth_table>()( tt ) );
+  }
+  state.SetBytesProcessed( state.iterations() * tt.num_blocks() * sizeof( uint64_t ) );
+}
+
+BENCHMARK( BM_hash_collisions_combined )->Arg( 8 )->Arg( 10 );
+BENCHMARK( BM_hash_collisions_words )->Arg( 8 )->Arg( 10 );
+BENCHMARK( BM_hash_throughput_combined )->Arg( 6 )->Arg( 10 )->Arg( 16 );
+BENCHMARK( BM_hash_throughput_words )->Arg( 6 )->Arg( 10 )->Arg( 16 );
+
+BENCHMARK_MAIN()
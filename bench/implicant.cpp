@@ -58,7 +58,31 @@ void BM_jbuddies( benchmark::State& state )
   }
 }
 
+void BM_prime_implicants_morreale( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_majority( tt );
+
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( get_prime_implicants_morreale( tt ) );
+  }
+}
+
+void BM_prime_implicants_blake( benchmark::State& state )
+{
+  dynamic_truth_table tt( state.range( 0 ) );
+  create_majority( tt );
+
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( get_prime_implicants_blake( tt ) );
+  }
+}
+
 BENCHMARK( BM_minterms )->Arg( 9 )->Arg( 11 )->Arg( 13 )->Arg( 15 );
 BENCHMARK( BM_jbuddies )->Arg( 9 )->Arg( 11 )->Arg( 13 )->Arg( 15 );
+BENCHMARK( BM_prime_implicants_morreale )->Arg( 9 )->Arg( 11 )->Arg( 13 )->Arg( 15 )->Arg( 17 );
+BENCHMARK( BM_prime_implicants_blake )->Arg( 9 )->Arg( 11 )->Arg( 13 )->Arg( 15 )->Arg( 17 );
 
 BENCHMARK_MAIN()
@@ -0,0 +1,142 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/operations.hpp>
+
+using namespace kitty;
+
+/* random member of the NPN class of tt */
+dynamic_truth_table random_npn_transform( const dynamic_truth_table& tt, std::default_random_engine& gen )
+{
+  std::vector<uint8_t> perm( tt.num_vars() );
+  std::iota( perm.begin(), perm.end(), 0u );
+  std::shuffle( perm.begin(), perm.end(), gen );
+
+  const auto phase = std::uniform_int_distribution<uint32_t>( 0u, ( 2u << tt.num_vars() ) - 1u )( gen );
+  return create_from_npn_config( std::make_tuple( tt, phase, perm ) );
+}
+
+/* Canonizes several random members of the same NPN class and reports how
+   often the class is split into more than one representative.  The class
+   splitting rate is 0 if all members map to the same representative, and 1 if
+   all members map to different representatives. */
+template<typename Fn>
+void run_class_splitting( benchmark::State& state, Fn&& canonize )
+{
+  const auto num_vars = static_cast<uint32_t>( state.range( 0 ) );
+  const auto num_members = 8u;
+
+  std::default_random_engine gen( 42u );
+  dynamic_truth_table tt( num_vars );
+  double split_rate{ 0.0 };
+
+  while ( state.KeepRunning() )
+  {
+    state.PauseTiming();
+    create_random( tt, gen() );
+    std::vector<dynamic_truth_table> members;
+    for ( auto i = 0u; i < num_members; ++i )
+    {
+      members.push_back( random_npn_transform( tt, gen ) );
+    }
+    state.ResumeTiming();
+
+    std::set<dynamic_truth_table> reprs;
+    for ( const auto& member : members )
+    {
+      reprs.insert( std::get<0>( canonize( member ) ) );
+    }
+
+    split_rate += static_cast<double>( reprs.size() - 1u ) / ( num_members - 1u );
+  }
+
+  state.counters["split_rate"] = benchmark::Counter( split_rate, benchmark::Counter::kAvgIterations );
+}
+
+void BM_sifting_npn_class_splitting( benchmark::State& state )
+{
+  run_class_splitting( state, []( const auto& tt ) { return sifting_npn_canonization( tt ); } );
+}
+
+void BM_multi_start_sifting_npn_class_splitting( benchmark::State& state )
+{
+  multi_start_sifting_params ps;
+  ps.num_restarts = static_cast<uint32_t>( state.range( 1 ) );
+  ps.num_threads = static_cast<uint32_t>( state.range( 2 ) );
+
+  run_class_splitting( state, [&]( const auto& tt ) { return multi_start_sifting_npn_canonization( tt, ps ); } );
+}
+
+void BM_multi_start_sifting_npn_class_splitting_budget( benchmark::State& state )
+{
+  multi_start_sifting_params ps;
+  ps.num_restarts = 1000000u;
+  ps.num_threads = 0u;
+  ps.time_budget = std::chrono::microseconds( state.range( 1 ) );
+
+  run_class_splitting( state, [&]( const auto& tt ) { return multi_start_sifting_npn_canonization( tt, ps ); } );
+}
+
+void class_splitting_arguments( benchmark::internal::Benchmark* b )
+{
+  for ( auto num_vars = 6; num_vars <= 10; ++num_vars )
+  {
+    for ( auto restarts : { 4, 16, 64 } )
+    {
+      for ( auto threads : { 1, 4 } )
+      {
+        b->Args( { num_vars, restarts, threads } );
+      }
+    }
+  }
+}
+
+void class_splitting_budget_arguments( benchmark::internal::Benchmark* b )
+{
+  for ( auto num_vars = 6; num_vars <= 10; ++num_vars )
+  {
+    for ( auto budget : { 100, 1000, 10000 } )
+    {
+      b->Args( { num_vars, budget } );
+    }
+  }
+}
+
+BENCHMARK( BM_sifting_npn_class_splitting )->DenseRange( 6, 10 );
+BENCHMARK( BM_multi_start_sifting_npn_class_splitting )->Apply( class_splitting_arguments )->UseRealTime();
+BENCHMARK( BM_multi_start_sifting_npn_class_splitting_budget )->Apply( class_splitting_budget_arguments )->UseRealTime();
+
+BENCHMARK_MAIN()
@@ -123,6 +123,181 @@ void BM_unary_not_if_dynamic( benchmark::State& state )
   }
 }
 
+void BM_add_bits_partial_truth_tables( benchmark::State& state )
+{
+  const auto num_signals = static_cast<uint32_t>( state.range( 0 ) );
+  std::vector<uint64_t> words( num_signals, UINT64_C( 0x9e3779b97f4a7c15 ) );
+  while ( state.KeepRunning() )
+  {
+    std::vector<partial_truth_table> tts( num_signals );
+    for ( auto round = 0u; round < 64u; ++round )
+    {
+      for ( auto s = 0u; s < num_signals; ++s )
+      {
+        tts[s].add_bits( words[s] );
+      }
+    }
+    benchmark::DoNotOptimize( tts );
+  }
+}
+
+void BM_add_bits_pattern_store( benchmark::State& state )
+{
+  const auto num_signals = static_cast<uint32_t>( state.range( 0 ) );
+  std::vector<uint64_t> words( num_signals, UINT64_C( 0x9e3779b97f4a7c15 ) );
+  while ( state.KeepRunning() )
+  {
+    pattern_store store( num_signals );
+    for ( auto round = 0u; round < 64u; ++round )
+    {
+      store.add_bits( words.data() );
+    }
+    benchmark::DoNotOptimize( store );
+  }
+}
+
+void BM_refine_equivalence_classes( benchmark::State& state )
+{
+  const auto num_signals = static_cast<uint32_t>( state.range( 0 ) );
+  const auto num_threads = static_cast<uint32_t>( state.range( 1 ) );
+
+  /* classes are split a little in each round */
+  std::vector<std::vector<uint64_t>> rounds( 16u, std::vector<uint64_t>( num_signals ) );
+  for ( auto round = 0u; round < rounds.size(); ++round )
+  {
+    for ( auto s = 0u; s < num_signals; ++s )
+    {
+      rounds[round][s] = ( s % ( 4u << round ) ) * UINT64_C( 0x9e3779b97f4a7c15 );
+    }
+  }
+
+  while ( state.KeepRunning() )
+  {
+    pattern_store store( num_signals );
+    equivalence_classes ec( { true, num_threads } );
+    for ( const auto& words : rounds )
+    {
+      store.add_bits( words.data() );
+      ec.refine( store );
+    }
+    benchmark::DoNotOptimize( ec.num_classes() );
+  }
+}
+
+void BM_evaluate_get_bit( benchmark::State& state )
+{
+  const auto num_vars = static_cast<uint32_t>( state.range( 0 ) );
+  dynamic_truth_table tt( num_vars );
+  create_random( tt );
+  std::vector<uint64_t> inputs( num_vars, UINT64_C( 0x9e3779b97f4a7c15 ) );
+
+  while ( state.KeepRunning() )
+  {
+    ++inputs[0];
+    uint64_t result = 0u;
+    for ( auto p = 0u; p < 64u; ++p )
+    {
+      uint64_t index = 0u;
+      for ( auto j = 0u; j < num_vars; ++j )
+      {
+        index |= ( ( inputs[j] >> p ) & 1 ) << j;
+      }
+      result |= get_bit( tt, index ) << p;
+    }
+    benchmark::DoNotOptimize( result );
+  }
+}
+
+void BM_evaluate_batch( benchmark::State& state )
+{
+  const auto num_vars = static_cast<uint32_t>( state.range( 0 ) );
+  dynamic_truth_table tt( num_vars );
+  create_random( tt );
+  std::vector<uint64_t> inputs( num_vars, UINT64_C( 0x9e3779b97f4a7c15 ) );
+
+  while ( state.KeepRunning() )
+  {
+    ++inputs[0];
+    benchmark::DoNotOptimize( evaluate_batch( tt, inputs.data() ) );
+  }
+}
+
+void BM_minterm_major_get_bit( benchmark::State& state )
+{
+  std::vector<dynamic_truth_table> tts( 64u, dynamic_truth_table( state.range( 0 ) ) );
+  for ( auto& tt : tts )
+  {
+    create_random( tt );
+  }
+  std::vector<uint64_t> words( tts.front().num_bits() );
+
+  while ( state.KeepRunning() )
+  {
+    for ( auto m = 0u; m < words.size(); ++m )
+    {
+      uint64_t w = 0u;
+      for ( auto k = 0u; k < 64u; ++k )
+      {
+        w |= get_bit( tts[k], m ) << k;
+      }
+      words[m] = w;
+    }
+    benchmark::DoNotOptimize( words );
+  }
+}
+
+void BM_minterm_major_transpose( benchmark::State& state )
+{
+  std::vector<dynamic_truth_table> tts( 64u, dynamic_truth_table( state.range( 0 ) ) );
+  for ( auto& tt : tts )
+  {
+    create_random( tt );
+  }
+  std::vector<uint64_t> words( tts.front().num_bits() );
+
+  while ( state.KeepRunning() )
+  {
+    to_minterm_major( tts, words.data() );
+    benchmark::DoNotOptimize( words );
+  }
+}
+
+void BM_swap_vector_of_truth_tables( benchmark::State& state )
+{
+  std::vector<dynamic_truth_table> tts( 256u, dynamic_truth_table( state.range( 0 ) ) );
+  for ( auto& tt : tts )
+  {
+    create_random( tt );
+  }
+
+  while ( state.KeepRunning() )
+  {
+    for ( auto& tt : tts )
+    {
+      swap_inplace( tt, 1u, 7u );
+      flip_inplace( tt, 3u );
+    }
+    benchmark::DoNotOptimize( tts );
+  }
+}
+
+void BM_swap_multi_output_truth_table( benchmark::State& state )
+{
+  std::vector<dynamic_truth_table> tts( 256u, dynamic_truth_table( state.range( 0 ) ) );
+  for ( auto& tt : tts )
+  {
+    create_random( tt );
+  }
+  multi_output_truth_table mo( tts );
+
+  while ( state.KeepRunning() )
+  {
+    swap_inplace( mo, 1u, 7u );
+    flip_inplace( mo, 3u );
+    benchmark::DoNotOptimize( mo );
+  }
+}
+
 BENCHMARK_TEMPLATE( BM_bitwise_and_lambda_static, 5 );
 BENCHMARK_TEMPLATE( BM_bitwise_and_lambda_static, 7 );
 BENCHMARK_TEMPLATE( BM_bitwise_and_lambda_static, 9 );
@@ -144,4 +319,15 @@ BENCHMARK( BM_bitwise_majority_func_dynamic )->Arg( 5 )->Arg( 7 )->Arg( 9 );
 BENCHMARK( BM_unary_not_ite_dynamic )->Arg( 5 )->Arg( 7 )->Arg( 9 );
 BENCHMARK( BM_unary_not_if_dynamic )->Arg( 5 )->Arg( 7 )->Arg( 9 );
 
+BENCHMARK( BM_add_bits_partial_truth_tables )->Arg( 1000 )->Arg( 10000 );
+BENCHMARK( BM_add_bits_pattern_store )->Arg( 1000 )->Arg( 10000 );
+BENCHMARK( BM_refine_equivalence_classes )->Args( { 100000, 1 } )->Args( { 100000, 4 } );
+
+BENCHMARK( BM_evaluate_get_bit )->Arg( 2 )->Arg( 6 )->Arg( 10 )->Arg( 16 );
+BENCHMARK( BM_evaluate_batch )->Arg( 2 )->Arg( 6 )->Arg( 10 )->Arg( 16 );
+BENCHMARK( BM_minterm_major_get_bit )->Arg( 8 )->Arg( 16 );
+BENCHMARK( BM_minterm_major_transpose )->Arg( 8 )->Arg( 16 );
+BENCHMARK( BM_swap_vector_of_truth_tables )->Arg( 8 )->Arg( 12 );
+BENCHMARK( BM_swap_multi_output_truth_table )->Arg( 8 )->Arg( 12 );
+
 BENCHMARK_MAIN()
@@ -0,0 +1,83 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <kitty/kitty.hpp>
+
+using namespace kitty;
+
+/* num_tts truth tables, of which every fourth is distinct */
+static std::vector<dynamic_truth_table> random_duplicates( uint32_t num_vars, uint32_t num_tts )
+{
+  std::vector<dynamic_truth_table> distinct( num_tts / 4u, dynamic_truth_table( num_vars ) );
+  for ( auto& tt : distinct )
+  {
+    create_random( tt );
+  }
+  std::vector<dynamic_truth_table> tts;
+  for ( auto i = 0u; i < num_tts; ++i )
+  {
+    tts.push_back( distinct[( i * 7919u ) % distinct.size()] );
+  }
+  return tts;
+}
+
+void BM_unordered_set_insert( benchmark::State& state )
+{
+  const auto tts = random_duplicates( state.range( 1 ), state.range( 0 ) );
+
+  while ( state.KeepRunning() )
+  {
+    std::unordered_set<dynamic_truth_table, hash<dynamic_truth_table>> set;
+    for ( const auto& tt : tts )
+    {
+      set.insert( tt );
+    }
+    benchmark::DoNotOptimize( set );
+  }
+}
+
+void BM_truth_table_store_insert( benchmark::State& state )
+{
+  const auto tts = random_duplicates( state.range( 1 ), state.range( 0 ) );
+
+  while ( state.KeepRunning() )
+  {
+    truth_table_store<dynamic_truth_table> store;
+    for ( const auto& tt : tts )
+    {
+      benchmark::DoNotOptimize( store.insert( tt ) );
+    }
+  }
+}
+
+BENCHMARK( BM_unordered_set_insert )->Args( { 100000, 6 } )->Args( { 100000, 10 } );
+BENCHMARK( BM_truth_table_store_insert )->Args( { 100000, 6 } )->Args( { 100000, 10 } );
+
+BENCHMARK_MAIN()
@@ -0,0 +1,63 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <kitty/kitty.hpp>
+
+/* compile time constant for the number of variables */
+auto constexpr num_vars = 5;
+
+/* number of functions that are scanned between two checkpoints */
+auto constexpr step = uint64_t( 1 ) << 26;
+
+int main( int argc, char** argv )
+{
+  /* checkpoint file to resume from and to write progress to */
+  const std::string checkpoint = argc > 1 ? argv[1] : "npn_enumeration_bitmap.chk";
+
+  kitty::npn_bitmap_enumerator<num_vars> enumerator( std::thread::hardware_concurrency() );
+
+  if ( enumerator.load( checkpoint ) )
+  {
+    std::cout << "[i] resumed from " << checkpoint << " at function " << enumerator.cursor() << std::endl;
+  }
+
+  while ( !enumerator.run( []( const auto&, uint64_t ) {}, step ) )
+  {
+    enumerator.save( checkpoint );
+    std::cout << "[i] scanned " << enumerator.cursor() << " functions, found "
+              << enumerator.num_classes() << " classes so far" << std::endl;
+  }
+
+  std::cout << "[i] enumerated "
+            << enumerator.cursor() << " functions into "
+            << enumerator.num_classes() << " classes." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,246 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file canonization_cache.hpp
+  \brief Implements a thread-safe cache for canonization results
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/striped_cache.hpp"
+#include "dynamic_truth_table.hpp"
+#include "hash.hpp"
+#include "npn.hpp"
+#include "spectral.hpp"
+#include "traits.hpp"
+
+namespace kitty
+{
+
+/*! \brief Parameters for canonization_cache */
+struct canonization_cache_params
+{
+  /*! Memory budget in bytes for all stored entries (0 disables caching). */
+  uint64_t memory_budget{ UINT64_C( 64 ) << 20 };
+
+  /*! Number of independently locked stripes (rounded up to a power of 2). */
+  uint32_t num_stripes{ 64u };
+
+  /*! Number of slots that are probed for each key (rounded up to a power of 2). */
+  uint32_t associativity{ 4u };
+};
+
+/*! \brief Statistics for canonization_cache
+
+  Contains the number of hits and misses, the number of evicted and stored
+  entries, and the estimated memory usage in bytes.
+*/
+using canonization_cache_statistics = detail::cache_statistics;
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+template<typename TT>
+struct exact_npn_canonization_fn
+{
+  std::tuple<TT, uint32_t, std::vector<uint8_t>> operator()( const TT& tt ) const
+  {
+    return exact_npn_canonization( tt );
+  }
+};
+
+template<typename TT>
+struct exact_spectral_canonization_fn
+{
+  std::pair<TT, std::vector<spectral_operation>> operator()( const TT& tt ) const
+  {
+    std::vector<spectral_operation> transforms;
+    const auto repr = exact_spectral_canonization( tt, [&]( const auto& ops ) { transforms = ops; } );
+    return { repr, transforms };
+  }
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Thread-safe bounded cache for canonization results
+
+  The cache wraps a canonization functor `Fn`, which is called with a truth
+  table and returns its canonization result, e.g., the NPN configuration
+  returned by `exact_npn_canonization`.  Results are stored together with the
+  truth table such that repeated canonizations of the same function are
+  answered without calling the functor again.
+
+  The cache is split into stripes, each protected by its own mutex.  A stripe
+  is an open addressing table, in which each key can be stored in a bucket of
+  a few consecutive slots.  If all slots in a bucket are occupied, an entry is
+  evicted using the clock replacement strategy.  The number of slots is derived
+  from the memory budget and the size of the first entry stored in a stripe;
+  entries are also evicted when their memory exceeds the budget.
+  The canonization functor is called outside of the locks, such that different
+  threads can canonize in parallel.
+
+  Example:
+
+  \verbatim embed:rst
+  .. code-block:: c++
+
+     kitty::exact_npn_canonization_cache<kitty::static_truth_table<6>> cache;
+     const auto config = cache( tt ); // same as exact_npn_canonization( tt )
+     std::cout << cache.statistics().hit_rate() << std::endl;
+  \endverbatim
+*/
+template<typename TT, typename Fn>
+class canonization_cache
+{
+public:
+  using result_type = std::decay_t<std::invoke_result_t<const Fn&, const TT&>>;
+
+public:
+  /*! \brief Constructor
+
+    \param fn Canonization functor
+    \param ps Parameters
+  */
+  explicit canonization_cache( Fn fn = Fn(), const canonization_cache_params& ps = {} )
+      : _fn( std::move( fn ) ),
+        _cache( ps.memory_budget, ps.num_stripes, ps.associativity )
+  {
+  }
+
+  /*! \brief Constructor with default functor
+
+    \param ps Parameters
+  */
+  explicit canonization_cache( const canonization_cache_params& ps )
+      : canonization_cache( Fn(), ps )
+  {
+  }
+
+  /*! \brief Returns the canonization result for a truth table
+
+    Looks up the truth table in the cache and calls the canonization functor
+    in case of a miss.  This function can be called concurrently.
+
+    \param tt Truth table
+  */
+  result_type operator()( const TT& tt )
+  {
+    const auto h = detail::mix_hash( hash<TT>()( tt ) );
+    const auto match = [&]( const TT& key ) { return key == tt; };
+
+    std::optional<result_type> cached;
+    if ( _cache.find( h, match, [&]( const result_type& v ) { cached.emplace( v ); } ) )
+    {
+      return *cached;
+    }
+
+    auto value = _fn( tt );
+    _cache.insert( h, match, tt, value );
+    return value;
+  }
+
+  /*! \brief Removes all entries
+
+    Statistics are not reset.
+  */
+  void clear()
+  {
+    _cache.clear();
+  }
+
+  /*! \brief Changes the memory budget
+
+    All entries are removed and the slots are reallocated according to the
+    new budget.  This allows to release memory under memory pressure.  No
+    entries are stored if the budget is too small for a single bucket of
+    each stripe, in particular, a budget of 0 disables caching.  This
+    function can be called concurrently with lookups.
+
+    \param memory_budget New memory budget in bytes
+  */
+  void set_memory_budget( uint64_t memory_budget )
+  {
+    _cache.set_memory_budget( memory_budget );
+  }
+
+  /*! \brief Returns the current memory budget in bytes */
+  uint64_t memory_budget() const
+  {
+    return _cache.memory_budget();
+  }
+
+  /*! \brief Returns accumulated statistics over all stripes */
+  canonization_cache_statistics statistics() const
+  {
+    return _cache.statistics();
+  }
+
+  /*! \brief Resets hit, miss, and eviction counters */
+  void reset_statistics()
+  {
+    _cache.reset_statistics();
+  }
+
+private:
+  Fn _fn;
+  detail::striped_cache<TT, result_type> _cache;
+};
+
+/*! \brief Canonization cache for `exact_npn_canonization` */
+template<typename TT>
+using exact_npn_canonization_cache = canonization_cache<TT, detail::exact_npn_canonization_fn<TT>>;
+
+/*! \brief Canonization cache for `exact_spectral_canonization`
+
+  The cached result is a pair of the spectral representative and the list of
+  spectral operations that lead to it.
+*/
+template<typename TT>
+using exact_spectral_canonization_cache = canonization_cache<TT, detail::exact_spectral_canonization_fn<TT>>;
+
+/*! \brief Creates a canonization cache for an arbitrary canonization functor
+
+  \param fn Canonization functor, called with a truth table of type `TT`
+  \param ps Parameters
+*/
+template<typename TT, typename Fn>
+canonization_cache<TT, std::decay_t<Fn>> make_canonization_cache( Fn&& fn, const canonization_cache_params& ps = {} )
+{
+  return canonization_cache<TT, std::decay_t<Fn>>( std::forward<Fn>( fn ), ps );
+}
+
+} /* namespace kitty */
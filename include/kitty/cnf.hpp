@@ -32,12 +32,25 @@
 
 #pragma once
 
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cube.hpp"
+#include "decomposition.hpp"
+#include "dynamic_truth_table.hpp"
+#include "hash.hpp"
 #include "isop.hpp"
+#include "operations.hpp"
 #include "operators.hpp"
 #include "traits.hpp"
+#include "wide_cube.hpp"
+#include "detail/constants.hpp"
+#include "detail/mscfix.hpp"
 
 namespace kitty
 {
@@ -48,17 +61,20 @@ namespace kitty
   function, also known as Tseytin transformation.  To obtain small CNF,
   an ISOP is computed.
 
+  The clause type can be changed to `wide_cube` or `dynamic_cube` for
+  functions with 32 or more variables.
+
   \param tt Truth table
 */
-template<typename TT, typename = std::enable_if_t<is_complete_truth_table<TT>::value>>
-std::vector<cube> cnf_characteristic( const TT& tt )
+template<typename TT, typename Cube = cube, typename = std::enable_if_t<is_complete_truth_table<TT>::value>>
+std::vector<Cube> cnf_characteristic( const TT& tt )
 {
-  std::vector<cube> cubes;
+  std::vector<Cube> cubes;
   detail::isop_rec( tt, tt, tt.num_vars(), cubes );
 
   for ( auto& cube : cubes )
   {
-    cube._bits = ~cube._bits & cube._mask;
+    detail::negate_literals( cube );
     cube.add_literal( tt.num_vars(), true );
   }
 
@@ -69,11 +85,728 @@ std::vector<cube> cnf_characteristic( const TT& tt )
   for ( auto i = end; i < cubes.size(); ++i )
   {
     auto& cube = cubes[i];
-    cube._bits = ~cube._bits & cube._mask;
+    detail::negate_literals( cube );
     cube.add_literal( tt.num_vars(), false );
   }
 
   return cubes;
 }
 
-} // namespace kitty
\ No newline at end of file
+/*! \brief Clause sink that stores clauses in a flat array
+
+  Clauses are stored consecutively in a single array of literals together
+  with an array of clause end offsets, which avoids one allocation per
+  clause.  Literals follow the DIMACS convention: variables are numbered from
+  1, and negative literals are complemented variables.
+
+  Clause sinks provide `add_variable()`, which returns a fresh variable, and
+  `add_clause(begin, end)`, which adds a clause from a range of literals.
+  They are used by the CNF encoders `cnf_dsd_encoding` and
+  `cnf_mux_encoding`.
+*/
+class clause_arena
+{
+public:
+  /*! \brief Returns a fresh variable */
+  int add_variable()
+  {
+    return static_cast<int>( ++_num_vars );
+  }
+
+  /*! \brief Adds a clause
+
+    \param begin Begin iterator to literals
+    \param end End iterator to literals
+  */
+  template<typename Iterator>
+  void add_clause( Iterator begin, Iterator end )
+  {
+    _literals.insert( _literals.end(), begin, end );
+    _offsets.push_back( _literals.size() );
+  }
+
+  /*! \brief Adds a clause
+
+    \param clause Literals
+  */
+  void add_clause( std::initializer_list<int> clause )
+  {
+    add_clause( clause.begin(), clause.end() );
+  }
+
+  /*! \brief Returns the number of variables */
+  uint32_t num_vars() const
+  {
+    return _num_vars;
+  }
+
+  /*! \brief Returns the number of clauses */
+  uint64_t num_clauses() const
+  {
+    return _offsets.size();
+  }
+
+  /*! \brief Returns the number of literals in all clauses */
+  uint64_t num_literals() const
+  {
+    return _literals.size();
+  }
+
+  /*! \brief Iterates over all clauses
+
+    \param fn Callback with signature `void(const int* begin, const int* end)`
+  */
+  template<typename Fn>
+  void foreach_clause( Fn&& fn ) const
+  {
+    uint64_t begin = 0u;
+    for ( auto end : _offsets )
+    {
+      fn( _literals.data() + begin, _literals.data() + end );
+      begin = end;
+    }
+  }
+
+  /*! \brief Writes clauses in DIMACS format
+
+    \param os Output stream
+  */
+  void write_dimacs( std::ostream& os ) const
+  {
+    os << "p cnf " << _num_vars << ' ' << _offsets.size() << '\n';
+    foreach_clause( [&]( auto begin, auto end ) {
+      for ( auto it = begin; it != end; ++it )
+      {
+        os << *it << ' ';
+      }
+      os << "0\n";
+    } );
+  }
+
+  /*! \brief Removes all variables and clauses */
+  void clear()
+  {
+    _num_vars = 0u;
+    _literals.clear();
+    _offsets.clear();
+  }
+
+private:
+  uint32_t _num_vars{ 0u };
+  std::vector<int> _literals;
+  std::vector<uint64_t> _offsets;
+};
+
+/*! \brief Clause sink that writes DIMACS to a stream
+
+  Clauses are formatted into an internal buffer that is flushed to the stream
+  when it gets full, so that CNFs can be written to a file or a solver
+  without keeping them in memory.  Since the header of a DIMACS file
+  contains the number of variables and clauses, the writer reserves a
+  fixed-width header, which is overwritten by `finish()` (also called by the
+  destructor).  This requires a seekable stream, such as a file or string
+  stream.  For other streams, use the constructor that writes the header
+  immediately.
+*/
+class dimacs_writer
+{
+public:
+  /*! \brief Constructs a writer with a header that is completed in `finish()`
+
+    \param os Seekable output stream
+  */
+  explicit dimacs_writer( std::ostream& os ) : _os( os ), _header( os.tellp() )
+  {
+    _os << std::string( header_width, ' ' ) << '\n';
+  }
+
+  /*! \brief Constructs a writer for known numbers of variables and clauses
+
+    \param os Output stream
+    \param num_vars Number of variables
+    \param num_clauses Number of clauses
+  */
+  dimacs_writer( std::ostream& os, uint32_t num_vars, uint64_t num_clauses ) : _os( os )
+  {
+    _os << "p cnf " << num_vars << ' ' << num_clauses << '\n';
+  }
+
+  ~dimacs_writer()
+  {
+    finish();
+  }
+
+  dimacs_writer( const dimacs_writer& ) = delete;
+  dimacs_writer& operator=( const dimacs_writer& ) = delete;
+
+  /*! \brief Returns a fresh variable */
+  int add_variable()
+  {
+    return static_cast<int>( ++_num_vars );
+  }
+
+  /*! \brief Declares that variables up to `num_vars` are used
+
+    \param num_vars Number of variables
+  */
+  void reserve_variables( uint32_t num_vars )
+  {
+    _num_vars = std::max( _num_vars, num_vars );
+  }
+
+  /*! \brief Adds a clause
+
+    \param begin Begin iterator to literals
+    \param end End iterator to literals
+  */
+  template<typename Iterator>
+  void add_clause( Iterator begin, Iterator end )
+  {
+    for ( auto it = begin; it != end; ++it )
+    {
+      append( *it );
+    }
+    _buffer += "0\n";
+    ++_num_clauses;
+
+    if ( _buffer.size() >= buffer_size )
+    {
+      flush();
+    }
+  }
+
+  /*! \brief Adds a clause
+
+    \param clause Literals
+  */
+  void add_clause( std::initializer_list<int> clause )
+  {
+    add_clause( clause.begin(), clause.end() );
+  }
+
+  /*! \brief Returns the number of variables */
+  uint32_t num_vars() const
+  {
+    return _num_vars;
+  }
+
+  /*! \brief Returns the number of clauses */
+  uint64_t num_clauses() const
+  {
+    return _num_clauses;
+  }
+
+  /*! \brief Flushes all clauses and writes the header */
+  void finish()
+  {
+    flush();
+    if ( _header == std::streampos( -1 ) )
+    {
+      return;
+    }
+
+    const auto end = _os.tellp();
+    auto header = "p cnf " + std::to_string( _num_vars ) + ' ' + std::to_string( _num_clauses );
+    header.resize( header_width, ' ' );
+    _os.seekp( _header );
+    _os << header;
+    _os.seekp( end );
+    _os.flush();
+    _header = std::streampos( -1 );
+  }
+
+private:
+  void append( int lit )
+  {
+    char digits[12];
+    auto p = digits + sizeof( digits );
+    auto value = static_cast<uint32_t>( lit < 0 ? -lit : lit );
+    *--p = ' ';
+    do
+    {
+      *--p = static_cast<char>( '0' + value % 10u );
+      value /= 10u;
+    } while ( value );
+    if ( lit < 0 )
+    {
+      *--p = '-';
+    }
+    _buffer.append( p, digits + sizeof( digits ) );
+  }
+
+  void flush()
+  {
+    _os.write( _buffer.data(), _buffer.size() );
+    _buffer.clear();
+  }
+
+private:
+  static constexpr uint64_t header_width = 40u;
+  static constexpr uint64_t buffer_size = 1u << 16u;
+
+  std::ostream& _os;
+  std::streampos _header{ -1 };
+  std::string _buffer;
+  uint32_t _num_vars{ 0u };
+  uint64_t _num_clauses{ 0u };
+};
+
+/*! \brief Parameters for CNF encoders */
+struct cnf_encoding_params
+{
+  /*! Functions with at most this many variables (at most 6) are encoded by
+      the clauses from the ISOPs of the function and its complement. */
+  uint32_t leaf_vars{ 6u };
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* literals for constants, negation by unary minus */
+static constexpr int cnf_true = std::numeric_limits<int>::max();
+static constexpr int cnf_false = -cnf_true;
+
+/* gates with constant propagation */
+template<typename Sink>
+class cnf_gates
+{
+public:
+  cnf_gates( Sink& sink, const cnf_encoding_params& ps )
+      : _sink( sink ),
+        _leaf_vars( std::min( ps.leaf_vars, 6u ) )
+  {
+  }
+
+  int land( int a, int b )
+  {
+    if ( a == cnf_false || b == cnf_false || a == -b )
+    {
+      return cnf_false;
+    }
+    if ( a == cnf_true || a == b )
+    {
+      return b;
+    }
+    if ( b == cnf_true )
+    {
+      return a;
+    }
+
+    const auto o = _sink.add_variable();
+    clause( { -o, a } );
+    clause( { -o, b } );
+    clause( { o, -a, -b } );
+    return o;
+  }
+
+  int lor( int a, int b )
+  {
+    return -land( -a, -b );
+  }
+
+  int lxor( int a, int b )
+  {
+    if ( a == cnf_false || a == cnf_true )
+    {
+      return a == cnf_true ? -b : b;
+    }
+    if ( b == cnf_false || b == cnf_true )
+    {
+      return b == cnf_true ? -a : a;
+    }
+    if ( a == b )
+    {
+      return cnf_false;
+    }
+    if ( a == -b )
+    {
+      return cnf_true;
+    }
+
+    const auto o = _sink.add_variable();
+    clause( { -o, a, b } );
+    clause( { -o, -a, -b } );
+    clause( { o, -a, b } );
+    clause( { o, a, -b } );
+    return o;
+  }
+
+  /* s ? t : e */
+  int mux( int s, int t, int e )
+  {
+    if ( s == cnf_true || s == cnf_false || t == e )
+    {
+      return s == cnf_false ? e : t;
+    }
+    if ( t == -e )
+    {
+      return lxor( s, e );
+    }
+    if ( t == cnf_true || t == cnf_false )
+    {
+      return t == cnf_true ? lor( s, e ) : land( -s, e );
+    }
+    if ( e == cnf_true || e == cnf_false )
+    {
+      return e == cnf_true ? lor( -s, t ) : land( s, t );
+    }
+
+    const auto o = _sink.add_variable();
+    clause( { -s, -t, o } );
+    clause( { -s, t, -o } );
+    clause( { s, -e, o } );
+    clause( { s, e, -o } );
+    /* redundant clauses that improve propagation */
+    clause( { -t, -e, o } );
+    clause( { t, e, -o } );
+    return o;
+  }
+
+  /* encodes a function over at most 6 variables by the ISOPs of its onset and offset */
+  int leaf( uint64_t word, uint32_t num_vars, const int* lits )
+  {
+    word &= masks[num_vars];
+    if ( word == 0u )
+    {
+      return cnf_false;
+    }
+    if ( word == masks[num_vars] )
+    {
+      return cnf_true;
+    }
+
+    _cubes.clear();
+    isop_rec_word( isop_replicate( word, num_vars ), isop_replicate( word, num_vars ), num_vars, _cubes );
+    if ( _cubes.size() == 1u && _cubes[0].num_literals() == 1 )
+    {
+      const auto var = __builtin_ctz( _cubes[0]._mask );
+      return _cubes[0].get_bit( var ) ? lits[var] : -lits[var];
+    }
+    const auto end = _cubes.size();
+    const auto off = masks[num_vars] & ~word;
+    isop_rec_word( isop_replicate( off, num_vars ), isop_replicate( off, num_vars ), num_vars, _cubes );
+
+    const auto o = _sink.add_variable();
+    for ( auto i = 0u; i < _cubes.size(); ++i )
+    {
+      _clause.clear();
+      for ( auto v = 0u; v < num_vars; ++v )
+      {
+        if ( _cubes[i].get_mask( v ) )
+        {
+          _clause.push_back( _cubes[i].get_bit( v ) ? -lits[v] : lits[v] );
+        }
+      }
+      _clause.push_back( i < end ? o : -o );
+      _sink.add_clause( _clause.begin(), _clause.end() );
+    }
+    return o;
+  }
+
+  /* returns a literal for the output, constants are assigned to a variable */
+  int output( int lit )
+  {
+    if ( lit != cnf_true && lit != cnf_false )
+    {
+      return lit;
+    }
+    const auto o = _sink.add_variable();
+    clause( { lit == cnf_true ? o : -o } );
+    return o;
+  }
+
+  uint32_t leaf_vars() const
+  {
+    return _leaf_vars;
+  }
+
+private:
+  void clause( std::initializer_list<int> lits )
+  {
+    _sink.add_clause( lits.begin(), lits.end() );
+  }
+
+private:
+  Sink& _sink;
+  uint32_t _leaf_vars;
+  std::vector<cube> _cubes;
+  std::vector<int> _clause;
+};
+
+template<typename Sink>
+class cnf_mux_encoder
+{
+public:
+  cnf_mux_encoder( const std::vector<int>& inputs, Sink& sink, const cnf_encoding_params& ps )
+      : _inputs( inputs ),
+        _gates( sink, ps ),
+        _word_cache( 7u ),
+        _words_cache( inputs.size() + 1u )
+  {
+  }
+
+  int run( const uint64_t* words, uint32_t num_vars )
+  {
+    _words = words;
+    const auto lit = num_vars <= 6u ? encode_word( words[0] & masks[num_vars], num_vars ) : encode_words( 0u, num_vars );
+    return _gates.output( lit );
+  }
+
+private:
+  int encode_word( uint64_t word, uint32_t num_vars )
+  {
+    if ( word == 0u )
+    {
+      return cnf_false;
+    }
+    if ( word == masks[num_vars] )
+    {
+      return cnf_true;
+    }
+
+    auto& cache = _word_cache[num_vars];
+    const auto it = cache.find( word );
+    if ( it != cache.end() )
+    {
+      return it->second;
+    }
+
+    int lit;
+    if ( num_vars <= _gates.leaf_vars() )
+    {
+      lit = _gates.leaf( word, num_vars, _inputs.data() );
+    }
+    else
+    {
+      const auto var = num_vars - 1u;
+      const auto lit0 = encode_word( word & masks[var], var );
+      const auto lit1 = encode_word( ( word >> ( 1u << var ) ) & masks[var], var );
+      lit = _gates.mux( _inputs[var], lit1, lit0 );
+    }
+    cache.emplace( word, lit );
+    return lit;
+  }
+
+  /* cofactors of variables with index 6 and larger are ranges of words */
+  int encode_words( uint64_t offset, uint32_t num_vars )
+  {
+    const auto num_words = uint64_t( 1 ) << ( num_vars - 6u );
+    const auto begin = _words + offset;
+    const auto end = begin + num_words;
+
+    if ( std::all_of( begin, end, []( auto w ) { return w == 0u; } ) )
+    {
+      return cnf_false;
+    }
+    if ( std::all_of( begin, end, []( auto w ) { return w == ~uint64_t( 0 ); } ) )
+    {
+      return cnf_true;
+    }
+
+    auto key = hash_block( *begin );
+    for ( auto it = begin + 1; it != end; ++it )
+    {
+      hash_combine( key, hash_block( *it ) );
+    }
+    auto& cache = _words_cache[num_vars];
+    const auto range = cache.equal_range( key );
+    for ( auto it = range.first; it != range.second; ++it )
+    {
+      if ( std::equal( begin, end, _words + it->second.first ) )
+      {
+        return it->second.second;
+      }
+    }
+
+    const auto var = num_vars - 1u;
+    int lit0, lit1;
+    if ( var == 6u )
+    {
+      lit0 = encode_word( begin[0], 6u );
+      lit1 = encode_word( begin[1], 6u );
+    }
+    else
+    {
+      lit0 = encode_words( offset, var );
+      lit1 = encode_words( offset + ( num_words >> 1u ), var );
+    }
+    const auto lit = _gates.mux( _inputs[var], lit1, lit0 );
+    cache.emplace( key, std::make_pair( offset, lit ) );
+    return lit;
+  }
+
+private:
+  const std::vector<int>& _inputs;
+  cnf_gates<Sink> _gates;
+  const uint64_t* _words{ nullptr };
+  std::vector<std::unordered_map<uint64_t, int>> _word_cache;
+  std::vector<std::unordered_multimap<std::size_t, std::pair<uint64_t, int>>> _words_cache;
+};
+
+template<typename Sink>
+class cnf_dsd_encoder
+{
+public:
+  cnf_dsd_encoder( Sink& sink, const cnf_encoding_params& ps )
+      : _gates( sink, ps )
+  {
+  }
+
+  int run( const dynamic_truth_table& tt, const std::vector<int>& inputs )
+  {
+    return _gates.output( encode( tt, inputs ) );
+  }
+
+private:
+  int encode( dynamic_truth_table tt, std::vector<int> lits )
+  {
+    /* restrict to functional support */
+    const auto support = min_base_inplace( tt );
+    if ( support.size() < tt.num_vars() )
+    {
+      tt = shrink_to( tt, static_cast<unsigned>( support.size() ) );
+      for ( auto i = 0u; i < support.size(); ++i )
+      {
+        lits[i] = lits[support[i]];
+      }
+      lits.resize( support.size() );
+    }
+
+    const auto num_vars = tt.num_vars();
+    if ( num_vars <= _gates.leaf_vars() )
+    {
+      return _gates.leaf( *tt.cbegin(), num_vars, lits.data() );
+    }
+
+    /* f = g(a, h) */
+    dynamic_truth_table h( num_vars );
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      const auto a = lits[i];
+      switch ( is_top_decomposable( tt, i, &h ) )
+      {
+      default:
+        continue;
+      case top_decomposition::and_:
+        return _gates.land( a, encode( h, lits ) );
+      case top_decomposition::or_:
+        return _gates.lor( a, encode( h, lits ) );
+      case top_decomposition::lt_:
+        return _gates.land( -a, encode( h, lits ) );
+      case top_decomposition::le_:
+        return _gates.lor( -a, encode( h, lits ) );
+      case top_decomposition::xor_:
+        return _gates.lxor( a, encode( h, lits ) );
+      }
+    }
+
+    /* f = h(g(a, b), ...), where g replaces a */
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      for ( auto j = i + 1u; j < num_vars; ++j )
+      {
+        const auto a = lits[i], b = lits[j];
+        auto g = cnf_false;
+        switch ( is_bottom_decomposable( tt, i, j, &h ) )
+        {
+        default:
+          continue;
+        case bottom_decomposition::and_:
+          g = _gates.land( a, b );
+          break;
+        case bottom_decomposition::or_:
+          g = _gates.lor( a, b );
+          break;
+        case bottom_decomposition::lt_:
+          g = _gates.land( -a, b );
+          break;
+        case bottom_decomposition::le_:
+          g = _gates.lor( -a, b );
+          break;
+        case bottom_decomposition::xor_:
+          g = _gates.lxor( a, b );
+          break;
+        }
+        auto lits_h = lits;
+        lits_h[i] = g;
+        return encode( h, lits_h );
+      }
+    }
+
+    /* prime block */
+    if ( num_vars <= 6u )
+    {
+      return _gates.leaf( *tt.cbegin(), num_vars, lits.data() );
+    }
+    const auto var = num_vars - 1u;
+    const auto lit0 = encode( cofactor0( tt, var ), lits );
+    const auto lit1 = encode( cofactor1( tt, var ), lits );
+    return _gates.mux( lits[var], lit1, lit0 );
+  }
+
+private:
+  cnf_gates<Sink> _gates;
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Tseitin encoding based on disjoint-support decomposition
+
+  Adds clauses to `sink` that define a literal that is equivalent to the
+  function applied to the input literals and returns this literal.  The
+  encoder recursively applies top decompositions \f$f = a \circ h\f$ and
+  bottom decompositions \f$f = h(a \circ b, \dots)\f$, where \f$\circ\f$ is
+  AND, OR, or XOR with possibly complemented inputs, and encodes each
+  operator by the Tseitin clauses of a single gate.  Functions with at most
+  `ps.leaf_vars` variables and prime blocks with at most 6 variables are
+  encoded by the ISOPs of their onset and offset, larger prime blocks are
+  split by Shannon expansion.  Constants and trivial gates are propagated
+  and do not create variables.
+
+  Compared to `cnf_characteristic`, the ISOPs of large functions are avoided
+  and the clause sink can stream the result.
+
+  \param tt Truth table
+  \param inputs Literals for the variables of the truth table (DIMACS convention)
+  \param sink Clause sink, e.g., `clause_arena` or `dimacs_writer`
+  \param ps Parameters
+*/
+template<typename TT, typename Sink>
+int cnf_dsd_encoding( const TT& tt, const std::vector<int>& inputs, Sink& sink, const cnf_encoding_params& ps = {} )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+  assert( inputs.size() == tt.num_vars() );
+
+  dynamic_truth_table copy( tt.num_vars() );
+  std::copy( tt.cbegin(), tt.cend(), copy.begin() );
+  return detail::cnf_dsd_encoder<Sink>( sink, ps ).run( copy, inputs );
+}
+
+/*! \brief Tseitin encoding of a multiplexer tree
+
+  Adds clauses to `sink` that define a literal that is equivalent to the
+  function applied to the input literals and returns this literal.  The
+  function is encoded by a tree of multiplexers from Shannon expansion on
+  the variable with the largest index, in which equal cofactors are shared
+  by hashing (as in a reduced BDD with this variable order) and cofactors
+  with at most `ps.leaf_vars` variables are encoded by the ISOPs of their
+  onset and offset.  Cofactors are ranges of words of the truth table and
+  are not copied, which makes the encoder suitable for large truth tables.
+
+  \param tt Truth table
+  \param inputs Literals for the variables of the truth table (DIMACS convention)
+  \param sink Clause sink, e.g., `clause_arena` or `dimacs_writer`
+  \param ps Parameters
+*/
+template<typename TT, typename Sink>
+int cnf_mux_encoding( const TT& tt, const std::vector<int>& inputs, Sink& sink, const cnf_encoding_params& ps = {} )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+  assert( inputs.size() == tt.num_vars() );
+
+  return detail::cnf_mux_encoder<Sink>( inputs, sink, ps ).run( &*tt.cbegin(), tt.num_vars() );
+}
+
+} // namespace kitty
@@ -436,6 +436,47 @@ void create_from_cubes( TT& tt, const std::vector<cube>& cubes, bool esop = fals
   }
 }
 
+/*! \brief Creates truth table from cubes representation
+
+  Like the other ``create_from_cubes`` function, but for cubes of an arbitrary
+  cube type such as `wide_cube` or `dynamic_cube`, which can represent more
+  than 32 variables.
+
+  \param tt Truth table
+  \param cubes Vector of cubes
+  \param esop Use ESOP instead of SOP
+*/
+template<typename TT, typename Cube, typename = std::enable_if_t<is_complete_truth_table<TT>::value>>
+void create_from_cubes( TT& tt, const std::vector<Cube>& cubes, bool esop = false )
+{
+  /* we collect product terms for an (E)SOP, start with const0 */
+  clear( tt );
+
+  for ( const auto& cube : cubes )
+  {
+    auto product = ~tt.construct(); /* const1 of same size */
+
+    for ( auto i = 0u; i < tt.num_vars(); ++i )
+    {
+      if ( cube.get_mask( i ) )
+      {
+        auto var = tt.construct();
+        create_nth_var( var, i, !cube.get_bit( i ) );
+        product &= var;
+      }
+    }
+
+    if ( esop )
+    {
+      tt ^= product;
+    }
+    else
+    {
+      tt |= product;
+    }
+  }
+}
+
 /*! \brief Creates truth table from clause representation
 
   A product-of-sum is represented as a vector of sums (called clauses).
@@ -489,6 +530,49 @@ void create_from_clauses( TT& tt, const std::vector<cube>& clauses, bool esop =
   }
 }
 
+/*! \brief Creates truth table from clause representation
+
+  Like the other ``create_from_clauses`` function, but for clauses of an
+  arbitrary cube type such as `wide_cube` or `dynamic_cube`, which can
+  represent more than 32 variables.
+
+  \param tt Truth table
+  \param clauses Vector of clauses
+  \param esop Use product of exclusive sums instead of POS
+*/
+template<typename TT, typename Cube, typename = std::enable_if_t<is_complete_truth_table<TT>::value>>
+void create_from_clauses( TT& tt, const std::vector<Cube>& clauses, bool esop = false )
+{
+  /* we collect product terms for an (E)SOP, start with const0 */
+  clear( tt );
+  tt = ~tt;
+
+  for ( const auto& clause : clauses )
+  {
+    auto sum = tt.construct(); /* const1 of same size */
+
+    for ( auto i = 0u; i < tt.num_vars(); ++i )
+    {
+      if ( clause.get_mask( i ) )
+      {
+        auto var = tt.construct();
+        create_nth_var( var, i, !clause.get_bit( i ) );
+
+        if ( esop )
+        {
+          sum ^= var;
+        }
+        else
+        {
+          sum |= var;
+        }
+      }
+    }
+
+    tt &= sum;
+  }
+}
+
 /*! \brief Constructs majority-n function
 
   The number of variables is determined from the truth table.
@@ -36,4 +36,32 @@
 #ifdef _MSC_VER
 #include <intrin.h>
 #define __builtin_popcount __popcnt
+
+inline int __builtin_ctzll( unsigned long long x )
+{
+  unsigned long index;
+  _BitScanForward64( &index, x );
+  return static_cast<int>( index );
+}
+
+inline int __builtin_clzll( unsigned long long x )
+{
+  unsigned long index;
+  _BitScanReverse64( &index, x );
+  return 63 - static_cast<int>( index );
+}
+
+inline int __builtin_ctz( unsigned int x )
+{
+  unsigned long index;
+  _BitScanForward( &index, x );
+  return static_cast<int>( index );
+}
+
+inline int __builtin_clz( unsigned int x )
+{
+  unsigned long index;
+  _BitScanReverse( &index, x );
+  return 31 - static_cast<int>( index );
+}
 #endif
\ No newline at end of file
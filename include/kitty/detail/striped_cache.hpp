@@ -0,0 +1,387 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file striped_cache.hpp
+  \brief Bounded thread-safe cache with lock striping
+
+  \author Mathias Soeken
+*/
+
+/*! \cond PRIVATE */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../dynamic_truth_table.hpp"
+#include "utils.hpp"
+
+namespace kitty
+{
+
+namespace detail
+{
+
+inline uint64_t mix_hash( uint64_t h )
+{
+  /* finalizer from splitmix64 */
+  h ^= h >> 30;
+  h *= UINT64_C( 0xbf58476d1ce4e5b9 );
+  h ^= h >> 27;
+  h *= UINT64_C( 0x94d049bb133111eb );
+  h ^= h >> 31;
+  return h;
+}
+
+/* memory allocated on the heap by a cached key or value */
+template<typename T>
+inline uint64_t heap_size( const T& value )
+{
+  (void)value;
+  return 0u;
+}
+
+inline uint64_t heap_size( const dynamic_truth_table& tt )
+{
+  return tt._bits.capacity() * sizeof( uint64_t );
+}
+
+template<typename T>
+inline uint64_t heap_size( const std::vector<T>& v )
+{
+  return v.capacity() * sizeof( T );
+}
+
+template<typename T1, typename T2>
+inline uint64_t heap_size( const std::pair<T1, T2>& p )
+{
+  return heap_size( p.first ) + heap_size( p.second );
+}
+
+template<typename... Ts>
+inline uint64_t heap_size( const std::tuple<Ts...>& t )
+{
+  return std::apply( []( const auto&... elems ) { return ( uint64_t( 0 ) + ... + heap_size( elems ) ); }, t );
+}
+
+struct cache_statistics
+{
+  /*! Number of lookups answered from the cache. */
+  uint64_t hits{ 0u };
+
+  /*! Number of lookups that were not answered from the cache. */
+  uint64_t misses{ 0u };
+
+  /*! Number of entries that were removed to make room for new entries. */
+  uint64_t evictions{ 0u };
+
+  /*! Number of entries currently stored. */
+  uint64_t entries{ 0u };
+
+  /*! Estimated memory usage of slots and stored entries in bytes. */
+  uint64_t memory_usage{ 0u };
+
+  /*! Fraction of lookups answered from the cache. */
+  inline double hit_rate() const
+  {
+    const auto total = hits + misses;
+    return total == 0u ? 0.0 : static_cast<double>( hits ) / total;
+  }
+};
+
+/* Bounded cache split into stripes, each protected by its own mutex.  A stripe
+   is an open addressing table, in which each key can be stored in a bucket of
+   `associativity` consecutive slots.  The number of slots is derived from the
+   memory budget and the size of the first entry stored in a stripe.  Entries
+   are replaced with the clock strategy, both when a bucket is full and when
+   the stored entries exceed the memory budget of their stripe.  If the budget
+   of a stripe cannot hold a single bucket, entries are not stored, in
+   particular, a budget of 0 disables caching.  Keys and values are stored in
+   std::optional and need not be default constructible.
+
+   Lookup and insertion take the hash value of the key and a predicate that
+   compares a stored key to the queried one, such that queries do not need to
+   construct a key. */
+template<typename Key, typename Value>
+class striped_cache
+{
+  struct entry
+  {
+    std::optional<Key> key;
+    std::optional<Value> value;
+    uint64_t hash{ 0u };
+    uint64_t bytes{ 0u };
+    bool referenced{ false };
+  };
+
+  struct alignas( 64 ) stripe
+  {
+    std::mutex mutex;
+    std::vector<entry> slots;
+    uint64_t bytes{ 0u };
+    uint64_t hand{ 0u };
+    uint64_t num_entries{ 0u };
+    uint64_t hits{ 0u };
+    uint64_t misses{ 0u };
+    uint64_t evictions{ 0u };
+  };
+
+public:
+  striped_cache( uint64_t memory_budget, uint32_t num_stripes, uint32_t associativity )
+      : _num_stripes( next_power_of_two( std::max( num_stripes, 1u ) ) ),
+        _associativity( next_power_of_two( std::max( associativity, 1u ) ) ),
+        _memory_budget( memory_budget ),
+        _stripes( new stripe[_num_stripes] )
+  {
+  }
+
+  /* calls fn with the stored value under the lock, if a matching key is found */
+  template<typename Match, typename Fn>
+  bool find( uint64_t h, Match&& match, Fn&& fn )
+  {
+    auto& s = _stripes[stripe_index( h )];
+    std::lock_guard<std::mutex> lock( s.mutex );
+    if ( auto* e = find_entry( s, h, match ); e != nullptr )
+    {
+      ++s.hits;
+      fn( static_cast<const Value&>( *e->value ) );
+      return true;
+    }
+    ++s.misses;
+    return false;
+  }
+
+  template<typename Match>
+  void insert( uint64_t h, Match&& match, Key key, Value value )
+  {
+    auto& s = _stripes[stripe_index( h )];
+    const auto bytes = heap_size( key ) + heap_size( value );
+
+    std::lock_guard<std::mutex> lock( s.mutex );
+    if ( s.slots.empty() )
+    {
+      if ( !allocate( s, bytes ) )
+      {
+        /* the budget is too small for a single bucket */
+        return;
+      }
+    }
+    else if ( find_entry( s, h, match ) != nullptr )
+    {
+      /* another thread inserted the same key meanwhile */
+      return;
+    }
+
+    const auto first = bucket_begin( s, h );
+    entry* victim = nullptr;
+
+    for ( auto i = first; i < first + _associativity; ++i )
+    {
+      if ( !s.slots[i].key )
+      {
+        victim = &s.slots[i];
+        break;
+      }
+    }
+
+    if ( victim == nullptr )
+    {
+      /* clock replacement: skip recently referenced entries once */
+      for ( auto i = first; i < first + _associativity; ++i )
+      {
+        if ( !s.slots[i].referenced )
+        {
+          victim = &s.slots[i];
+          break;
+        }
+        s.slots[i].referenced = false;
+      }
+      if ( victim == nullptr )
+      {
+        victim = &s.slots[first];
+      }
+      evict( s, *victim );
+    }
+
+    victim->key.emplace( std::move( key ) );
+    victim->value.emplace( std::move( value ) );
+    victim->hash = h;
+    victim->bytes = bytes;
+    victim->referenced = false;
+    s.bytes += bytes;
+    ++s.num_entries;
+
+    /* release entries while the stripe exceeds its share of the budget */
+    const auto stripe_budget = _memory_budget.load( std::memory_order_relaxed ) / _num_stripes;
+    for ( auto steps = 0u; s.bytes > stripe_budget && s.num_entries > 0u && steps < 2u * s.slots.size(); ++steps )
+    {
+      auto& e = s.slots[s.hand];
+      s.hand = ( s.hand + 1u ) % s.slots.size();
+      if ( !e.key )
+      {
+        continue;
+      }
+      if ( e.referenced )
+      {
+        e.referenced = false;
+        continue;
+      }
+      evict( s, e );
+    }
+  }
+
+  void clear()
+  {
+    for ( auto i = 0u; i < _num_stripes; ++i )
+    {
+      auto& s = _stripes[i];
+      std::lock_guard<std::mutex> lock( s.mutex );
+      s.slots.clear();
+      s.slots.shrink_to_fit();
+      s.bytes = 0u;
+      s.hand = 0u;
+      s.num_entries = 0u;
+    }
+  }
+
+  /* the budget is changed before the stripes are cleared, such that
+     concurrent insertions do not refill them according to the old budget */
+  void set_memory_budget( uint64_t memory_budget )
+  {
+    _memory_budget.store( memory_budget, std::memory_order_relaxed );
+    clear();
+  }
+
+  uint64_t memory_budget() const
+  {
+    return _memory_budget.load( std::memory_order_relaxed );
+  }
+
+  cache_statistics statistics() const
+  {
+    cache_statistics st;
+    for ( auto i = 0u; i < _num_stripes; ++i )
+    {
+      auto& s = _stripes[i];
+      std::lock_guard<std::mutex> lock( s.mutex );
+      st.hits += s.hits;
+      st.misses += s.misses;
+      st.evictions += s.evictions;
+      st.entries += s.num_entries;
+      st.memory_usage += s.bytes;
+    }
+    return st;
+  }
+
+  void reset_statistics()
+  {
+    for ( auto i = 0u; i < _num_stripes; ++i )
+    {
+      auto& s = _stripes[i];
+      std::lock_guard<std::mutex> lock( s.mutex );
+      s.hits = s.misses = s.evictions = 0u;
+    }
+  }
+
+private:
+  inline uint32_t stripe_index( uint64_t h ) const
+  {
+    return static_cast<uint32_t>( h >> 40 ) & ( _num_stripes - 1u );
+  }
+
+  inline uint64_t bucket_begin( const stripe& s, uint64_t h ) const
+  {
+    const auto num_buckets = s.slots.size() / _associativity;
+    return ( h & ( num_buckets - 1u ) ) * _associativity;
+  }
+
+  template<typename Match>
+  entry* find_entry( stripe& s, uint64_t h, Match&& match ) const
+  {
+    if ( s.slots.empty() )
+    {
+      return nullptr;
+    }
+
+    const auto first = bucket_begin( s, h );
+    for ( auto i = first; i < first + _associativity; ++i )
+    {
+      auto& e = s.slots[i];
+      if ( e.key && e.hash == h && match( static_cast<const Key&>( *e.key ) ) )
+      {
+        e.referenced = true;
+        return &e;
+      }
+    }
+    return nullptr;
+  }
+
+  bool allocate( stripe& s, uint64_t bytes )
+  {
+    const auto entry_size = sizeof( entry ) + bytes;
+    const auto stripe_budget = _memory_budget.load( std::memory_order_relaxed ) / _num_stripes;
+    if ( _associativity * entry_size > stripe_budget )
+    {
+      return false;
+    }
+
+    auto num_buckets = uint64_t( 1u );
+    while ( 2u * num_buckets * _associativity * entry_size <= stripe_budget )
+    {
+      num_buckets <<= 1;
+    }
+    s.slots.resize( num_buckets * _associativity );
+    s.bytes = s.slots.size() * sizeof( entry );
+    return true;
+  }
+
+  void evict( stripe& s, entry& e )
+  {
+    e.key.reset();
+    e.value.reset();
+    e.referenced = false;
+    s.bytes -= e.bytes;
+    --s.num_entries;
+    ++s.evictions;
+  }
+
+private:
+  uint32_t _num_stripes;
+  uint32_t _associativity;
+  std::atomic<uint64_t> _memory_budget;
+  std::unique_ptr<stripe[]> _stripes;
+};
+
+} /* namespace detail */
+} /* namespace kitty */
+/*! \endcond */
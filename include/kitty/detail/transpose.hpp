@@ -0,0 +1,108 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file transpose.hpp
+  \brief Bit-matrix transposition
+
+  \author Mathias Soeken
+*/
+
+/*! \cond PRIVATE */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace kitty
+{
+namespace detail
+{
+
+/* exchanges the off-diagonal J x J blocks in each 2J x 2J block */
+template<uint32_t J>
+inline void transpose64_step( uint64_t* a, uint64_t m )
+{
+  for ( auto base = 0u; base < 64u; base += 2u * J )
+  {
+    for ( auto k = base; k < base + J; ++k )
+    {
+      const auto t = ( ( a[k] >> J ) ^ a[k + J] ) & m;
+      a[k] ^= t << J;
+      a[k + J] ^= t;
+    }
+  }
+}
+
+/* transposes a 64 x 64 bit-matrix in place, i.e., bit j of word i is
+   exchanged with bit i of word j, by swapping off-diagonal blocks of
+   halving size with word-wide operations [H. S. Warren, Hacker's Delight,
+   2nd ed., Sect. 7-3] */
+inline void transpose64( uint64_t* a )
+{
+  transpose64_step<32u>( a, UINT64_C( 0x00000000ffffffff ) );
+  transpose64_step<16u>( a, UINT64_C( 0x0000ffff0000ffff ) );
+  transpose64_step<8u>( a, UINT64_C( 0x00ff00ff00ff00ff ) );
+  transpose64_step<4u>( a, UINT64_C( 0x0f0f0f0f0f0f0f0f ) );
+  transpose64_step<2u>( a, UINT64_C( 0x3333333333333333 ) );
+  transpose64_step<1u>( a, UINT64_C( 0x5555555555555555 ) );
+}
+
+/* transposes a matrix with num_rows x num_cols bits in tiles of 64 x 64
+   bits, src( r ) returns the words of row r in the source and dst( c ) the
+   words of row c in the destination; bits beyond the number of columns in
+   the source are ignored, bits beyond the number of rows in the
+   destination are set to 0 */
+template<typename SrcFn, typename DstFn>
+void transpose_bit_matrix( uint64_t num_rows, uint64_t num_cols, SrcFn&& src, DstFn&& dst )
+{
+  std::array<uint64_t, 64> tile;
+  const auto row_blocks = ( num_rows + 63u ) >> 6;
+  const auto col_blocks = ( num_cols + 63u ) >> 6;
+  for ( uint64_t rb = 0u; rb < row_blocks; ++rb )
+  {
+    const auto rows = std::min<uint64_t>( 64u, num_rows - ( rb << 6 ) );
+    for ( uint64_t cb = 0u; cb < col_blocks; ++cb )
+    {
+      for ( auto i = 0u; i < rows; ++i )
+      {
+        tile[i] = src( ( rb << 6 ) + i )[cb];
+      }
+      std::fill( tile.begin() + rows, tile.end(), uint64_t( 0 ) );
+      transpose64( tile.data() );
+
+      const auto cols = std::min<uint64_t>( 64u, num_cols - ( cb << 6 ) );
+      for ( auto i = 0u; i < cols; ++i )
+      {
+        dst( ( cb << 6 ) + i )[rb] = tile[i];
+      }
+    }
+  }
+}
+
+} /* namespace detail */
+} /* namespace kitty */
+/*! \endcond */
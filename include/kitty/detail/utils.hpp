@@ -34,6 +34,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <string>
 
 namespace kitty
@@ -42,6 +43,16 @@ namespace kitty
 namespace detail
 {
 
+inline uint32_t next_power_of_two( uint32_t v )
+{
+  uint32_t p = 1u;
+  while ( p < v )
+  {
+    p <<= 1;
+  }
+  return p;
+}
+
 /* string utils are from https://stackoverflow.com/a/217605 */
 inline void ltrim( std::string& s )
 {
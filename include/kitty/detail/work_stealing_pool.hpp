@@ -0,0 +1,234 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file work_stealing_pool.hpp
+  \brief Thread pool for fork-join parallelism
+
+  \author Mathias Soeken
+*/
+
+/*! \cond PRIVATE */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kitty
+{
+
+namespace detail
+{
+
+/* counts the pending tasks of a fork-join scope */
+struct task_group
+{
+  std::atomic<uint32_t> pending{ 0u };
+};
+
+/* Thread pool with one task deque per worker.  Workers pop tasks from the back
+   of their own deque and steal from the front of other deques.  The thread
+   that constructs the pool is worker 0 and executes tasks while it waits for
+   a task group, as do other workers that wait for nested task groups.  A pool
+   may be created inside a task of another pool; the calling thread is worker
+   0 of the inner pool until the inner pool is destroyed. */
+class work_stealing_pool
+{
+  struct alignas( 64 ) worker_queue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+public:
+  explicit work_stealing_pool( uint32_t num_threads )
+      : _num_threads( num_threads == 0u ? std::max( std::thread::hardware_concurrency(), 1u ) : num_threads ),
+        _queues( new worker_queue[_num_threads] ),
+        _previous( current() )
+  {
+    current() = { this, 0u };
+    for ( auto i = 1u; i < _num_threads; ++i )
+    {
+      _threads.emplace_back( [this, i]() { work( i ); } );
+    }
+  }
+
+  ~work_stealing_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _stop = true;
+    }
+    _cv.notify_all();
+    for ( auto& t : _threads )
+    {
+      t.join();
+    }
+    current() = _previous;
+  }
+
+  work_stealing_pool( const work_stealing_pool& ) = delete;
+  work_stealing_pool& operator=( const work_stealing_pool& ) = delete;
+
+  uint32_t num_threads() const
+  {
+    return _num_threads;
+  }
+
+  /* index of the calling worker */
+  uint32_t worker_index() const
+  {
+    return current().pool == this ? current().index : 0u;
+  }
+
+  template<typename Fn>
+  void submit( task_group& group, Fn&& fn )
+  {
+    group.pending.fetch_add( 1u, std::memory_order_relaxed );
+    auto& q = _queues[worker_index()];
+    {
+      std::lock_guard<std::mutex> lock( q.mutex );
+      q.tasks.emplace_back( [&group, fn = std::forward<Fn>( fn )]() mutable {
+        fn();
+        group.pending.fetch_sub( 1u, std::memory_order_release );
+      } );
+    }
+    _num_queued.fetch_add( 1u, std::memory_order_release );
+    {
+      /* synchronize with workers that are about to sleep */
+      std::lock_guard<std::mutex> lock( _mutex );
+    }
+    _cv.notify_one();
+  }
+
+  /* executes tasks until all tasks of the group are finished */
+  void wait( task_group& group )
+  {
+    const auto index = worker_index();
+    while ( group.pending.load( std::memory_order_acquire ) != 0u )
+    {
+      if ( !run_one( index ) )
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+private:
+  struct worker_id
+  {
+    work_stealing_pool* pool;
+    uint32_t index;
+  };
+
+  static worker_id& current()
+  {
+    thread_local worker_id id{ nullptr, 0u };
+    return id;
+  }
+
+  bool pop( uint32_t index, std::function<void()>& task, bool steal )
+  {
+    auto& q = _queues[index];
+    std::lock_guard<std::mutex> lock( q.mutex );
+    if ( q.tasks.empty() )
+    {
+      return false;
+    }
+    if ( steal )
+    {
+      task = std::move( q.tasks.front() );
+      q.tasks.pop_front();
+    }
+    else
+    {
+      task = std::move( q.tasks.back() );
+      q.tasks.pop_back();
+    }
+    _num_queued.fetch_sub( 1u, std::memory_order_relaxed );
+    return true;
+  }
+
+  bool run_one( uint32_t index )
+  {
+    std::function<void()> task;
+    if ( !pop( index, task, false ) )
+    {
+      auto found = false;
+      for ( auto i = 1u; i < _num_threads && !found; ++i )
+      {
+        found = pop( ( index + i ) % _num_threads, task, true );
+      }
+      if ( !found )
+      {
+        return false;
+      }
+    }
+    task();
+    return true;
+  }
+
+  void work( uint32_t index )
+  {
+    current() = { this, index };
+    while ( true )
+    {
+      if ( run_one( index ) )
+      {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock( _mutex );
+      _cv.wait( lock, [this]() { return _stop || _num_queued.load( std::memory_order_acquire ) != 0u; } );
+      if ( _stop )
+      {
+        return;
+      }
+    }
+  }
+
+private:
+  uint32_t _num_threads;
+  std::unique_ptr<worker_queue[]> _queues;
+  worker_id _previous;
+  std::vector<std::thread> _threads;
+
+  std::atomic<uint32_t> _num_queued{ 0u };
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _stop{ false };
+};
+
+} /* namespace detail */
+} /* namespace kitty */
+/*! \endcond */
@@ -32,11 +32,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
 #include <stack>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "npn.hpp"
 #include "operators.hpp"
+#include "static_truth_table.hpp"
 
 namespace kitty
 {
@@ -102,4 +113,301 @@ void fuller_neighborhood_enumeration( std::vector<TT>& functions, CanonizationFn
   }
 }
 
+/*! \brief Enumerates NPN classes by marking orbits in a bitmap
+
+  This enumerator visits all \f$2^{2^n}\f$ functions over `NumVars`
+  variables in increasing order and keeps a bitmap of the functions that have
+  already been seen.  When an unvisited function is found, its whole NPN class
+  is enumerated (using `exact_np_enumeration` on the function and its
+  complement) and all members are marked as visited.  The smallest member of
+  each class, i.e., its NPN representative, is passed to a callback together
+  with the size of the class.  No canonization and no hash set is required,
+  but the bitmap requires \f$2^{2^n}\f$ bits, i.e., 512 MB for 5 variables.
+
+  The scan can be distributed over several threads, which process chunks of
+  functions and update the bitmap atomically.  A class is reported by the
+  thread that first marks its representative, hence each class is reported
+  exactly once, but the order of the reported classes depends on the
+  scheduling when more than one thread is used.
+
+  The enumeration can be interrupted after some number of functions and
+  resumed later, also from a checkpoint that has been written with `save` and
+  read with `load`.
+
+  Example:
+
+  \verbatim embed:rst
+  .. code-block:: c++
+
+     kitty::npn_bitmap_enumerator<4> enumerator( 4u ); // 4 threads
+     enumerator.run( []( const auto& repr, uint64_t class_size ) {
+       kitty::print_hex( repr );
+       std::cout << " " << class_size << std::endl;
+     } );
+     std::cout << enumerator.num_classes() << std::endl; // 222
+  \endverbatim
+*/
+template<uint32_t NumVars>
+class npn_bitmap_enumerator
+{
+  static_assert( NumVars <= 5u, "Bitmap enumeration is only possible for up to 5 variables." );
+
+public:
+  using truth_table = static_truth_table<NumVars>;
+
+  /*! Number of functions over `NumVars` variables. */
+  static constexpr uint64_t num_functions = uint64_t( 1 ) << ( 1u << NumVars );
+
+private:
+  static constexpr uint64_t num_words = ( num_functions + 63u ) / 64u;
+  static constexpr uint32_t checkpoint_magic = 0x4e504e42; /* "NPNB" */
+
+public:
+  /*! \brief Constructor
+
+    \param num_threads Number of worker threads (0 uses the hardware concurrency)
+    \param chunk_size Number of functions that a thread scans at once
+  */
+  explicit npn_bitmap_enumerator( uint32_t num_threads = 1u, uint64_t chunk_size = 1u << 14 )
+      : _num_threads( num_threads == 0u ? std::max( std::thread::hardware_concurrency(), 1u ) : num_threads ),
+        _chunk_size( std::max<uint64_t>( chunk_size, 64u ) ),
+        _bitmap( new std::atomic<uint64_t>[num_words]() )
+  {
+  }
+
+  /*! \brief Scans functions and reports new classes
+
+    Continues the scan at the current position and scans at most
+    `max_functions` functions.  The callback is called with the NPN
+    representative (as `static_truth_table<NumVars>`) and the size of its NPN
+    class.  Calls to the callback are serialized.
+
+    \param fn Callback for each class
+    \param max_functions Maximum number of functions to scan in this call
+    \return True, if all functions have been scanned
+  */
+  template<typename Fn>
+  bool run( Fn&& fn, uint64_t max_functions = num_functions )
+  {
+    const auto end = std::min( num_functions, _cursor + std::min( max_functions, num_functions ) );
+    std::atomic<uint64_t> next{ _cursor };
+    std::mutex fn_mutex;
+
+    const auto worker = [&]() {
+      std::vector<uint64_t> members;
+      while ( true )
+      {
+        const auto begin = next.fetch_add( _chunk_size );
+        if ( begin >= end )
+        {
+          break;
+        }
+
+        const auto chunk_end = std::min( end, begin + _chunk_size );
+        for ( auto f = begin; f < chunk_end; ++f )
+        {
+          if ( !is_visited( f ) )
+          {
+            visit_class( f, members, fn, fn_mutex );
+          }
+        }
+      }
+    };
+
+    const auto num_threads = static_cast<uint32_t>( std::min<uint64_t>( _num_threads, ( end - _cursor + _chunk_size - 1u ) / _chunk_size ) );
+    if ( num_threads <= 1u )
+    {
+      worker();
+    }
+    else
+    {
+      std::vector<std::thread> threads;
+      for ( auto i = 0u; i < num_threads; ++i )
+      {
+        threads.emplace_back( worker );
+      }
+      for ( auto& t : threads )
+      {
+        t.join();
+      }
+    }
+
+    _cursor = end;
+    return finished();
+  }
+
+  /*! \brief Returns true, if all functions have been scanned */
+  bool finished() const
+  {
+    return _cursor == num_functions;
+  }
+
+  /*! \brief Returns the number of scanned functions */
+  uint64_t cursor() const
+  {
+    return _cursor;
+  }
+
+  /*! \brief Returns the number of reported classes */
+  uint64_t num_classes() const
+  {
+    return _num_classes.load();
+  }
+
+  /*! \brief Writes a checkpoint
+
+    Must not be called while `run` is executing.
+
+    \param os Output stream (opened in binary mode)
+    \return True on success
+  */
+  bool save( std::ostream& os ) const
+  {
+    const uint32_t header[2] = { checkpoint_magic, NumVars };
+    const uint64_t state[2] = { _cursor, _num_classes.load() };
+    os.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+    os.write( reinterpret_cast<const char*>( state ), sizeof( state ) );
+
+    std::vector<uint64_t> buffer;
+    for ( uint64_t i = 0u; i < num_words; i += 1024u )
+    {
+      buffer.resize( std::min<uint64_t>( 1024u, num_words - i ) );
+      for ( auto j = 0u; j < buffer.size(); ++j )
+      {
+        buffer[j] = _bitmap[i + j].load( std::memory_order_relaxed );
+      }
+      os.write( reinterpret_cast<const char*>( buffer.data() ), buffer.size() * sizeof( uint64_t ) );
+    }
+
+    return static_cast<bool>( os );
+  }
+
+  /*! \brief Writes a checkpoint into a file
+
+    \param filename Filename
+    \return True on success
+  */
+  bool save( const std::string& filename ) const
+  {
+    std::ofstream os( filename, std::ios::binary );
+    return save( os );
+  }
+
+  /*! \brief Reads a checkpoint
+
+    The enumerator is left unchanged if the checkpoint is invalid or has been
+    written for a different number of variables.
+
+    \param is Input stream (opened in binary mode)
+    \return True on success
+  */
+  bool load( std::istream& is )
+  {
+    uint32_t header[2];
+    uint64_t state[2];
+    is.read( reinterpret_cast<char*>( header ), sizeof( header ) );
+    is.read( reinterpret_cast<char*>( state ), sizeof( state ) );
+    if ( !is || header[0] != checkpoint_magic || header[1] != NumVars || state[0] > num_functions )
+    {
+      return false;
+    }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> bitmap( new std::atomic<uint64_t>[num_words]() );
+    std::vector<uint64_t> buffer;
+    for ( uint64_t i = 0u; i < num_words; i += 1024u )
+    {
+      buffer.resize( std::min<uint64_t>( 1024u, num_words - i ) );
+      is.read( reinterpret_cast<char*>( buffer.data() ), buffer.size() * sizeof( uint64_t ) );
+      if ( !is )
+      {
+        return false;
+      }
+      for ( auto j = 0u; j < buffer.size(); ++j )
+      {
+        bitmap[i + j].store( buffer[j], std::memory_order_relaxed );
+      }
+    }
+
+    _bitmap = std::move( bitmap );
+    _cursor = state[0];
+    _num_classes = state[1];
+    return true;
+  }
+
+  /*! \brief Reads a checkpoint from a file
+
+    \param filename Filename
+    \return True on success
+  */
+  bool load( const std::string& filename )
+  {
+    std::ifstream is( filename, std::ios::binary );
+    return is && load( is );
+  }
+
+private:
+  inline bool is_visited( uint64_t f ) const
+  {
+    return ( _bitmap[f >> 6].load( std::memory_order_relaxed ) >> ( f & 63u ) ) & 1u;
+  }
+
+  /* sets the bit and returns whether it was set before */
+  inline bool mark_visited( uint64_t f )
+  {
+    const auto mask = uint64_t( 1 ) << ( f & 63u );
+    return ( _bitmap[f >> 6].fetch_or( mask ) & mask ) != 0u;
+  }
+
+  template<typename Fn>
+  void visit_class( uint64_t f, std::vector<uint64_t>& members, Fn&& fn, std::mutex& fn_mutex )
+  {
+    members.clear();
+
+    truth_table tt;
+    tt._bits = f;
+
+    const auto collect = [&]( const auto& t, auto&&... ) { members.push_back( t._bits ); };
+    for ( const auto& t : { tt, ~tt } )
+    {
+      if constexpr ( NumVars == 1u )
+      {
+        collect( t );
+        collect( flip( t, 0u ) );
+      }
+      else
+      {
+        exact_np_enumeration( t, collect );
+      }
+    }
+
+    /* the representative is claimed first, such that only one thread reports the class */
+    const auto repr = *std::min_element( members.begin(), members.end() );
+    if ( mark_visited( repr ) )
+    {
+      return;
+    }
+
+    uint64_t class_size{ 1u };
+    for ( auto g : members )
+    {
+      if ( g != repr && !is_visited( g ) && !mark_visited( g ) )
+      {
+        ++class_size;
+      }
+    }
+    ++_num_classes;
+
+    tt._bits = repr;
+    std::lock_guard<std::mutex> lock( fn_mutex );
+    fn( tt, class_size );
+  }
+
+private:
+  uint32_t _num_threads;
+  uint64_t _chunk_size;
+  uint64_t _cursor{ 0u };
+  std::atomic<uint64_t> _num_classes{ 0u };
+  std::unique_ptr<std::atomic<uint64_t>[]> _bitmap;
+};
+
 } /* namespace kitty */
\ No newline at end of file
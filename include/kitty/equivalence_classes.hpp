@@ -0,0 +1,448 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file equivalence_classes.hpp
+  \brief Equivalence classes of signals by simulation signatures
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hash.hpp"
+#include "partial_truth_table.hpp"
+#include "pattern_store.hpp"
+#include "detail/work_stealing_pool.hpp"
+
+namespace kitty
+{
+
+/*! \brief Parameters for equivalence_classes */
+struct equivalence_classes_params
+{
+  /*! Signals that are equal up to complementation are in the same class. */
+  bool complement{ true };
+
+  /*! Number of threads to refine classes (0 = hardware concurrency). */
+  uint32_t num_threads{ 1u };
+};
+
+/*! \brief Statistics for equivalence_classes */
+struct equivalence_classes_stats
+{
+  /*! Number of calls to refine. */
+  uint32_t refinements{ 0u };
+
+  /*! Number of classes that were split into several classes. */
+  uint64_t split_classes{ 0u };
+
+  /*! Number of classes that were created by splits. */
+  uint64_t new_classes{ 0u };
+
+  /*! Number of blocks that were hashed (one block of one signal counts 1). */
+  uint64_t hashed_blocks{ 0u };
+
+  /*! Number of hash collisions resolved by comparing blocks. */
+  uint64_t collisions{ 0u };
+};
+
+/*! \brief Equivalence classes of signals by simulation signatures
+
+  Partitions signals into classes of signals with equal signatures, e.g.,
+  for candidate equivalences in SAT sweeping.  If `ps.complement` is set,
+  each signature is normalized such that its first bit is 0, and signals
+  whose signatures are equal up to complementation are in the same class.
+  The phase of a signal tells whether it is complemented with respect to
+  the normalized signature.
+
+  The first call to `refine` splits all signals by the hash values of their
+  normalized signatures, and equal hash values are confirmed by comparing
+  the signatures.  Since signatures only grow, classes can only be split
+  later: subsequent calls to `refine` only hash the blocks that contain new
+  bits, and only for the signals in classes with more than one signal.
+  These classes are independent and are refined in parallel if
+  `ps.num_threads` is not 1.  Signals that are added between two calls are
+  inserted into the class of an equal signature or into a new class.
+
+  The order of classes and of signals in classes does not depend on the
+  number of threads.
+*/
+class equivalence_classes
+{
+public:
+  /*! \brief Constructor
+
+    \param ps Parameters
+  */
+  explicit equivalence_classes( const equivalence_classes_params& ps = {} ) : _ps( ps )
+  {
+  }
+
+  /*! \brief Refines the classes with signatures from a pattern store
+
+    \param store Pattern store with one signal per signature
+  */
+  void refine( const pattern_store& store )
+  {
+    refine_impl( store.num_signals(), store.num_bits(), [&]( auto i ) { return &*store.view( i ).cbegin(); } );
+  }
+
+  /*! \brief Refines the classes with signatures
+
+    All signatures must have the same number of bits.
+
+    \param signatures Signatures
+  */
+  void refine( const std::vector<partial_truth_table>& signatures )
+  {
+    const auto num_bits = signatures.empty() ? 0u : signatures.front().num_bits();
+    assert( std::all_of( signatures.begin(), signatures.end(), [&]( const auto& s ) { return s.num_bits() == num_bits; } ) );
+    refine_impl( static_cast<uint32_t>( signatures.size() ), num_bits, [&]( auto i ) { return signatures[i]._bits.data(); } );
+  }
+
+  /*! \brief Returns the number of classes */
+  inline uint32_t num_classes() const
+  {
+    return static_cast<uint32_t>( _classes.size() );
+  }
+
+  /*! \brief Returns the number of signals */
+  inline uint32_t num_signals() const
+  {
+    return static_cast<uint32_t>( _class_of.size() );
+  }
+
+  /*! \brief Returns the signals of a class in increasing order
+
+    \param index Class index
+  */
+  inline const std::vector<uint32_t>& members( uint32_t index ) const
+  {
+    return _classes[index];
+  }
+
+  /*! \brief Returns the class of a signal
+
+    \param signal Signal index
+  */
+  inline uint32_t class_of( uint32_t signal ) const
+  {
+    return _class_of[signal];
+  }
+
+  /*! \brief Returns whether a signal is complemented in its class
+
+    \param signal Signal index
+  */
+  inline bool phase( uint32_t signal ) const
+  {
+    return _phase[signal] != 0u;
+  }
+
+  /*! \brief Calls a function for each class with more than one signal
+
+    \param fn Callback with signature `void(const std::vector<uint32_t>&)`
+  */
+  template<typename Fn>
+  void foreach_nontrivial_class( Fn&& fn ) const
+  {
+    for ( const auto& c : _classes )
+    {
+      if ( c.size() > 1u )
+      {
+        fn( c );
+      }
+    }
+  }
+
+  /*! \brief Returns statistics */
+  inline const equivalence_classes_stats& stats() const
+  {
+    return _st;
+  }
+
+private:
+  template<typename WordsFn>
+  void refine_impl( uint32_t num_signals, uint32_t num_bits, WordsFn&& words_of )
+  {
+    assert( num_signals >= num_signals_known() );
+    assert( num_bits >= _num_bits );
+    ++_st.refinements;
+
+    const auto num_blocks = num_bits ? ( ( ( num_bits - 1 ) >> 6 ) + 1u ) : 0u;
+    const auto last_mask = ( num_bits & 0x3f ) ? ( 0xFFFFFFFFFFFFFFFF >> ( 64 - ( num_bits & 0x3f ) ) ) : 0xFFFFFFFFFFFFFFFF;
+
+    /* phases are fixed by the first bit */
+    if ( _num_bits == 0u && num_bits > 0u )
+    {
+      for ( auto i = 0u; i < _phase.size(); ++i )
+      {
+        _phase[i] = _ps.complement ? static_cast<uint8_t>( words_of( i )[0] & 1 ) : 0u;
+      }
+    }
+
+    const auto normalized = [&]( uint32_t signal, uint64_t block ) {
+      auto word = words_of( signal )[block];
+      if ( _phase[signal] )
+      {
+        word = ~word;
+      }
+      return block + 1u == num_blocks ? word & last_mask : word;
+    };
+
+    /* split classes with respect to blocks with new bits */
+    const auto first_block = _num_bits >> 6;
+    if ( first_block < num_blocks )
+    {
+      split_classes( first_block, num_blocks, normalized );
+    }
+
+    /* insert new signals */
+    const auto old_signals = num_signals_known();
+    if ( num_signals > old_signals )
+    {
+      insert_signals( old_signals, num_signals, num_blocks, normalized, words_of );
+    }
+
+    _num_bits = num_bits;
+  }
+
+  inline uint32_t num_signals_known() const
+  {
+    return static_cast<uint32_t>( _class_of.size() );
+  }
+
+  template<typename NormalizedFn>
+  std::size_t hash_range( uint32_t signal, uint64_t begin, uint64_t end, NormalizedFn&& normalized ) const
+  {
+    std::size_t seed = 0u;
+    for ( auto b = begin; b < end; ++b )
+    {
+      hash_combine( seed, hash_block( normalized( signal, b ) ) );
+    }
+    return seed;
+  }
+
+  template<typename NormalizedFn>
+  static bool equal_range( uint32_t a, uint32_t b, uint64_t begin, uint64_t end, NormalizedFn&& normalized )
+  {
+    for ( auto block = begin; block < end; ++block )
+    {
+      if ( normalized( a, block ) != normalized( b, block ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* splits members by their blocks in [begin, end), the first subclass
+     contains the first member; returns number of hashed blocks and collisions */
+  template<typename NormalizedFn>
+  std::pair<uint64_t, uint64_t> split( const std::vector<uint32_t>& members, uint64_t begin, uint64_t end, NormalizedFn&& normalized, std::vector<std::vector<uint32_t>>& subclasses ) const
+  {
+    std::vector<std::pair<std::size_t, uint32_t>> keys( members.size() );
+    for ( auto i = 0u; i < members.size(); ++i )
+    {
+      keys[i] = { hash_range( members[i], begin, end, normalized ), members[i] };
+    }
+    std::sort( keys.begin(), keys.end() );
+
+    uint64_t collisions = 0u;
+    for ( auto first = keys.begin(); first != keys.end(); )
+    {
+      auto last = std::find_if( first, keys.end(), [&]( const auto& k ) { return k.first != first->first; } );
+
+      /* equal hash values, compare blocks against the representatives */
+      const auto group_begin = subclasses.size();
+      for ( auto it = first; it != last; ++it )
+      {
+        auto found = false;
+        for ( auto c = group_begin; c < subclasses.size(); ++c )
+        {
+          if ( equal_range( subclasses[c].front(), it->second, begin, end, normalized ) )
+          {
+            subclasses[c].push_back( it->second );
+            found = true;
+            break;
+          }
+        }
+        if ( !found )
+        {
+          collisions += subclasses.size() > group_begin ? 1u : 0u;
+          subclasses.push_back( { it->second } );
+        }
+      }
+      first = last;
+    }
+
+    /* deterministic order: sorted members, subclasses by smallest member */
+    for ( auto& c : subclasses )
+    {
+      std::sort( c.begin(), c.end() );
+    }
+    std::sort( subclasses.begin(), subclasses.end() );
+    return { members.size() * ( end - begin ), collisions };
+  }
+
+  template<typename NormalizedFn>
+  void split_classes( uint64_t begin, uint64_t end, NormalizedFn&& normalized )
+  {
+    std::vector<uint32_t> todo;
+    for ( auto c = 0u; c < _classes.size(); ++c )
+    {
+      if ( _classes[c].size() > 1u )
+      {
+        todo.push_back( c );
+      }
+    }
+
+    std::vector<std::vector<std::vector<uint32_t>>> results( todo.size() );
+    std::vector<std::pair<uint64_t, uint64_t>> counts( todo.size() );
+    const auto run = [&]( uint64_t from, uint64_t to ) {
+      for ( auto k = from; k < to; ++k )
+      {
+        counts[k] = split( _classes[todo[k]], begin, end, normalized, results[k] );
+      }
+    };
+
+    if ( _ps.num_threads == 1u || todo.size() < 2u )
+    {
+      run( 0u, todo.size() );
+    }
+    else
+    {
+      /* batches of classes with similar work */
+      detail::work_stealing_pool pool( _ps.num_threads );
+      detail::task_group group;
+      const uint64_t batch_work = 1u << 14u;
+      uint64_t from = 0u, work = 0u;
+      for ( auto k = 0u; k < todo.size(); ++k )
+      {
+        work += _classes[todo[k]].size() * ( end - begin );
+        if ( work >= batch_work || k + 1u == todo.size() )
+        {
+          pool.submit( group, [&run, from, k]() { run( from, k + 1u ); } );
+          from = k + 1u;
+          work = 0u;
+        }
+      }
+      pool.wait( group );
+    }
+
+    for ( auto k = 0u; k < todo.size(); ++k )
+    {
+      _st.hashed_blocks += counts[k].first;
+      _st.collisions += counts[k].second;
+
+      auto& subclasses = results[k];
+      if ( subclasses.size() == 1u )
+      {
+        continue;
+      }
+      ++_st.split_classes;
+      _st.new_classes += subclasses.size() - 1u;
+      _classes[todo[k]] = std::move( subclasses[0] );
+      for ( auto c = 1u; c < subclasses.size(); ++c )
+      {
+        const auto index = static_cast<uint32_t>( _classes.size() );
+        for ( auto s : subclasses[c] )
+        {
+          _class_of[s] = index;
+        }
+        _classes.push_back( std::move( subclasses[c] ) );
+      }
+    }
+  }
+
+  template<typename NormalizedFn, typename WordsFn>
+  void insert_signals( uint32_t from, uint32_t to, uint64_t num_blocks, NormalizedFn&& normalized, WordsFn&& words_of )
+  {
+    _class_of.resize( to );
+    _phase.resize( to );
+    for ( auto i = from; i < to; ++i )
+    {
+      _phase[i] = ( _ps.complement && num_blocks > 0u ) ? static_cast<uint8_t>( words_of( i )[0] & 1 ) : 0u;
+    }
+
+    /* index of representatives by hash of full signature */
+    std::unordered_multimap<std::size_t, uint32_t> index;
+    if ( from > 0u )
+    {
+      for ( auto c = 0u; c < _classes.size(); ++c )
+      {
+        index.emplace( hash_range( _classes[c].front(), 0u, num_blocks, normalized ), c );
+      }
+      _st.hashed_blocks += _classes.size() * num_blocks;
+    }
+
+    for ( auto i = from; i < to; ++i )
+    {
+      const auto key = hash_range( i, 0u, num_blocks, normalized );
+      _st.hashed_blocks += num_blocks;
+
+      auto found = false;
+      const auto range = index.equal_range( key );
+      for ( auto it = range.first; it != range.second; ++it )
+      {
+        if ( equal_range( _classes[it->second].front(), i, 0u, num_blocks, normalized ) )
+        {
+          _classes[it->second].push_back( i );
+          _class_of[i] = it->second;
+          found = true;
+          break;
+        }
+        ++_st.collisions;
+      }
+
+      if ( !found )
+      {
+        _class_of[i] = static_cast<uint32_t>( _classes.size() );
+        index.emplace( key, _class_of[i] );
+        _classes.push_back( { i } );
+      }
+    }
+  }
+
+private:
+  equivalence_classes_params _ps;
+  equivalence_classes_stats _st;
+
+  uint32_t _num_bits{ 0u };
+  std::vector<std::vector<uint32_t>> _classes;
+  std::vector<uint32_t> _class_of;
+  std::vector<uint8_t> _phase;
+};
+
+} /* namespace kitty */
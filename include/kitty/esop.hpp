@@ -33,17 +33,18 @@
 
 #pragma once
 
-// #ifndef _MSC_VER
-// #warning "DEPRECATED: the functions in this file are marked as deprecated.  Most recent implementation can be found in https://github.com/hriener/easy/ in the file src/esop/constructors.hpp"
-// #endif
-
-#include <unordered_map>
-#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "algorithm.hpp"
 #include "constructors.hpp"
 #include "cube.hpp"
+#include "detail/constants.hpp"
+#include "detail/work_stealing_pool.hpp"
 #include "hash.hpp"
 #include "operations.hpp"
 #include "operators.hpp"
@@ -52,6 +53,16 @@
 namespace kitty
 {
 
+/*! \brief Parameters for esop_from_optimum_pkrm */
+struct pkrm_params
+{
+  /*! Number of threads (0 = number of hardware threads). */
+  uint32_t num_threads{ 1u };
+
+  /*! Number of top-most variables whose expansions are split into tasks. */
+  uint32_t parallel_depth{ 2u };
+};
+
 /*! \cond PRIVATE */
 namespace detail
 {
@@ -63,134 +74,621 @@ enum class pkrm_decomposition
   shannon
 };
 
-template<typename TT>
-using expansion_cache = std::unordered_map<TT, std::pair<uint32_t, pkrm_decomposition>, hash<TT>>;
+inline uint64_t pkrm_word_mask( uint32_t num_vars )
+{
+  return num_vars >= 6u ? ~uint64_t( 0 ) : ( uint64_t( 1 ) << ( 1u << num_vars ) ) - 1u;
+}
 
-template<typename TT>
-uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache, uint8_t var_index )
+inline uint64_t pkrm_num_words( uint32_t num_vars )
 {
-  /* terminal cases */
-  if ( is_const0( tt ) )
+  return num_vars <= 6u ? 1u : uint64_t( 1 ) << ( num_vars - 6u );
+}
+
+/* chooses the expansion from the costs of f0, f1, and f0 ^ f1; positive
+   Davio uses f0 and f0 ^ f1, negative Davio uses f1 and f0 ^ f1, and Shannon
+   uses f0 and f1, such that the most expensive sub-function is omitted */
+inline std::pair<uint32_t, pkrm_decomposition> choose_pkrm_decomposition( uint32_t ex0, uint32_t ex1, uint32_t ex2 )
+{
+  const auto ex_max = std::max( std::max( ex0, ex1 ), ex2 );
+  if ( ex_max == ex0 )
   {
-    return 0;
+    return { ex1 + ex2, pkrm_decomposition::negative_davio };
   }
-  if ( is_const0( ~tt ) )
+  else if ( ex_max == ex1 )
+  {
+    return { ex0 + ex2, pkrm_decomposition::positive_davio };
+  }
+  else
   {
-    return 1;
+    return { ex0 + ex1, pkrm_decomposition::shannon };
   }
+}
+
+/* Open addressing hash table from functions over k variables to the cost and
+   the decomposition of their optimum PKRM expansion.  Keys are stored in an
+   arena of words, such that entries are small and the table is a single
+   allocation that is rehashed when it becomes half full. */
+class pkrm_cache
+{
+public:
+  struct entry
+  {
+    uint64_t hash{ 0u };
+    uint64_t offset{ 0u };
+    uint32_t cost{ 0u };
+    uint8_t num_vars{ 0u };
+    pkrm_decomposition decomposition{ pkrm_decomposition::positive_davio };
+    bool occupied{ false };
+  };
+
+  pkrm_cache() : _table( 1024u ) {}
 
-  /* already computed */
-  const auto it = cache.find( tt );
-  if ( it != cache.end() )
+  static uint64_t hash_of( const uint64_t* words, uint32_t num_vars )
   {
-    return it->second.first;
+    const auto num_words = pkrm_num_words( num_vars );
+    std::size_t seed = hash_block( num_vars );
+    for ( auto i = 0u; i < num_words; ++i )
+    {
+      hash_combine( seed, hash_block( words[i] ) );
+    }
+    return seed;
   }
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+  const entry* find( const uint64_t* words, uint32_t num_vars, uint64_t h ) const
+  {
+    const auto mask = _table.size() - 1u;
+    for ( auto i = h & mask;; i = ( i + 1u ) & mask )
+    {
+      const auto& e = _table[i];
+      if ( !e.occupied )
+      {
+        return nullptr;
+      }
+      if ( e.hash == h && e.num_vars == num_vars && std::equal( words, words + pkrm_num_words( num_vars ), _arena.begin() + e.offset ) )
+      {
+        return &e;
+      }
+    }
+  }
 
-  const auto ex0 = find_pkrm_expansions( tt0, cache, var_index + 1 );
-  const auto ex1 = find_pkrm_expansions( tt1, cache, var_index + 1 );
-  const auto ex2 = find_pkrm_expansions( tt0 ^ tt1, cache, var_index + 1 );
+  void insert( const uint64_t* words, uint32_t num_vars, uint64_t h, uint32_t cost, pkrm_decomposition decomposition )
+  {
+    if ( 2u * ( _num_entries + 1u ) > _table.size() )
+    {
+      grow();
+    }
 
-  const auto ex_max = std::max( std::max( ex0, ex1 ), ex2 );
+    entry e;
+    e.hash = h;
+    e.offset = _arena.size();
+    e.cost = cost;
+    e.num_vars = static_cast<uint8_t>( num_vars );
+    e.decomposition = decomposition;
+    e.occupied = true;
+    _arena.insert( _arena.end(), words, words + pkrm_num_words( num_vars ) );
+    place( e );
+    ++_num_entries;
+  }
 
-  uint32_t cost{};
-  pkrm_decomposition decomp;
+  uint64_t size() const
+  {
+    return _num_entries;
+  }
 
-  if ( ex_max == ex0 )
+private:
+  void place( const entry& e )
   {
-    cost = ex1 + ex2;
-    decomp = pkrm_decomposition::positive_davio;
+    const auto mask = _table.size() - 1u;
+    auto i = e.hash & mask;
+    while ( _table[i].occupied )
+    {
+      i = ( i + 1u ) & mask;
+    }
+    _table[i] = e;
   }
-  else if ( ex_max == ex1 )
+
+  void grow()
   {
-    cost = ex0 + ex2;
-    decomp = pkrm_decomposition::negative_davio;
+    std::vector<entry> old( 2u * _table.size() );
+    std::swap( old, _table );
+    for ( const auto& e : old )
+    {
+      if ( e.occupied )
+      {
+        place( e );
+      }
+    }
   }
-  else
+
+private:
+  std::vector<entry> _table;
+  std::vector<uint64_t> _arena;
+  uint64_t _num_entries{ 0u };
+};
+
+/* Map from cubes to values stored in an open addressing table with linear
+   probing; erased entries are removed by backward shift deletion, such that
+   no tombstones accumulate. */
+template<typename Value>
+class cube_hash_map
+{
+  struct slot
+  {
+    cube key;
+    Value value{};
+    bool occupied{ false };
+  };
+
+public:
+  cube_hash_map() : _table( 64u ) {}
+
+  Value* find( const cube& key )
   {
-    cost = ex0 + ex1;
-    decomp = pkrm_decomposition::shannon;
+    const auto mask = _table.size() - 1u;
+    for ( auto i = index_of( key );; i = ( i + 1u ) & mask )
+    {
+      if ( !_table[i].occupied )
+      {
+        return nullptr;
+      }
+      if ( _table[i].key == key )
+      {
+        return &_table[i].value;
+      }
+    }
   }
-  cache.insert( { tt, { cost, decomp } } );
-  return cost;
-}
 
-inline void add_to_cubes( std::unordered_set<cube, hash<cube>>& pkrm, const cube& c, bool distance_one_merging = true )
+  /* key must not be contained */
+  void insert( const cube& key, const Value& value )
+  {
+    if ( 2u * ( _num_entries + 1u ) > _table.size() )
+    {
+      std::vector<slot> old( 2u * _table.size() );
+      std::swap( old, _table );
+      for ( const auto& s : old )
+      {
+        if ( s.occupied )
+        {
+          place( s.key, s.value );
+        }
+      }
+    }
+    place( key, value );
+    ++_num_entries;
+  }
+
+  bool erase( const cube& key )
+  {
+    const auto mask = _table.size() - 1u;
+    auto i = index_of( key );
+    while ( true )
+    {
+      if ( !_table[i].occupied )
+      {
+        return false;
+      }
+      if ( _table[i].key == key )
+      {
+        break;
+      }
+      i = ( i + 1u ) & mask;
+    }
+
+    auto j = i;
+    while ( true )
+    {
+      j = ( j + 1u ) & mask;
+      if ( !_table[j].occupied )
+      {
+        break;
+      }
+      /* move entry at j into the hole at i if its home slot is not in (i, j] */
+      const auto home = index_of( _table[j].key );
+      if ( ( ( j - home ) & mask ) >= ( ( j - i ) & mask ) )
+      {
+        _table[i] = _table[j];
+        i = j;
+      }
+    }
+    _table[i].occupied = false;
+    --_num_entries;
+    return true;
+  }
+
+  template<typename Fn>
+  void foreach_entry( Fn&& fn ) const
+  {
+    for ( const auto& s : _table )
+    {
+      if ( s.occupied )
+      {
+        fn( s.key, s.value );
+      }
+    }
+  }
+
+  uint64_t size() const
+  {
+    return _num_entries;
+  }
+
+private:
+  inline uint64_t index_of( const cube& c ) const
+  {
+    return hash_block( c._value * UINT64_C( 0x9e3779b97f4a7c15 ) ) & ( _table.size() - 1u );
+  }
+
+  void place( const cube& key, const Value& value )
+  {
+    const auto mask = _table.size() - 1u;
+    auto i = index_of( key );
+    while ( _table[i].occupied )
+    {
+      i = ( i + 1u ) & mask;
+    }
+    _table[i].key = key;
+    _table[i].value = value;
+    _table[i].occupied = true;
+  }
+
+private:
+  std::vector<slot> _table;
+  uint64_t _num_entries{ 0u };
+};
+
+/* Set of cubes of an ESOP.  Adding a cube that is contained removes it, since
+   it cancels, and adding a cube that has distance 1 to a contained cube
+   merges both.  The neighbors with distance 1 are found by hash lookups for
+   each variable. */
+class esop_cube_set
 {
-  /* first check whether cube is already contained; if so, delete it */
-  const auto it = pkrm.find( c );
-  if ( it != pkrm.end() )
+public:
+  explicit esop_cube_set( uint32_t num_vars )
+      : _num_vars( num_vars )
   {
-    pkrm.erase( it );
-    return;
   }
 
-  /* otherwise, check if there is a distance-1 cube; if so, merge it */
-  if ( distance_one_merging )
+  void add( const cube& c, bool distance_one_merging = true )
   {
-    for ( auto it = pkrm.begin(); it != pkrm.end(); ++it )
+    if ( _cubes.erase( c ) )
+    {
+      return;
+    }
+
+    if ( distance_one_merging )
     {
-      if ( c.distance( *it ) == 1 )
+      for ( auto v = 0u; v < _num_vars; ++v )
       {
-        auto new_cube = c.merge( *it );
-        pkrm.erase( it );
-        add_to_cubes( pkrm, new_cube );
-        return;
+        auto n1 = c, n2 = c;
+        if ( c.get_mask( v ) )
+        {
+          n1.flip_bit( v );
+          n2.remove_literal( v );
+        }
+        else
+        {
+          n1.add_literal( v, false );
+          n2.add_literal( v, true );
+        }
+
+        for ( const auto& n : { n1, n2 } )
+        {
+          if ( _cubes.erase( n ) )
+          {
+            add( c.merge( n ) );
+            return;
+          }
+        }
       }
     }
+
+    _cubes.insert( c, true );
   }
 
-  /* otherwise, just add the cube */
-  pkrm.insert( c );
-}
+  std::vector<cube> cubes() const
+  {
+    std::vector<cube> result;
+    result.reserve( _cubes.size() );
+    _cubes.foreach_entry( [&]( const auto& c, auto ) { result.push_back( c ); } );
+    return result;
+  }
+
+private:
+  uint32_t _num_vars;
+  cube_hash_map<bool> _cubes;
+};
 
-inline cube with_literal( const cube& c, uint8_t var_index, bool polarity )
+/* Computes optimum PKRM expansions, in which each node chooses among the
+   positive Davio, negative Davio, and Shannon decomposition.  The variables
+   are expanded from the top-most one, such that the cofactors of a function
+   over k > 6 variables are the two halves of its words.  The XOR of both
+   cofactors is stored in a buffer per level, which is not overwritten by
+   the recursive calls on lower levels. */
+class pkrm_solver
 {
-  auto copy = c;
-  copy.add_literal( var_index, polarity );
-  return copy;
-}
+public:
+  explicit pkrm_solver( uint32_t num_vars )
+      : _buffers( num_vars + 1u )
+  {
+    for ( auto k = 7u; k <= num_vars; ++k )
+    {
+      _buffers[k].resize( pkrm_num_words( k - 1u ) );
+    }
+  }
 
-template<typename TT>
-void optimum_pkrm_rec( std::unordered_set<cube, hash<cube>>& pkrm, const TT& tt, const expansion_cache<TT>& cache, uint8_t var_index, const cube& c )
+  uint32_t cost( const uint64_t* f, uint32_t k )
+  {
+    if ( k <= 6u )
+    {
+      return cost_word( *f & pkrm_word_mask( k ), k );
+    }
+
+    const auto num_words = pkrm_num_words( k );
+    if ( std::all_of( f, f + num_words, []( auto w ) { return w == 0u; } ) )
+    {
+      return 0u;
+    }
+    if ( std::all_of( f, f + num_words, []( auto w ) { return w == ~uint64_t( 0 ); } ) )
+    {
+      return 1u;
+    }
+
+    const auto h = pkrm_cache::hash_of( f, k );
+    if ( const auto* e = _cache.find( f, k, h ); e != nullptr )
+    {
+      return e->cost;
+    }
+
+    const auto half = num_words >> 1u;
+    auto* x = _buffers[k].data();
+    for ( auto i = 0u; i < half; ++i )
+    {
+      x[i] = f[i] ^ f[half + i];
+    }
+
+    const auto ex0 = cost( f, k - 1u );
+    const auto ex1 = cost( f + half, k - 1u );
+    const auto ex2 = cost( x, k - 1u );
+    const auto [c, decomposition] = choose_pkrm_decomposition( ex0, ex1, ex2 );
+    _cache.insert( f, k, h, c, decomposition );
+    return c;
+  }
+
+  void emit( const uint64_t* f, uint32_t k, const cube& c, esop_cube_set& cubes )
+  {
+    if ( k <= 6u )
+    {
+      emit_word( *f & pkrm_word_mask( k ), k, c, cubes );
+      return;
+    }
+
+    const auto num_words = pkrm_num_words( k );
+    if ( std::all_of( f, f + num_words, []( auto w ) { return w == 0u; } ) )
+    {
+      return;
+    }
+    if ( std::all_of( f, f + num_words, []( auto w ) { return w == ~uint64_t( 0 ); } ) )
+    {
+      cubes.add( c );
+      return;
+    }
+
+    const auto half = num_words >> 1u;
+    auto* x = _buffers[k].data();
+    for ( auto i = 0u; i < half; ++i )
+    {
+      x[i] = f[i] ^ f[half + i];
+    }
+    emit_children<const uint64_t*>( _cache.find( f, k, pkrm_cache::hash_of( f, k ) )->decomposition, f, f + half, x, k, c, cubes );
+  }
+
+private:
+  static cube with_literal( const cube& c, uint32_t var_index, bool polarity )
+  {
+    auto copy = c;
+    copy.add_literal( static_cast<uint8_t>( var_index ), polarity );
+    return copy;
+  }
+
+  template<typename Child>
+  void emit_children( pkrm_decomposition decomposition, Child f0, Child f1, Child x, uint32_t k, const cube& c, esop_cube_set& cubes )
+  {
+    const auto var_index = k - 1u;
+    switch ( decomposition )
+    {
+    case pkrm_decomposition::positive_davio:
+      emit_child( f0, var_index, c, cubes );
+      emit_child( x, var_index, with_literal( c, var_index, true ), cubes );
+      break;
+    case pkrm_decomposition::negative_davio:
+      emit_child( f1, var_index, c, cubes );
+      emit_child( x, var_index, with_literal( c, var_index, false ), cubes );
+      break;
+    case pkrm_decomposition::shannon:
+      emit_child( f0, var_index, with_literal( c, var_index, false ), cubes );
+      emit_child( f1, var_index, with_literal( c, var_index, true ), cubes );
+      break;
+    }
+  }
+
+  void emit_child( const uint64_t* f, uint32_t k, const cube& c, esop_cube_set& cubes )
+  {
+    emit( f, k, c, cubes );
+  }
+
+  void emit_child( uint64_t f, uint32_t k, const cube& c, esop_cube_set& cubes )
+  {
+    emit_word( f, k, c, cubes );
+  }
+
+  uint32_t cost_word( uint64_t f, uint32_t k )
+  {
+    if ( f == 0u )
+    {
+      return 0u;
+    }
+    if ( f == pkrm_word_mask( k ) )
+    {
+      return 1u;
+    }
+
+    const auto h = pkrm_cache::hash_of( &f, k );
+    if ( const auto* e = _cache.find( &f, k, h ); e != nullptr )
+    {
+      return e->cost;
+    }
+
+    const auto f0 = f & pkrm_word_mask( k - 1u );
+    const auto f1 = f >> ( 1u << ( k - 1u ) );
+    const auto [c, decomposition] = choose_pkrm_decomposition( cost_word( f0, k - 1u ), cost_word( f1, k - 1u ), cost_word( f0 ^ f1, k - 1u ) );
+    _cache.insert( &f, k, h, c, decomposition );
+    return c;
+  }
+
+  void emit_word( uint64_t f, uint32_t k, const cube& c, esop_cube_set& cubes )
+  {
+    if ( f == 0u )
+    {
+      return;
+    }
+    if ( f == pkrm_word_mask( k ) )
+    {
+      cubes.add( c );
+      return;
+    }
+
+    const auto f0 = f & pkrm_word_mask( k - 1u );
+    const auto f1 = f >> ( 1u << ( k - 1u ) );
+    emit_children( _cache.find( &f, k, pkrm_cache::hash_of( &f, k ) )->decomposition, f0, f1, f0 ^ f1, k, c, cubes );
+  }
+
+private:
+  pkrm_cache _cache;
+  std::vector<std::vector<uint64_t>> _buffers;
+};
+
+/* Splits the top-most variables into a tree of sub-functions, whose optimum
+   expansions are computed in parallel by independent solvers. */
+class parallel_pkrm_impl
 {
-  /* terminal cases */
-  if ( is_const0( tt ) )
+  struct node
   {
-    return;
+    std::vector<uint64_t> words;
+    uint32_t num_vars{ 0u };
+    int32_t children[3]{ -1, -1, -1 }; /* f0, f1, f0 ^ f1 */
+    uint32_t cost{ 0u };
+    pkrm_decomposition decomposition{ pkrm_decomposition::positive_davio };
+    std::unique_ptr<pkrm_solver> solver;
+  };
+
+public:
+  parallel_pkrm_impl( const uint64_t* words, uint32_t num_vars, const pkrm_params& ps )
+      : _ps( ps )
+  {
+    split( std::vector<uint64_t>( words, words + pkrm_num_words( num_vars ) ), num_vars, ps.parallel_depth );
   }
-  if ( is_const0( ~tt ) )
+
+  std::vector<cube> run()
   {
-    add_to_cubes( pkrm, c );
-    return;
+    {
+      work_stealing_pool pool( _ps.num_threads );
+      task_group group;
+      for ( auto& n : _nodes )
+      {
+        if ( n.children[0] == -1 )
+        {
+          pool.submit( group, [&n]() {
+            n.solver = std::make_unique<pkrm_solver>( n.num_vars );
+            n.cost = n.solver->cost( n.words.data(), n.num_vars );
+          } );
+        }
+      }
+      pool.wait( group );
+    }
+
+    /* children are created after their parents */
+    for ( auto i = static_cast<int32_t>( _nodes.size() ) - 1; i >= 0; --i )
+    {
+      auto& n = _nodes[i];
+      if ( n.children[0] != -1 )
+      {
+        std::tie( n.cost, n.decomposition ) = choose_pkrm_decomposition( _nodes[n.children[0]].cost, _nodes[n.children[1]].cost, _nodes[n.children[2]].cost );
+      }
+    }
+
+    esop_cube_set cubes( _nodes.front().num_vars );
+    emit( 0, cube(), cubes );
+    return cubes.cubes();
+  }
+
+private:
+  int32_t split( std::vector<uint64_t> words, uint32_t num_vars, uint32_t depth )
+  {
+    const auto index = static_cast<int32_t>( _nodes.size() );
+    _nodes.emplace_back();
+    _nodes.back().words = std::move( words );
+    _nodes.back().num_vars = num_vars;
+    if ( depth == 0u || num_vars <= 7u )
+    {
+      return index;
+    }
+
+    const auto& w = _nodes[index].words;
+    const auto half = w.size() >> 1u;
+    std::vector<uint64_t> f0( w.begin(), w.begin() + half ), f1( w.begin() + half, w.end() ), x( half );
+    for ( auto i = 0u; i < half; ++i )
+    {
+      x[i] = f0[i] ^ f1[i];
+    }
+    const auto c0 = split( std::move( f0 ), num_vars - 1u, depth - 1u );
+    const auto c1 = split( std::move( f1 ), num_vars - 1u, depth - 1u );
+    const auto c2 = split( std::move( x ), num_vars - 1u, depth - 1u );
+    _nodes[index].children[0] = c0;
+    _nodes[index].children[1] = c1;
+    _nodes[index].children[2] = c2;
+    return index;
   }
 
-  const auto& p = cache.at( tt );
+  void emit( int32_t index, const cube& c, esop_cube_set& cubes )
+  {
+    auto& n = _nodes[index];
+    if ( n.children[0] == -1 )
+    {
+      n.solver->emit( n.words.data(), n.num_vars, c, cubes );
+      return;
+    }
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+    const auto var_index = static_cast<uint8_t>( n.num_vars - 1u );
+    auto with_literal = [&]( bool polarity ) {
+      auto copy = c;
+      copy.add_literal( var_index, polarity );
+      return copy;
+    };
 
-  switch ( p.second )
-  {
-  case pkrm_decomposition::positive_davio:
-    optimum_pkrm_rec( pkrm, tt0, cache, var_index + 1, c );
-    optimum_pkrm_rec( pkrm, tt0 ^ tt1, cache, var_index + 1, with_literal( c, var_index, true ) );
-    break;
-  case pkrm_decomposition::negative_davio:
-    optimum_pkrm_rec( pkrm, tt1, cache, var_index + 1, c );
-    optimum_pkrm_rec( pkrm, tt0 ^ tt1, cache, var_index + 1, with_literal( c, var_index, false ) );
-    break;
-  case pkrm_decomposition::shannon:
-    optimum_pkrm_rec( pkrm, tt0, cache, var_index + 1, with_literal( c, var_index, false ) );
-    optimum_pkrm_rec( pkrm, tt1, cache, var_index + 1, with_literal( c, var_index, true ) );
-    break;
+    switch ( n.decomposition )
+    {
+    case pkrm_decomposition::positive_davio:
+      emit( n.children[0], c, cubes );
+      emit( n.children[2], with_literal( true ), cubes );
+      break;
+    case pkrm_decomposition::negative_davio:
+      emit( n.children[1], c, cubes );
+      emit( n.children[2], with_literal( false ), cubes );
+      break;
+    case pkrm_decomposition::shannon:
+      emit( n.children[0], with_literal( false ), cubes );
+      emit( n.children[1], with_literal( true ), cubes );
+      break;
+    }
   }
-}
+
+private:
+  const pkrm_params& _ps;
+  std::vector<node> _nodes;
+};
 
 template<typename TT>
-void esop_from_pprm_rec( std::unordered_set<cube, hash<cube>>& cubes, const TT& tt, uint8_t var_index, const cube& c )
+void esop_from_pprm_rec( esop_cube_set& cubes, const TT& tt, uint8_t var_index, const cube& c )
 {
   /* terminal cases */
   if ( is_const0( tt ) )
@@ -200,121 +698,152 @@ void esop_from_pprm_rec( std::unordered_set<cube, hash<cube>>& cubes, const TT&
   if ( is_const0( ~tt ) )
   {
     /* add to cubes, but do not apply distance-1 merging */
-    add_to_cubes( cubes, c, false );
+    cubes.add( c, false );
     return;
   }
 
   const auto tt0 = cofactor0( tt, var_index );
   const auto tt1 = cofactor1( tt, var_index );
 
+  auto c1 = c;
+  c1.add_literal( var_index, true );
   esop_from_pprm_rec( cubes, tt0, var_index + 1, c );
-  esop_from_pprm_rec( cubes, tt0 ^ tt1, var_index + 1, with_literal( c, var_index, true ) );
+  esop_from_pprm_rec( cubes, tt0 ^ tt1, var_index + 1, c1 );
 }
 
-static constexpr uint64_t ANF1[] = { 0, 3, 2, 1 };
-static constexpr uint64_t ANF2[] = { 0, 15, 10, 5, 12, 3, 6, 9, 8, 7, 2, 13, 4, 11, 14, 1 };
-static constexpr uint64_t ANF3[] = { 0, 255, 170, 85, 204, 51, 102, 153, 136, 119, 34, 221, 68, 187, 238, 17, 240, 15, 90, 165, 60, 195, 150, 105, 120, 135, 210, 45, 180, 75, 30, 225, 160, 95, 10, 245, 108, 147, 198, 57, 40, 215, 130, 125, 228, 27, 78, 177, 80, 175, 250, 5, 156, 99, 54, 201, 216, 39, 114, 141, 20, 235, 190, 65, 192, 63, 106, 149, 12, 243, 166, 89, 72, 183, 226, 29, 132, 123, 46, 209, 48, 207, 154, 101, 252, 3, 86, 169, 184, 71, 18, 237, 116, 139, 222, 33, 96, 159, 202, 53, 172, 83, 6, 249, 232, 23, 66, 189, 36, 219, 142, 113, 144, 111, 58, 197, 92, 163, 246, 9, 24, 231, 178, 77, 212, 43, 126, 129, 128, 127, 42, 213, 76, 179, 230, 25, 8, 247, 162, 93, 196, 59, 110, 145, 112, 143, 218, 37, 188, 67, 22, 233, 248, 7, 82, 173, 52, 203, 158, 97, 32, 223, 138, 117, 236, 19, 70, 185, 168, 87, 2, 253, 100, 155, 206, 49, 208, 47, 122, 133, 28, 227, 182, 73, 88, 167, 242, 13, 148, 107, 62, 193, 64, 191, 234, 21, 140, 115, 38, 217, 200, 55, 98, 157, 4, 251, 174, 81, 176, 79, 26, 229, 124, 131, 214, 41, 56, 199, 146, 109, 244, 11, 94, 161, 224, 31, 74, 181, 44, 211, 134, 121, 104, 151, 194, 61, 164, 91, 14, 241, 16, 239, 186, 69, 220, 35, 118, 137, 152, 103, 50, 205, 84, 171, 254, 1 };
+/* Moebius transform of the low min(num_vars, 6) variables inside a word */
+inline uint64_t anf_word( uint64_t word, uint32_t num_vars )
+{
+  for ( auto i = 0u; i < std::min( num_vars, 6u ); ++i )
+  {
+    word ^= ( word & projections_neg[i] ) << ( 1u << i );
+  }
+  return word;
+}
 
-template<class TT>
-TT algebraic_normal_form( const TT& func )
+/* block butterflies for variables 6 + log2(distance), ...: the upper half of
+   each block of 2 * distance words is XORed with its lower half */
+inline void anf_blocks( uint64_t* words, uint64_t num_words, uint64_t distance )
+{
+  for ( uint64_t j = 0u; j < num_words; j += distance << 1u )
+  {
+    const auto* lo = words + j;
+    auto* hi = words + j + distance;
+    for ( uint64_t k = 0u; k < distance; ++k )
+    {
+      hi[k] ^= lo[k];
+    }
+  }
+}
+
+/* Moebius transform of all variables on a chunk of words, which fits into the
+   cache, such that all in-chunk levels are applied while it is loaded */
+inline void anf_chunk( uint64_t* words, uint64_t num_words, uint32_t num_vars )
 {
-  switch ( func.num_vars() )
-  {
-  case 0:
-    return func;
-  case 1:
-  {
-    auto r = func.construct();
-    kitty::create_from_words( r, &ANF1[*func.begin()], &ANF1[*func.begin()] + 1 );
-    return r;
-  }
-  case 2:
-  {
-    auto r = func.construct();
-    kitty::create_from_words( r, &ANF2[*func.begin()], &ANF2[*func.begin()] + 1 );
-    return r;
-  }
-  case 3:
-  {
-    auto r = func.construct();
-    kitty::create_from_words( r, &ANF3[*func.begin()], &ANF3[*func.begin()] + 1 );
-    return r;
-  }
-  case 4:
-    return unary_operation( func, []( uint64_t word )
-                            {
-      const auto b0 = ANF3[word & 0x000000FF];
-      const auto b1 = ANF3[( word & 0x0000FF00 ) >> 8];
-
-      return b0 | ( ( b0 ^ b1 ) << 8 ); } );
-  case 5:
-    return unary_operation( func, []( uint64_t word )
-                            {
-      const auto b0 = ANF3[word & 0xFF];
-      const auto b1 = ANF3[( word >> 010 ) & 0xFF];
-      const auto b2 = ANF3[( word >> 020 ) & 0xFF];
-      const auto b3 = ANF3[( word >> 030 ) & 0xFF];
-
-      return b0 | ( ( b0 ^ b1 ) << 010 ) | ( ( b0 ^ b2 ) << 020 ) | ( ( b0 ^ b1 ^ b2 ^ b3 ) << 030 ); } );
-  default:
-    auto r = unary_operation( func, []( uint64_t word )
-                              {
-      const auto b0 = ANF3[word & 0xFF];
-      const auto b1 = ANF3[( word >> 010 ) & 0xFF];
-      const auto b2 = ANF3[( word >> 020 ) & 0xFF];
-      const auto b3 = ANF3[( word >> 030 ) & 0xFF];
-      const auto b4 = ANF3[( word >> 040 ) & 0xFF];
-      const auto b5 = ANF3[( word >> 050 ) & 0xFF];
-      const auto b6 = ANF3[( word >> 060 ) & 0xFF];
-      const auto b7 = ANF3[( word >> 070 ) & 0xFF];
-
-      return b0 |
-             ( ( b0 ^ b1 ) << 010 ) |
-             ( ( b0 ^ b2 ) << 020 ) |
-             ( ( b0 ^ b1 ^ b2 ^ b3 ) << 030 ) |
-             ( ( b0 ^ b4 ) << 040 ) |
-             ( ( b0 ^ b1 ^ b4 ^ b5 ) << 050 ) |
-             ( ( b0 ^ b2 ^ b4 ^ b6 ) << 060 ) |
-             ( ( b0 ^ b1 ^ b2 ^ b3 ^ b4 ^ b5 ^ b6 ^ b7 ) << 070 ); } );
-
-    for ( auto i = 1u; i < (uint32_t)func.num_blocks(); i = i << 1u )
-    {
-      for ( auto j = 0u; j < (uint32_t)func.num_blocks(); j += i << 1u )
+  for ( uint64_t i = 0u; i < num_words; ++i )
+  {
+    words[i] = anf_word( words[i], num_vars );
+  }
+  for ( uint64_t distance = 1u; distance < num_words; distance <<= 1u )
+  {
+    anf_blocks( words, num_words, distance );
+  }
+}
+
+/* in-place Moebius transform of a truth table given as array of words */
+inline void anf_inplace( uint64_t* words, uint64_t num_words, uint32_t num_vars, uint32_t num_threads )
+{
+  /* 4096 words (32 KB) per chunk */
+  const auto chunk_size = std::min<uint64_t>( num_words, 4096u );
+  const auto num_chunks = num_words / chunk_size;
+
+  if ( num_threads == 1u || num_chunks == 1u )
+  {
+    for ( uint64_t c = 0u; c < num_words; c += chunk_size )
+    {
+      anf_chunk( words + c, chunk_size, num_vars );
+    }
+    for ( auto distance = chunk_size; distance < num_words; distance <<= 1u )
+    {
+      anf_blocks( words, num_words, distance );
+    }
+    return;
+  }
+
+  work_stealing_pool pool( num_threads );
+  task_group group;
+  for ( uint64_t c = 0u; c < num_words; c += chunk_size )
+  {
+    pool.submit( group, [=]() { anf_chunk( words + c, chunk_size, num_vars ); } );
+  }
+  pool.wait( group );
+
+  /* the pairs of each level are independent; split them into chunks */
+  for ( auto distance = chunk_size; distance < num_words; distance <<= 1u )
+  {
+    for ( uint64_t j = 0u; j < num_words; j += distance << 1u )
+    {
+      for ( uint64_t k = 0u; k < distance; k += chunk_size )
       {
-        for ( auto k = j; k < j + i; ++k )
-        {
-          *( r.begin() + k + i ) ^= *( r.begin() + k );
-        }
+        pool.submit( group, [=]() {
+          const auto* lo = words + j + k;
+          auto* hi = words + j + k + distance;
+          for ( uint64_t i = 0u; i < chunk_size; ++i )
+          {
+            hi[i] ^= lo[i];
+          }
+        } );
       }
     }
-
-    return r;
+    pool.wait( group );
   }
 }
+
+template<class TT>
+TT algebraic_normal_form( const TT& func )
+{
+  auto r = func;
+  anf_inplace( &*r.begin(), static_cast<uint64_t>( r.num_blocks() ), r.num_vars(), 1u );
+  return r;
+}
+
 } // namespace detail
 /*! \endcond */
 
 /*! \brief Computes ESOP representation using optimum PKRM
 
   This algorithm first computes an ESOP using the algorithm described
-  in [R. Drechsler, IEEE Trans. C 48(9), 1999, 987–990].
+  in [R. Drechsler, IEEE Trans. C 48(9), 1999, 987–990].  Variables are
+  expanded starting from the top-most variable, and the optimum expansions of
+  sub-functions are stored in an open addressing table.
 
   The algorithm applies post-optimization to merge distance-1 cubes.
 
+  If more than one thread is used, the expansions of the top-most
+  `ps.parallel_depth` variables are split into independent sub-functions,
+  which are solved in parallel.
+
   \param tt Truth table
+  \param ps Parameters
 */
 template<typename TT>
-inline std::vector<cube> esop_from_optimum_pkrm( const TT& tt )
+inline std::vector<cube> esop_from_optimum_pkrm( const TT& tt, const pkrm_params& ps = {} )
 {
   static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
 
-  std::unordered_set<cube, hash<cube>> cubes;
-  detail::expansion_cache<TT> cache;
+  const auto num_vars = tt.num_vars();
+  const auto* words = &*tt.cbegin();
 
-  detail::find_pkrm_expansions( tt, cache, 0 );
-  detail::optimum_pkrm_rec( cubes, tt, cache, 0, cube() );
+  if ( ps.num_threads != 1u && ps.parallel_depth > 0u && num_vars > 7u )
+  {
+    return detail::parallel_pkrm_impl( words, num_vars, ps ).run();
+  }
 
-  return std::vector<cube>( cubes.begin(), cubes.end() );
+  detail::pkrm_solver solver( num_vars );
+  detail::esop_cube_set cubes( num_vars );
+  solver.cost( words, num_vars );
+  solver.emit( words, num_vars, cube(), cubes );
+  return cubes.cubes();
 }
 
 template<typename TT>
@@ -322,10 +851,9 @@ inline std::vector<cube> esop_from_pprm_slow( const TT& tt )
 {
   static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
 
-  std::unordered_set<cube, hash<cube>> cubes;
+  detail::esop_cube_set cubes( tt.num_vars() );
   detail::esop_from_pprm_rec( cubes, tt, 0, cube() );
-
-  return std::vector<cube>( cubes.begin(), cubes.end() );
+  return cubes.cubes();
 }
 
 /*! \brief Computes PPRM representation for a function
@@ -346,4 +874,30 @@ std::vector<cube> esop_from_pprm( const TT& func )
   return cubes;
 }
 
-} // namespace kitty
\ No newline at end of file
+/*! \brief Computes the algebraic normal form in place
+
+  Replaces the truth table by its algebraic normal form (ANF), in which bit
+  \f$i\f$ is set if and only if the monomial of the variables in \f$i\f$
+  occurs in the positive polarity Reed-Muller expression of the function.
+  The transformation is an involution, i.e., applying it on an ANF yields
+  the function.
+
+  The Moebius transform for the lowest 6 variables is computed with masked
+  shifts inside each word, and the transform of the other variables by XOR of
+  blocks of words.  The table is processed in chunks of 32 KB first, such
+  that the levels inside a chunk are applied while it is in cache.  With
+  more than one thread, chunks and the block XORs of each remaining level
+  are distributed over a thread pool.
+
+  \param tt Truth table
+  \param num_threads Number of threads (0 = number of hardware threads)
+*/
+template<class TT>
+void algebraic_normal_form_inplace( TT& tt, uint32_t num_threads = 1u )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  detail::anf_inplace( &*tt.begin(), static_cast<uint64_t>( tt.num_blocks() ), tt.num_vars(), num_threads );
+}
+
+} // namespace kitty
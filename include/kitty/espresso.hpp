@@ -0,0 +1,442 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file espresso.hpp
+  \brief Heuristic two-level minimization
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "bit_operations.hpp"
+#include "constructors.hpp"
+#include "cube.hpp"
+#include "isop.hpp"
+#include "operations.hpp"
+#include "ternary_truth_table.hpp"
+#include "traits.hpp"
+
+namespace kitty
+{
+
+/*! \brief Parameters for espresso */
+struct espresso_params
+{
+  /*! Maximum number of EXPAND/IRREDUNDANT/REDUCE iterations (0 = until no gain). */
+  uint32_t max_iterations{ 0u };
+};
+
+/*! \brief Statistics for espresso */
+struct espresso_stats
+{
+  /*! Number of cubes in the initial ISOP. */
+  uint32_t initial_cubes{ 0u };
+
+  /*! Number of literals in the initial ISOP. */
+  uint32_t initial_literals{ 0u };
+
+  /*! Number of cubes in the result. */
+  uint32_t cubes{ 0u };
+
+  /*! Number of literals in the result. */
+  uint32_t literals{ 0u };
+
+  /*! Number of iterations. */
+  uint32_t iterations{ 0u };
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* checks whether cube a contains cube b */
+inline bool cube_contains( const cube& a, const cube& b )
+{
+  return ( a._mask & ~b._mask ) == 0u && ( ( a._bits ^ b._bits ) & a._mask ) == 0u;
+}
+
+inline uint32_t count_literals( const std::vector<cube>& cubes )
+{
+  return std::accumulate( cubes.begin(), cubes.end(), 0u, []( auto sum, const auto& c ) { return sum + c.num_literals(); } );
+}
+
+template<typename TT>
+class espresso_impl
+{
+public:
+  espresso_impl( const TT& on, const TT& dc, const espresso_params& ps, espresso_stats& st )
+      : _on( on ),
+        _dc( dc ),
+        _off( ~( on | dc ) ),
+        _num_vars( on.num_vars() ),
+        _ps( ps ),
+        _st( st )
+  {
+    for ( auto i = 0u; i < _num_vars; ++i )
+    {
+      _vars.emplace_back( on.construct() );
+      create_nth_var( _vars.back(), i );
+    }
+  }
+
+  std::vector<cube> run()
+  {
+    std::vector<cube> cubes;
+    detail::isop_rec( _on, _on | _dc, _num_vars, cubes );
+    _st.initial_cubes = static_cast<uint32_t>( cubes.size() );
+    _st.initial_literals = count_literals( cubes );
+
+    _cover = cubes;
+    compute_tables();
+
+    auto best = cubes;
+    auto best_cost = cost( cubes );
+    for ( auto iteration = 0u; _ps.max_iterations == 0u || iteration < _ps.max_iterations; ++iteration )
+    {
+      ++_st.iterations;
+
+      expand();
+      irredundant();
+
+      const auto c = cost( _cover );
+      if ( c < best_cost )
+      {
+        best = _cover;
+        best_cost = c;
+      }
+      else if ( iteration > 0u )
+      {
+        break;
+      }
+
+      reduce();
+    }
+
+    _st.cubes = static_cast<uint32_t>( best.size() );
+    _st.literals = count_literals( best );
+    return best;
+  }
+
+private:
+  using cost_t = std::pair<uint64_t, uint64_t>;
+
+  static cost_t cost( const std::vector<cube>& cubes )
+  {
+    return { cubes.size(), count_literals( cubes ) };
+  }
+
+  TT cube_table( const cube& c ) const
+  {
+    auto t = ~_on.construct();
+    for ( auto i = 0u; i < _num_vars; ++i )
+    {
+      if ( c.get_mask( i ) )
+      {
+        t &= c.get_bit( i ) ? _vars[i] : ~_vars[i];
+      }
+    }
+    return t;
+  }
+
+  void compute_tables()
+  {
+    _tables.clear();
+    for ( const auto& c : _cover )
+    {
+      _tables.emplace_back( cube_table( c ) );
+    }
+  }
+
+  void remove_cube( uint32_t index )
+  {
+    _cover.erase( _cover.begin() + index );
+    _tables.erase( _tables.begin() + index );
+  }
+
+  /* expands each cube into a prime, removes cubes that become contained */
+  void expand()
+  {
+    /* expand small cubes first, they are likely to be covered by others */
+    std::vector<uint32_t> order( _cover.size() );
+    std::iota( order.begin(), order.end(), 0u );
+    std::stable_sort( order.begin(), order.end(), [&]( auto a, auto b ) { return _cover[a].num_literals() > _cover[b].num_literals(); } );
+
+    std::vector<bool> removed( _cover.size(), false );
+    for ( auto i : order )
+    {
+      if ( removed[i] )
+      {
+        continue;
+      }
+
+      auto& c = _cover[i];
+      auto& t = _tables[i];
+
+      while ( true )
+      {
+        /* among all literals that can be removed without intersecting the off-set,
+           choose the one with which the cube contains most other cubes */
+        auto best_var = -1;
+        auto best_gain = -1;
+        TT best_table;
+        for ( auto v = 0u; v < _num_vars; ++v )
+        {
+          if ( !c.get_mask( v ) )
+          {
+            continue;
+          }
+
+          auto e = t;
+          flip_inplace( e, v );
+          e |= t;
+          if ( !is_const0( e & _off ) )
+          {
+            continue;
+          }
+
+          auto ce = c;
+          ce.remove_literal( v );
+          auto gain = 0;
+          for ( auto j = 0u; j < _cover.size(); ++j )
+          {
+            if ( j != i && !removed[j] && cube_contains( ce, _cover[j] ) )
+            {
+              ++gain;
+            }
+          }
+          if ( gain > best_gain )
+          {
+            best_var = static_cast<int>( v );
+            best_gain = gain;
+            best_table = e;
+          }
+        }
+
+        if ( best_var == -1 )
+        {
+          break;
+        }
+        c.remove_literal( best_var );
+        t = best_table;
+      }
+
+      for ( auto j = 0u; j < _cover.size(); ++j )
+      {
+        if ( j != i && !removed[j] && cube_contains( c, _cover[j] ) )
+        {
+          removed[j] = true;
+        }
+      }
+    }
+
+    for ( auto i = static_cast<int>( _cover.size() ) - 1; i >= 0; --i )
+    {
+      if ( removed[i] )
+      {
+        remove_cube( i );
+      }
+    }
+  }
+
+  /* computes care minterms covered by exactly one cube */
+  TT covered_once() const
+  {
+    auto once = _on.construct();
+    auto twice = _on.construct();
+    for ( const auto& t : _tables )
+    {
+      twice |= once & t;
+      once |= t;
+    }
+    return once & ~twice & ~_dc;
+  }
+
+  /* removes cubes that are covered by other cubes and the don't cares */
+  void irredundant()
+  {
+    /* try to remove large cubes last */
+    while ( true )
+    {
+      const auto once = covered_once();
+
+      auto candidate = -1;
+      for ( auto i = 0u; i < _cover.size(); ++i )
+      {
+        if ( is_const0( _tables[i] & once ) &&
+             ( candidate == -1 || _cover[i].num_literals() > _cover[candidate].num_literals() ) )
+        {
+          candidate = static_cast<int>( i );
+        }
+      }
+
+      if ( candidate == -1 )
+      {
+        break;
+      }
+      remove_cube( candidate );
+    }
+  }
+
+  /* replaces each cube by the smallest cube that contains the minterms that
+     are only covered by this cube */
+  void reduce()
+  {
+    std::vector<uint32_t> order( _cover.size() );
+    std::iota( order.begin(), order.end(), 0u );
+    std::stable_sort( order.begin(), order.end(), [&]( auto a, auto b ) { return _cover[a].num_literals() < _cover[b].num_literals(); } );
+
+    std::vector<bool> removed( _cover.size(), false );
+    for ( auto i : order )
+    {
+      auto others = _dc;
+      for ( auto j = 0u; j < _cover.size(); ++j )
+      {
+        if ( j != i && !removed[j] )
+        {
+          others |= _tables[j];
+        }
+      }
+
+      const auto rest = _tables[i] & ~others;
+      if ( is_const0( rest ) )
+      {
+        removed[i] = true;
+        continue;
+      }
+
+      /* supercube of the remaining minterms */
+      cube c;
+      for ( auto v = 0u; v < _num_vars; ++v )
+      {
+        if ( is_const0( rest & ~_vars[v] ) )
+        {
+          c.add_literal( v, true );
+        }
+        else if ( is_const0( rest & _vars[v] ) )
+        {
+          c.add_literal( v, false );
+        }
+      }
+      _cover[i] = c;
+      _tables[i] = cube_table( c );
+    }
+
+    for ( auto i = static_cast<int>( _cover.size() ) - 1; i >= 0; --i )
+    {
+      if ( removed[i] )
+      {
+        remove_cube( i );
+      }
+    }
+  }
+
+private:
+  TT _on;
+  TT _dc;
+  TT _off;
+  uint32_t _num_vars;
+  const espresso_params& _ps;
+  espresso_stats& _st;
+
+  std::vector<TT> _vars;
+  std::vector<cube> _cover;
+  std::vector<TT> _tables;
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Heuristic two-level minimization
+
+  Computes a sum-of-products representation with few cubes and literals for
+  an incompletely specified function, following the EXPAND, IRREDUNDANT, and
+  REDUCE loop of Espresso [R. K. Brayton, G. D. Hachtel, C. McMullen, and
+  A. Sangiovanni-Vincentelli, Logic Minimization Algorithms for VLSI
+  Synthesis, 1984].  The ISOP is used as initial cover.
+
+  - EXPAND removes literals from each cube as long as the cube does not
+    intersect the off-set, preferring literals that make the cube contain
+    other cubes of the cover, which are then removed.
+  - IRREDUNDANT removes cubes whose care minterms are covered by other cubes.
+  - REDUCE replaces each cube by the smallest cube that contains the minterms
+    that are not covered by other cubes or the don't cares.
+
+  The loop terminates when the number of cubes and literals does not
+  decrease.  Cube containment is checked on the cube bitmasks, off-set
+  intersection and tautology checks of the covering are performed on the
+  truth tables of the cubes.
+
+  \param on Truth table of onset
+  \param dc Truth table of don't care set
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<cube> espresso( const TT& on, const TT& dc, const espresso_params& ps = {}, espresso_stats* pst = nullptr )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+  assert( on.num_vars() <= 32 );
+
+  espresso_stats st;
+  const auto cubes = detail::espresso_impl<TT>( on & ~dc, dc, ps, st ).run();
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return cubes;
+}
+
+/*! \brief Heuristic two-level minimization of a completely specified function
+
+  \param tt Truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<cube> espresso( const TT& tt, const espresso_params& ps = {}, espresso_stats* pst = nullptr )
+{
+  return espresso( tt, tt.construct(), ps, pst );
+}
+
+/*! \brief Heuristic two-level minimization of a ternary truth table
+
+  \param tt Ternary truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<cube> espresso( const ternary_truth_table<TT>& tt, const espresso_params& ps = {}, espresso_stats* pst = nullptr )
+{
+  return espresso( tt._bits & tt._care, ~tt._care, ps, pst );
+}
+
+} /* namespace kitty */
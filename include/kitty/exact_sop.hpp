@@ -0,0 +1,626 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file exact_sop.hpp
+  \brief Exact two-level minimization
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "bit_operations.hpp"
+#include "cube.hpp"
+#include "detail/mscfix.hpp"
+#include "implicant.hpp"
+#include "operators.hpp"
+#include "ternary_truth_table.hpp"
+#include "traits.hpp"
+
+namespace kitty
+{
+
+/*! \brief Parameters for exact_sop */
+struct exact_sop_params
+{
+  /*! Maximum number of branch-and-bound nodes (0 = no limit); if the limit
+      is reached, the best cover found so far is returned and
+      `exact_sop_stats::optimal` is false. */
+  uint64_t max_nodes{ 1000u };
+};
+
+/*! \brief Statistics for exact_sop */
+struct exact_sop_stats
+{
+  /*! Number of prime implicants that cover care minterms. */
+  uint32_t primes{ 0u };
+
+  /*! Number of care minterms in the onset. */
+  uint32_t minterms{ 0u };
+
+  /*! Number of primes selected as essential at the root. */
+  uint32_t essentials{ 0u };
+
+  /*! Number of branch-and-bound nodes. */
+  uint64_t nodes{ 0u };
+
+  /*! Whether the result is proven to be minimum. */
+  bool optimal{ true };
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* unate covering problem with bitset rows and columns */
+class covering_matrix
+{
+public:
+  using bitset = std::vector<uint64_t>;
+
+  covering_matrix( uint32_t num_rows, std::vector<bitset> cols, std::vector<uint32_t> costs, uint64_t max_nodes )
+      : _num_rows( num_rows ),
+        _num_cols( static_cast<uint32_t>( cols.size() ) ),
+        _row_words( ( num_rows + 63u ) >> 6u ),
+        _col_words( ( _num_cols + 63u ) >> 6u ),
+        _cols( std::move( cols ) ),
+        _rows( num_rows, bitset( _col_words, 0u ) ),
+        _costs( std::move( costs ) ),
+        _max_nodes( max_nodes )
+  {
+    for ( auto c = 0u; c < _num_cols; ++c )
+    {
+      for_each_bit( _cols[c], [&]( auto r ) { set( _rows[r], c ); } );
+    }
+  }
+
+  /* returns selected columns */
+  std::vector<uint32_t> solve( exact_sop_stats& st )
+  {
+    state s;
+    s.rows = full( _num_rows );
+    s.cols = full( _num_cols );
+
+    if ( !reduce( s ) )
+    {
+      return {};
+    }
+    st.essentials = static_cast<uint32_t>( s.chosen.size() );
+
+    _best = greedy( s );
+    _best_cost = cost_of( _best );
+
+    search( s );
+
+    st.nodes = _nodes;
+    st.optimal = _max_nodes == 0u || _nodes < _max_nodes;
+    return _best;
+  }
+
+private:
+  using cost_t = std::pair<uint32_t, uint32_t>; /* number of columns, sum of costs */
+
+  struct state
+  {
+    bitset rows;
+    bitset cols;
+    std::vector<uint32_t> chosen;
+    cost_t cost{ 0u, 0u };
+  };
+
+  static bitset full( uint32_t n )
+  {
+    bitset b( ( n + 63u ) >> 6u, ~uint64_t( 0 ) );
+    if ( n & 63u )
+    {
+      b.back() = ( uint64_t( 1 ) << ( n & 63u ) ) - 1u;
+    }
+    return b;
+  }
+
+  static inline void set( bitset& b, uint32_t i )
+  {
+    b[i >> 6] |= uint64_t( 1 ) << ( i & 63 );
+  }
+
+  static inline void reset( bitset& b, uint32_t i )
+  {
+    b[i >> 6] &= ~( uint64_t( 1 ) << ( i & 63 ) );
+  }
+
+  template<typename Fn>
+  static void for_each_bit( const bitset& b, Fn&& fn )
+  {
+    for ( auto w = 0u; w < b.size(); ++w )
+    {
+      for ( auto word = b[w]; word; word &= word - 1 )
+      {
+        fn( ( w << 6 ) + __builtin_ctzll( word ) );
+      }
+    }
+  }
+
+  /* calls fn for the remaining columns of row r */
+  template<typename Fn>
+  void for_each_col( const state& s, uint32_t r, Fn&& fn ) const
+  {
+    for ( auto i = 0u; i < _col_words; ++i )
+    {
+      for ( auto w = _rows[r][i] & s.cols[i]; w; w &= w - 1 )
+      {
+        fn( ( i << 6 ) + __builtin_ctzll( w ) );
+      }
+    }
+  }
+
+  static uint32_t count_and( const bitset& a, const bitset& b )
+  {
+    uint32_t n = 0u;
+    for ( auto i = 0u; i < a.size(); ++i )
+    {
+      const auto w = a[i] & b[i];
+      n += __builtin_popcount( w & 0xffffffff ) + __builtin_popcount( w >> 32 );
+    }
+    return n;
+  }
+
+  /* checks whether (a & mask) is a subset of b */
+  static bool subset( const bitset& a, const bitset& b, const bitset& mask )
+  {
+    for ( auto i = 0u; i < a.size(); ++i )
+    {
+      if ( a[i] & mask[i] & ~b[i] )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool is_empty( const bitset& b )
+  {
+    return std::all_of( b.begin(), b.end(), []( auto w ) { return w == 0u; } );
+  }
+
+  cost_t cost_of( const std::vector<uint32_t>& cols ) const
+  {
+    cost_t c{ static_cast<uint32_t>( cols.size() ), 0u };
+    for ( auto col : cols )
+    {
+      c.second += _costs[col];
+    }
+    return c;
+  }
+
+  void select( state& s, uint32_t col ) const
+  {
+    s.chosen.push_back( col );
+    s.cost.first++;
+    s.cost.second += _costs[col];
+    for ( auto i = 0u; i < _row_words; ++i )
+    {
+      s.rows[i] &= ~_cols[col][i];
+    }
+    reset( s.cols, col );
+  }
+
+  /* essential columns, row and column dominance; returns false if infeasible */
+  bool reduce( state& s ) const
+  {
+    bool changed = true;
+    while ( changed )
+    {
+      changed = false;
+
+      /* essential columns */
+      bool infeasible = false;
+      for_each_bit( s.rows, [&]( auto r ) {
+        if ( infeasible || ( ( s.rows[r >> 6] >> ( r & 63 ) ) & 1 ) == 0 )
+        {
+          return;
+        }
+        const auto n = count_and( _rows[r], s.cols );
+        if ( n == 0u )
+        {
+          infeasible = true;
+        }
+        else if ( n == 1u )
+        {
+          for ( auto i = 0u; i < _col_words; ++i )
+          {
+            if ( const auto w = _rows[r][i] & s.cols[i]; w )
+            {
+              select( s, ( i << 6 ) + __builtin_ctzll( w ) );
+              break;
+            }
+          }
+          changed = true;
+        }
+      } );
+      if ( infeasible )
+      {
+        return false;
+      }
+
+      /* row dominance: a row whose columns contain the columns of another row
+         is covered with it; dominated rows must contain its first column */
+      for_each_bit( s.rows, [&]( auto r1 ) {
+        if ( ( ( s.rows[r1 >> 6] >> ( r1 & 63 ) ) & 1 ) == 0 )
+        {
+          return;
+        }
+        auto first_col = _num_cols;
+        for ( auto i = 0u; i < _col_words; ++i )
+        {
+          if ( const auto w = _rows[r1][i] & s.cols[i]; w )
+          {
+            first_col = ( i << 6 ) + __builtin_ctzll( w );
+            break;
+          }
+        }
+        if ( first_col == _num_cols )
+        {
+          return;
+        }
+        for ( auto i = 0u; i < _row_words; ++i )
+        {
+          for ( auto w = _cols[first_col][i] & s.rows[i]; w; w &= w - 1 )
+          {
+            const auto r2 = ( i << 6 ) + __builtin_ctzll( w );
+            if ( r1 != r2 && subset( _rows[r1], _rows[r2], s.cols ) && ( r1 < r2 || !subset( _rows[r2], _rows[r1], s.cols ) ) )
+            {
+              reset( s.rows, r2 );
+              changed = true;
+            }
+          }
+        }
+      } );
+
+      /* column dominance: a column whose rows are contained in a cheaper
+         column is removed; dominating columns must cover its first row */
+      for_each_bit( s.cols, [&]( auto c1 ) {
+        auto first_row = _num_rows;
+        for ( auto i = 0u; i < _row_words; ++i )
+        {
+          if ( const auto w = _cols[c1][i] & s.rows[i]; w )
+          {
+            first_row = ( i << 6 ) + __builtin_ctzll( w );
+            break;
+          }
+        }
+        if ( first_row == _num_rows )
+        {
+          reset( s.cols, c1 );
+          changed = true;
+          return;
+        }
+        for ( auto i = 0u; i < _col_words; ++i )
+        {
+          for ( auto w = _rows[first_row][i] & s.cols[i]; w; w &= w - 1 )
+          {
+            const auto c2 = ( i << 6 ) + __builtin_ctzll( w );
+            if ( c1 == c2 || _costs[c2] > _costs[c1] )
+            {
+              continue;
+            }
+            if ( subset( _cols[c1], _cols[c2], s.rows ) && ( _costs[c2] < _costs[c1] || c2 < c1 || !subset( _cols[c2], _cols[c1], s.rows ) ) )
+            {
+              reset( s.cols, c1 );
+              changed = true;
+              return;
+            }
+          }
+        }
+      } );
+    }
+    return true;
+  }
+
+  static bool is_empty_and( const bitset& a, const bitset& b )
+  {
+    for ( auto i = 0u; i < a.size(); ++i )
+    {
+      if ( a[i] & b[i] )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* lower bound on the number of columns that are needed to cover the
+     remaining rows: the maximum of the number of rows that pairwise share no
+     column and of a feasible solution to the dual of the LP relaxation, which
+     assigns each row the reciprocal of the largest number of rows covered by
+     one of its columns */
+  uint32_t lower_bound( const state& s ) const
+  {
+    std::vector<uint32_t> coverage( _num_cols, 0u );
+    for_each_bit( s.cols, [&]( auto c ) { coverage[c] = count_and( _cols[c], s.rows ); } );
+
+    std::vector<std::pair<uint32_t, uint32_t>> rows;
+    auto dual = 0.0;
+    for_each_bit( s.rows, [&]( auto r ) {
+      uint32_t num_cols = 0u, max_coverage = 0u;
+      for_each_col( s, r, [&]( auto c ) {
+        ++num_cols;
+        max_coverage = std::max( max_coverage, coverage[c] );
+      } );
+      rows.emplace_back( num_cols, r );
+      dual += 1.0 / max_coverage;
+    } );
+    std::sort( rows.begin(), rows.end() );
+
+    bitset used( _col_words, 0u );
+    uint32_t lb = 0u;
+    for ( const auto& [n, r] : rows )
+    {
+      (void)n;
+      if ( is_empty_and( _rows[r], used ) )
+      {
+        ++lb;
+        for ( auto i = 0u; i < _col_words; ++i )
+        {
+          used[i] |= _rows[r][i] & s.cols[i];
+        }
+      }
+    }
+
+    /* tolerance for rounding errors of the sum */
+    return std::max( lb, static_cast<uint32_t>( std::ceil( dual - 1e-9 ) ) );
+  }
+
+  /* selects the column that covers most rows per cost until all rows are
+     covered; since scores only decrease, they are updated lazily */
+  std::vector<uint32_t> greedy( state s ) const
+  {
+    const auto score = [&]( uint32_t c ) { return static_cast<double>( count_and( _cols[c], s.rows ) ) / ( 1u + _costs[c] ); };
+
+    std::priority_queue<std::pair<double, int64_t>> queue;
+    for_each_bit( s.cols, [&]( auto c ) { queue.emplace( score( c ), -static_cast<int64_t>( c ) ); } );
+
+    while ( !is_empty( s.rows ) && !queue.empty() )
+    {
+      const auto c = static_cast<uint32_t>( -queue.top().second );
+      queue.pop();
+      const auto sc = score( c );
+      if ( !queue.empty() && sc < queue.top().first )
+      {
+        queue.emplace( sc, -static_cast<int64_t>( c ) );
+        continue;
+      }
+      select( s, c );
+    }
+    return s.chosen;
+  }
+
+  void search( state& s )
+  {
+    ++_nodes;
+
+    if ( is_empty( s.rows ) )
+    {
+      if ( s.cost < _best_cost )
+      {
+        _best = s.chosen;
+        _best_cost = s.cost;
+      }
+      return;
+    }
+
+    if ( _max_nodes != 0u && _nodes >= _max_nodes )
+    {
+      return;
+    }
+
+    /* each of the lb missing columns costs at least as much as the cheapest column */
+    const auto lb = lower_bound( s );
+    auto min_cost = ~0u;
+    for_each_bit( s.cols, [&]( auto c ) { min_cost = std::min( min_cost, _costs[c] ); } );
+    if ( cost_t{ s.cost.first + lb, s.cost.second + lb * min_cost } >= _best_cost )
+    {
+      return;
+    }
+
+    /* branch on the columns of the row with fewest columns */
+    auto branch_row = 0u;
+    auto fewest = ~0u;
+    for_each_bit( s.rows, [&]( auto r ) {
+      const auto n = count_and( _rows[r], s.cols );
+      if ( n < fewest )
+      {
+        fewest = n;
+        branch_row = r;
+      }
+    } );
+
+    std::vector<std::pair<int64_t, uint32_t>> candidates;
+    for_each_bit( _rows[branch_row], [&]( auto c ) {
+      if ( ( s.cols[c >> 6] >> ( c & 63 ) ) & 1 )
+      {
+        candidates.emplace_back( -static_cast<int64_t>( count_and( _cols[c], s.rows ) ) * 64 + _costs[c], c );
+      }
+    } );
+    std::sort( candidates.begin(), candidates.end() );
+
+    auto excluded = s.cols;
+    for ( const auto& [score, c] : candidates )
+    {
+      (void)score;
+      if ( _max_nodes != 0u && _nodes >= _max_nodes )
+      {
+        return;
+      }
+
+      state child{ s.rows, excluded, s.chosen, s.cost };
+      select( child, c );
+      if ( reduce( child ) )
+      {
+        search( child );
+      }
+
+      /* solutions with column c have been explored */
+      reset( excluded, c );
+    }
+  }
+
+private:
+  uint32_t _num_rows;
+  uint32_t _num_cols;
+  uint32_t _row_words;
+  uint32_t _col_words;
+  std::vector<bitset> _cols;
+  std::vector<bitset> _rows;
+  std::vector<uint32_t> _costs;
+  uint64_t _max_nodes;
+
+  uint64_t _nodes{ 0u };
+  std::vector<uint32_t> _best;
+  cost_t _best_cost;
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Exact two-level minimization
+
+  Computes a sum-of-products representation with the minimum number of cubes
+  for an incompletely specified function, and among those one with the
+  minimum number of literals.  The algorithm computes all prime implicants of
+  the union of onset and don't care set, and solves the unate covering problem
+  of the onset minterms that are not don't cares.
+
+  The covering matrix is stored as bitsets of rows (minterms) and columns
+  (primes) and is reduced by selecting essential primes and by removing
+  dominated rows and columns.  The remaining problem is solved by
+  branch-and-bound, which branches on the primes covering the row with fewest
+  primes.  The initial upper bound is a greedy cover, and nodes are pruned
+  with the larger of two lower bounds: the size of a set of rows that
+  pairwise share no prime, and the LP-dual bound that assigns each row the
+  reciprocal of the largest number of rows covered by one of its primes.
+
+  The search is exact for small and sparse functions.  For dense functions of
+  12 to 14 inputs the gap between lower bound and optimum is typically too
+  large to be closed, and the search stops after `exact_sop_params::max_nodes`
+  nodes with the best cover found so far and `exact_sop_stats::optimal` set to
+  false.
+
+  \param on Truth table of onset
+  \param dc Truth table of don't care set
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<cube> exact_sop( const TT& on, const TT& dc, const exact_sop_params& ps = {}, exact_sop_stats* pst = nullptr )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+  assert( on.num_vars() <= 32 );
+
+  exact_sop_stats st;
+  const auto care_on = on & ~dc;
+  const auto primes = get_prime_implicants_morreale( on | dc );
+
+  /* rows are care minterms of the onset */
+  std::vector<uint32_t> row_index( care_on.num_bits(), 0u );
+  uint32_t num_rows = 0u;
+  for_each_one_bit( care_on, [&]( auto m ) { row_index[m] = num_rows++; } );
+
+  std::vector<cube> columns;
+  std::vector<detail::covering_matrix::bitset> cols;
+  std::vector<uint32_t> costs;
+  for ( const auto& p : primes )
+  {
+    detail::covering_matrix::bitset rows( ( num_rows + 63u ) >> 6u, 0u );
+    auto covers = false;
+    p.foreach_minterm( on.num_vars(), [&]( const cube& m ) {
+      if ( get_bit( care_on, m._bits ) )
+      {
+        const auto r = row_index[m._bits];
+        rows[r >> 6] |= uint64_t( 1 ) << ( r & 63 );
+        covers = true;
+      }
+      return true;
+    } );
+    if ( covers )
+    {
+      columns.push_back( p );
+      cols.push_back( std::move( rows ) );
+      costs.push_back( p.num_literals() );
+    }
+  }
+  st.primes = static_cast<uint32_t>( columns.size() );
+  st.minterms = num_rows;
+
+  std::vector<cube> cubes;
+  if ( num_rows > 0u )
+  {
+    detail::covering_matrix matrix( num_rows, std::move( cols ), std::move( costs ), ps.max_nodes );
+    for ( auto c : matrix.solve( st ) )
+    {
+      cubes.push_back( columns[c] );
+    }
+  }
+
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return cubes;
+}
+
+/*! \brief Exact two-level minimization of a completely specified function
+
+  \param tt Truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<cube> exact_sop( const TT& tt, const exact_sop_params& ps = {}, exact_sop_stats* pst = nullptr )
+{
+  return exact_sop( tt, tt.construct(), ps, pst );
+}
+
+/*! \brief Exact two-level minimization of a ternary truth table
+
+  \param tt Ternary truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<cube> exact_sop( const ternary_truth_table<TT>& tt, const exact_sop_params& ps = {}, exact_sop_stats* pst = nullptr )
+{
+  return exact_sop( tt._bits & tt._care, ~tt._care, ps, pst );
+}
+
+} /* namespace kitty */
@@ -0,0 +1,619 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file exorcism.hpp
+  \brief Heuristic ESOP minimization
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cube.hpp"
+#include "esop.hpp"
+#include "traits.hpp"
+
+namespace kitty
+{
+
+/*! \brief Parameters for exorcism */
+struct exorcism_params
+{
+  /*! Time budget in seconds (0 = no limit). */
+  double time_budget{ 0.0 };
+
+  /*! Number of rounds without improvement, after which the search stops. */
+  uint32_t max_stagnant_rounds{ 3u };
+
+  /*! Cost of a cover from its number of cubes and literals; the default
+      minimizes the number of cubes first and then the number of literals. */
+  std::function<uint64_t( uint64_t, uint64_t )> cost{ []( uint64_t cubes, uint64_t literals ) { return ( cubes << 32u ) + literals; } };
+
+  /*! Seed for the choice of cost-neutral rewrites. */
+  uint32_t seed{ 0xcafeaffe };
+};
+
+/*! \brief Statistics for exorcism */
+struct exorcism_stats
+{
+  /*! Number of cubes in the initial ESOP, after merging cubes of distance 0 and 1. */
+  uint64_t initial_cubes{ 0u };
+
+  /*! Number of literals in the initial ESOP, after merging cubes of distance 0 and 1. */
+  uint64_t initial_literals{ 0u };
+
+  /*! Number of cubes in the result. */
+  uint64_t cubes{ 0u };
+
+  /*! Number of literals in the result. */
+  uint64_t literals{ 0u };
+
+  /*! Number of rounds. */
+  uint32_t rounds{ 0u };
+
+  /*! Number of applied cube pair rewrites. */
+  uint64_t rewrites{ 0u };
+
+  /*! Runtime in seconds. */
+  double time{ 0.0 };
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* Local search on multi-output ESOPs, in which each cube is stored with the
+   set of outputs it belongs to.  The cover is kept free of cube pairs with
+   distance 0 and 1, which are merged when a cube is added.  Pairs of cubes
+   with distance 2 and 3 are replaced by equivalent cubes using EXORLINK
+   [N. Song and M. A. Perkowski, IEEE Trans. CAD 15(4), 1996, 385-395], if
+   the new cubes merge with other cubes of the cover.  Partners of a cube are
+   found by hash lookups of all cubes that differ in up to 3 variables. */
+class exorcism_impl
+{
+  struct entry
+  {
+    cube c;
+    uint64_t outputs;
+    bool alive;
+  };
+
+  /* the output part is treated as an additional position of the cube */
+  static constexpr uint32_t output_position = 32u;
+
+public:
+  exorcism_impl( uint32_t num_vars, const exorcism_params& ps, exorcism_stats& st )
+      : _num_vars( num_vars ),
+        _ps( ps ),
+        _st( st ),
+        _rng( ps.seed )
+  {
+  }
+
+  std::vector<std::pair<cube, uint64_t>> run( const std::vector<std::pair<cube, uint64_t>>& cubes )
+  {
+    _start = std::chrono::steady_clock::now();
+
+    for ( const auto& [c, outputs] : cubes )
+    {
+      add( c, outputs );
+    }
+    _st.initial_cubes = _num_cubes;
+    _st.initial_literals = _num_literals;
+
+    auto best = result();
+    auto best_cost = _ps.cost( _num_cubes, _num_literals );
+
+    for ( auto stagnant = 0u; stagnant < _ps.max_stagnant_rounds && !timeout(); )
+    {
+      ++_st.rounds;
+
+      const auto improved = improve( 2u ) | improve( 3u );
+      if ( const auto c = _ps.cost( _num_cubes, _num_literals ); c < best_cost )
+      {
+        best = result();
+        best_cost = c;
+        stagnant = 0u;
+      }
+      else
+      {
+        ++stagnant;
+      }
+
+      if ( !improved )
+      {
+        /* reshape the cover with cost-neutral distance-2 rewrites */
+        perturb();
+      }
+      compact();
+    }
+
+    _st.cubes = best.size();
+    _st.literals = 0u;
+    for ( const auto& p : best )
+    {
+      _st.literals += p.first.num_literals();
+    }
+    _st.time = elapsed();
+    return best;
+  }
+
+private:
+  double elapsed() const
+  {
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - _start ).count();
+  }
+
+  bool timeout() const
+  {
+    return _ps.time_budget > 0.0 && elapsed() >= _ps.time_budget;
+  }
+
+  /* literal of variable as set of values: 1 = {0}, 2 = {1}, 3 = {0, 1} */
+  static inline uint32_t get_value( const cube& c, uint32_t var_index )
+  {
+    return c.get_mask( var_index ) ? ( c.get_bit( var_index ) ? 2u : 1u ) : 3u;
+  }
+
+  static inline void set_value( cube& c, uint32_t var_index, uint32_t value )
+  {
+    if ( value == 3u )
+    {
+      c.remove_literal( var_index );
+    }
+    else
+    {
+      c.add_literal( var_index, value == 2u );
+    }
+  }
+
+  std::vector<std::pair<cube, uint64_t>> result() const
+  {
+    std::vector<std::pair<cube, uint64_t>> cubes;
+    for ( const auto& e : _entries )
+    {
+      if ( e.alive )
+      {
+        cubes.emplace_back( e.c, e.outputs );
+      }
+    }
+    return cubes;
+  }
+
+  void compact()
+  {
+    std::vector<entry> entries;
+    entries.reserve( _num_cubes );
+    for ( const auto& e : _entries )
+    {
+      if ( e.alive )
+      {
+        *_index.find( e.c ) = static_cast<uint32_t>( entries.size() );
+        entries.push_back( e );
+      }
+    }
+    _entries = std::move( entries );
+  }
+
+  void remove( uint32_t id )
+  {
+    auto& e = _entries[id];
+    _index.erase( e.c );
+    e.alive = false;
+    --_num_cubes;
+    _num_literals -= e.c.num_literals();
+  }
+
+  /* adds a cube and merges it with cubes of distance 0 and 1 */
+  void add( const cube& c, uint64_t outputs )
+  {
+    if ( outputs == 0u )
+    {
+      return;
+    }
+
+    if ( const auto* id = _index.find( c ); id != nullptr )
+    {
+      const auto merged = _entries[*id].outputs ^ outputs;
+      remove( *id );
+      add( c, merged );
+      return;
+    }
+
+    for ( auto v = 0u; v < _num_vars; ++v )
+    {
+      const auto value = get_value( c, v );
+      for ( auto other : { value % 3u + 1u, ( value + 1u ) % 3u + 1u } )
+      {
+        auto n = c;
+        set_value( n, v, other );
+        if ( const auto* id = _index.find( n ); id != nullptr && _entries[*id].outputs == outputs )
+        {
+          remove( *id );
+          set_value( n, v, value ^ other );
+          add( n, outputs );
+          return;
+        }
+      }
+    }
+
+    _index.insert( c, static_cast<uint32_t>( _entries.size() ) );
+    _entries.push_back( { c, outputs, true } );
+    ++_num_cubes;
+    _num_literals += c.num_literals();
+  }
+
+  /* calls fn( id, positions ) for all cubes whose distance to cube a is
+     exactly `distance`, positions are the positions in which they differ */
+  template<typename Fn>
+  bool foreach_partner( uint32_t a, uint32_t distance, Fn&& fn )
+  {
+    const auto c = _entries[a].c;
+    const auto outputs = _entries[a].outputs;
+
+    std::vector<uint32_t> positions;
+    auto n = c;
+
+    /* enumerates cubes that differ from c in `remaining` more variables */
+    std::function<bool( uint32_t, uint32_t )> rec = [&]( uint32_t first, uint32_t remaining ) {
+      if ( remaining == 0u )
+      {
+        const auto* id = _index.find( n );
+        if ( id == nullptr || *id == a )
+        {
+          return false;
+        }
+        const auto output_differs = _entries[*id].outputs != outputs;
+        if ( positions.size() + ( output_differs ? 1u : 0u ) != distance )
+        {
+          return false;
+        }
+        auto p = positions;
+        if ( output_differs )
+        {
+          p.push_back( output_position );
+        }
+        return fn( *id, p );
+      }
+
+      for ( auto v = first; v + remaining <= _num_vars; ++v )
+      {
+        const auto value = get_value( c, v );
+        positions.push_back( v );
+        for ( auto other : { value % 3u + 1u, ( value + 1u ) % 3u + 1u } )
+        {
+          set_value( n, v, other );
+          if ( rec( v + 1u, remaining - 1u ) )
+          {
+            return true;
+          }
+        }
+        set_value( n, v, value );
+        positions.pop_back();
+      }
+      return false;
+    };
+
+    for ( auto input_distance = distance - 1u; input_distance <= distance; ++input_distance )
+    {
+      if ( rec( 0u, input_distance ) )
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* EXORLINK: the cubes of A xor B, such that the t-th cube takes the values of
+     B in the first t - 1 positions of the permutation, A xor B in the t-th
+     position, and the values of A in the remaining ones */
+  std::vector<std::pair<cube, uint64_t>> exorlink( const entry& a, const entry& b, const std::vector<uint32_t>& perm ) const
+  {
+    std::vector<std::pair<cube, uint64_t>> cubes;
+    for ( auto t = 0u; t < perm.size(); ++t )
+    {
+      auto c = a.c;
+      auto outputs = a.outputs;
+      for ( auto i = 0u; i <= t; ++i )
+      {
+        const auto p = perm[i];
+        if ( p == output_position )
+        {
+          outputs = i < t ? b.outputs : a.outputs ^ b.outputs;
+        }
+        else
+        {
+          const auto vb = get_value( b.c, p );
+          set_value( c, p, i < t ? vb : get_value( a.c, p ) ^ vb );
+        }
+      }
+      cubes.emplace_back( c, outputs );
+    }
+    return cubes;
+  }
+
+  /* estimated change in cubes and literals when replacing a and b by cubes */
+  std::pair<int64_t, int64_t> estimate( uint32_t a, uint32_t b, const std::vector<std::pair<cube, uint64_t>>& cubes )
+  {
+    int64_t dc = static_cast<int64_t>( cubes.size() ) - 2;
+    int64_t dl = -static_cast<int64_t>( _entries[a].c.num_literals() + _entries[b].c.num_literals() );
+
+    std::vector<uint32_t> used{ a, b };
+    const auto available = [&]( const uint32_t* id ) { return id != nullptr && std::find( used.begin(), used.end(), *id ) == used.end(); };
+
+    for ( const auto& [c, outputs] : cubes )
+    {
+      const auto lits = static_cast<int64_t>( c.num_literals() );
+      dl += lits;
+
+      if ( const auto* id = _index.find( c ); available( id ) )
+      {
+        used.push_back( *id );
+        if ( _entries[*id].outputs == outputs )
+        {
+          dc -= 2;
+          dl -= 2 * lits;
+        }
+        else
+        {
+          dc -= 1;
+          dl -= lits;
+        }
+        continue;
+      }
+
+      for ( auto v = 0u; v < _num_vars; ++v )
+      {
+        const auto value = get_value( c, v );
+        auto found = false;
+        for ( auto other : { value % 3u + 1u, ( value + 1u ) % 3u + 1u } )
+        {
+          auto n = c;
+          set_value( n, v, other );
+          if ( const auto* id = _index.find( n ); available( id ) && _entries[*id].outputs == outputs )
+          {
+            used.push_back( *id );
+            set_value( n, v, value ^ other );
+            dc -= 1;
+            dl += static_cast<int64_t>( n.num_literals() ) - lits - _entries[*id].c.num_literals();
+            found = true;
+            break;
+          }
+        }
+        if ( found )
+        {
+          break;
+        }
+      }
+    }
+    return { dc, dl };
+  }
+
+  /* rewrites cube pairs of given distance that reduce the cost */
+  bool improve( uint32_t distance )
+  {
+    auto improved = false;
+    const auto num_entries = static_cast<uint32_t>( _entries.size() );
+    for ( auto a = 0u; a < num_entries && !timeout(); ++a )
+    {
+      if ( !_entries[a].alive )
+      {
+        continue;
+      }
+
+      const auto cost = _ps.cost( _num_cubes, _num_literals );
+      improved |= foreach_partner( a, distance, [&]( uint32_t b, std::vector<uint32_t> perm ) {
+        std::sort( perm.begin(), perm.end() );
+        std::vector<std::pair<cube, uint64_t>> best;
+        auto best_cost = cost;
+        do
+        {
+          auto cubes = exorlink( _entries[a], _entries[b], perm );
+          const auto [dc, dl] = estimate( a, b, cubes );
+          if ( const auto c = _ps.cost( _num_cubes + dc, _num_literals + dl ); c < best_cost )
+          {
+            best = std::move( cubes );
+            best_cost = c;
+          }
+        } while ( std::next_permutation( perm.begin(), perm.end() ) );
+
+        if ( best.empty() )
+        {
+          return false;
+        }
+        replace( a, b, best );
+        return true;
+      } );
+    }
+    return improved;
+  }
+
+  /* applies randomly chosen distance-2 rewrites that do not increase the cost */
+  void perturb()
+  {
+    const auto num_entries = static_cast<uint32_t>( _entries.size() );
+    for ( auto a = 0u; a < num_entries && !timeout(); ++a )
+    {
+      if ( !_entries[a].alive )
+      {
+        continue;
+      }
+
+      const auto cost = _ps.cost( _num_cubes, _num_literals );
+      foreach_partner( a, 2u, [&]( uint32_t b, std::vector<uint32_t> perm ) {
+        if ( _rng() % 2u )
+        {
+          std::swap( perm[0], perm[1] );
+        }
+        const auto cubes = exorlink( _entries[a], _entries[b], perm );
+        const auto [dc, dl] = estimate( a, b, cubes );
+        if ( _ps.cost( _num_cubes + dc, _num_literals + dl ) > cost )
+        {
+          return false;
+        }
+        replace( a, b, cubes );
+        return true;
+      } );
+    }
+  }
+
+  void replace( uint32_t a, uint32_t b, const std::vector<std::pair<cube, uint64_t>>& cubes )
+  {
+    ++_st.rewrites;
+    remove( a );
+    remove( b );
+    for ( const auto& [c, outputs] : cubes )
+    {
+      add( c, outputs );
+    }
+  }
+
+private:
+  uint32_t _num_vars;
+  const exorcism_params& _ps;
+  exorcism_stats& _st;
+  std::default_random_engine _rng;
+  std::chrono::steady_clock::time_point _start;
+
+  std::vector<entry> _entries;
+  cube_hash_map<uint32_t> _index;
+  uint64_t _num_cubes{ 0u };
+  uint64_t _num_literals{ 0u };
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Heuristic minimization of a multi-output ESOP
+
+  Minimizes an ESOP by local search in the style of EXORCISM [A. Mishchenko
+  and M. A. Perkowski, Reed-Muller Workshop, 2001].  Each cube is paired with
+  the set of outputs that contain it, represented as bitmask of up to 64
+  outputs.  Cubes with distance 0 or 1 are merged immediately.  Pairs of
+  cubes with distance 2 or 3, in which the output part counts as one
+  position, are replaced by one of their equivalent EXORLINK covers, if
+  the new cubes merge with other cubes such that the cost decreases.  If a
+  round finds no improvement, cost-neutral distance-2 rewrites reshape the
+  cover.
+
+  The search stops after `ps.max_stagnant_rounds` rounds without
+  improvement or when the time budget is exceeded, and returns the cheapest
+  cover found.
+
+  \param esop Cubes with output masks
+  \param num_vars Number of variables (at most 32)
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+inline std::vector<std::pair<cube, uint64_t>> exorcism( const std::vector<std::pair<cube, uint64_t>>& esop, uint32_t num_vars, const exorcism_params& ps = {}, exorcism_stats* pst = nullptr )
+{
+  assert( num_vars <= 32u );
+
+  exorcism_stats st;
+  const auto cubes = detail::exorcism_impl( num_vars, ps, st ).run( esop );
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return cubes;
+}
+
+/*! \brief Heuristic minimization of an ESOP
+
+  \param esop Cubes
+  \param num_vars Number of variables (at most 32)
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+inline std::vector<cube> exorcism( const std::vector<cube>& esop, uint32_t num_vars, const exorcism_params& ps = {}, exorcism_stats* pst = nullptr )
+{
+  std::vector<std::pair<cube, uint64_t>> mo_esop;
+  for ( const auto& c : esop )
+  {
+    mo_esop.emplace_back( c, 1u );
+  }
+
+  std::vector<cube> cubes;
+  for ( const auto& p : exorcism( mo_esop, num_vars, ps, pst ) )
+  {
+    cubes.push_back( p.first );
+  }
+  return cubes;
+}
+
+/*! \brief Heuristic ESOP minimization of a truth table
+
+  The initial ESOP is computed with `esop_from_optimum_pkrm`.
+
+  \param tt Truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<cube> exorcism( const TT& tt, const exorcism_params& ps = {}, exorcism_stats* pst = nullptr )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  return exorcism( esop_from_optimum_pkrm( tt ), tt.num_vars(), ps, pst );
+}
+
+/*! \brief Heuristic ESOP minimization of multiple truth tables
+
+  The initial ESOP is the union of the optimum PKRM ESOPs of all functions,
+  in which the i-th bit of the output mask indicates whether a cube belongs
+  to the i-th function.
+
+  \param functions Truth tables (at most 64)
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<std::pair<cube, uint64_t>> exorcism( const std::vector<TT>& functions, const exorcism_params& ps = {}, exorcism_stats* pst = nullptr )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+  assert( !functions.empty() && functions.size() <= 64u );
+
+  std::vector<std::pair<cube, uint64_t>> esop;
+  for ( auto i = 0u; i < functions.size(); ++i )
+  {
+    for ( const auto& c : esop_from_optimum_pkrm( functions[i] ) )
+    {
+      esop.emplace_back( c, uint64_t( 1 ) << i );
+    }
+  }
+  return exorcism( esop, functions.front().num_vars(), ps, pst );
+}
+
+} /* namespace kitty */
@@ -34,8 +34,16 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <iterator>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "partial_truth_table.hpp"
+#include "quaternary_truth_table.hpp"
 #include "static_truth_table.hpp"
+#include "ternary_truth_table.hpp"
 
 namespace kitty
 {
@@ -64,32 +72,154 @@ inline void hash_combine( std::size_t& seed, std::size_t other )
   seed += 0xe6546b64;
 }
 
-/*! \brief Computes hash values for truth tables */
-template<typename TT>
-struct hash
+/*! \cond PRIVATE */
+namespace detail
 {
-  std::size_t operator()( const TT& tt ) const
+
+static constexpr uint64_t hash_secret[] = {
+    UINT64_C( 0xa0761d6478bd642f ), UINT64_C( 0xe7037ed1a0b428db ),
+    UINT64_C( 0x8ebc6af09c88c6e3 ), UINT64_C( 0x589965cc75374cc3 )};
+
+/* folds the 128-bit product of a and b into 64 bits */
+inline uint64_t hash_mum( uint64_t a, uint64_t b )
+{
+#ifdef _MSC_VER
+  uint64_t hi;
+  const auto lo = _umul128( a, b, &hi );
+  return lo ^ hi;
+#else
+  const auto r = static_cast<__uint128_t>( a ) * b;
+  return static_cast<uint64_t>( r ) ^ static_cast<uint64_t>( r >> 64 );
+#endif
+}
+
+/* stores the seed of hash functors */
+struct hash_seed
+{
+  hash_seed() = default;
+  explicit hash_seed( uint64_t seed ) : seed( seed ) {}
+
+  uint64_t seed{ 0u };
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Computes a 64-bit hash value for an array of words
+
+  The hash function follows the construction of wyhash: each step
+  multiplies two 64-bit words, each combined with a secret or the state,
+  into a 128-bit product, and folds its two halves by XOR.  Arrays of more
+  than 8 words are processed in 4 independent lanes of 2 words, such that
+  the multiplications of one iteration can be executed in parallel.  The
+  number of words is part of the hash value.
+
+  \param words Pointer to the first word
+  \param num_words Number of words
+  \param seed Seed
+*/
+inline uint64_t hash_words( const uint64_t* words, std::size_t num_words, uint64_t seed = 0u )
+{
+  using detail::hash_mum;
+  using detail::hash_secret;
+
+  auto h = seed ^ hash_mum( seed ^ hash_secret[0], hash_secret[1] );
+
+  std::size_t i = 0u;
+  if ( num_words > 8u )
   {
-    auto it = std::begin( tt._bits );
-    auto seed = hash_block( *it++ );
+    auto l0 = h, l1 = h, l2 = h, l3 = h;
+    for ( ; i + 8u < num_words; i += 8u )
+    {
+      l0 = hash_mum( words[i] ^ hash_secret[0], words[i + 1u] ^ l0 );
+      l1 = hash_mum( words[i + 2u] ^ hash_secret[1], words[i + 3u] ^ l1 );
+      l2 = hash_mum( words[i + 4u] ^ hash_secret[2], words[i + 5u] ^ l2 );
+      l3 = hash_mum( words[i + 6u] ^ hash_secret[3], words[i + 7u] ^ l3 );
+    }
+    h = l0 ^ l1 ^ l2 ^ l3;
+  }
+
+  for ( ; i + 2u < num_words; i += 2u )
+  {
+    h = hash_mum( words[i] ^ hash_secret[1], words[i + 1u] ^ h );
+  }
 
-    while ( it != std::end( tt._bits ) )
+  /* the last one or two words */
+  uint64_t a = 0u, b = 0u;
+  if ( i < num_words )
+  {
+    a = words[i];
+    if ( i + 1u < num_words )
     {
-      hash_combine( seed, hash_block( *it++ ) );
+      b = words[i + 1u];
     }
+  }
 
-    return seed;
+  return hash_mum( hash_secret[1] ^ num_words, hash_mum( a ^ hash_secret[1], b ^ h ) );
+}
+
+/*! \brief Computes hash values for truth tables
+
+  The hash value is computed with `hash_words` over the words of the truth
+  table.  The functor can be constructed with a seed, e.g., to obtain
+  independent hash functions.
+*/
+template<typename TT>
+struct hash : detail::hash_seed
+{
+  using detail::hash_seed::hash_seed;
+
+  std::size_t operator()( const TT& tt ) const
+  {
+    return hash_words( std::data( tt._bits ), std::size( tt._bits ), seed );
   }
 };
 
 /*! \cond PRIVATE */
 template<uint32_t NumVars>
-struct hash<static_truth_table<NumVars, true>>
+struct hash<static_truth_table<NumVars, true>> : detail::hash_seed
 {
+  using detail::hash_seed::hash_seed;
+
   inline std::size_t operator()( const static_truth_table<NumVars, true>& tt ) const
   {
-    return hash_block( tt._bits );
+    return hash_words( &tt._bits, 1u, seed );
+  }
+};
+
+template<>
+struct hash<partial_truth_table> : detail::hash_seed
+{
+  using detail::hash_seed::hash_seed;
+
+  inline std::size_t operator()( const partial_truth_table& tt ) const
+  {
+    /* the number of bits distinguishes tables with the same words */
+    const auto s = detail::hash_mum( seed ^ detail::hash_secret[2], tt._num_bits );
+    return hash_words( tt._bits.data(), tt._bits.size(), s );
+  }
+};
+
+template<typename TT>
+struct hash<ternary_truth_table<TT>> : detail::hash_seed
+{
+  using detail::hash_seed::hash_seed;
+
+  inline std::size_t operator()( const ternary_truth_table<TT>& tt ) const
+  {
+    return hash<TT>( hash<TT>( seed )( tt._care ) )( tt._bits );
+  }
+};
+
+template<typename TT>
+struct hash<quaternary_truth_table<TT>> : detail::hash_seed
+{
+  using detail::hash_seed::hash_seed;
+
+  inline std::size_t operator()( const quaternary_truth_table<TT>& tt ) const
+  {
+    return hash<TT>( hash<TT>( seed )( tt._onset ) )( tt._offset );
   }
 };
 /*! \endcond */
-} // namespace kitty
\ No newline at end of file
+} // namespace kitty
@@ -32,7 +32,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
+#include <unordered_map>
 #include <vector>
 
 #include "algorithm.hpp"
@@ -126,12 +129,16 @@ inline std::vector<std::pair<std::vector<uint32_t>::const_iterator, std::vector<
   by the algorithm described in [E. Morreale, IEEE Trans. EC 16(5), 1967,
   611–620].
 
+  The cube type can be changed to `wide_cube` or `dynamic_cube`, e.g., to
+  use the implicants together with covers over more than 32 variables.
+
   \param minterms Vector of minterms (as integer values)
   \param num_vars Number of variables
 */
-inline std::vector<cube> get_prime_implicants_morreale( const std::vector<uint32_t>& minterms, unsigned num_vars )
+template<typename Cube = cube>
+std::vector<Cube> get_prime_implicants_morreale( const std::vector<uint32_t>& minterms, unsigned num_vars )
 {
-  std::vector<cube> cubes;
+  std::vector<Cube> cubes;
 
   const auto n = num_vars;
   const auto m = minterms.size();
@@ -234,11 +241,200 @@ inline std::vector<cube> get_prime_implicants_morreale( const std::vector<uint32
 
   \param tt Truth table
 */
-template<typename TT>
-std::vector<cube> get_prime_implicants_morreale( const TT& tt )
+template<typename TT, typename Cube = cube>
+std::vector<Cube> get_prime_implicants_morreale( const TT& tt )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  return get_prime_implicants_morreale<Cube>( get_minterms( tt ), tt.num_vars() );
+}
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* Computes the prime implicants of f recursively from the cofactors f0 and f1
+   with respect to the topmost variable x, using the identity
+
+     P(f) = P(g) + !x (P(f0) - P(g)) + x (P(f1) - P(g))    with g = f0 & f1
+
+   since a prime of f0 that is contained in f1 is a prime of g.  The consensus
+   g of both cofactors is computed bit-parallel on the truth table words, and
+   prime lists are kept sorted to compute the differences and unions by
+   merging. */
+template<typename Cube>
+class blake_prime_generator
+{
+public:
+  explicit blake_prime_generator( uint32_t num_vars )
+      : _buffers( num_vars + 1u )
+  {
+    for ( auto k = 7u; k <= num_vars; ++k )
+    {
+      _buffers[k].resize( uint64_t( 1 ) << ( k - 7u ) );
+    }
+  }
+
+  std::vector<Cube> run( const uint64_t* bits, uint32_t num_vars )
+  {
+    if ( num_vars <= 6u )
+    {
+      return run_word( *bits & word_mask( num_vars ), num_vars );
+    }
+    return run_words( bits, num_vars );
+  }
+
+private:
+  static inline uint64_t word_mask( uint32_t k )
+  {
+    return k == 6u ? ~uint64_t( 0 ) : ( uint64_t( 1 ) << ( 1u << k ) ) - 1u;
+  }
+
+  static std::vector<Cube> combine( const std::vector<Cube>& pg, const std::vector<Cube>& p0, const std::vector<Cube>& p1, uint32_t var_index )
+  {
+    std::vector<Cube> primes;
+    primes.reserve( pg.size() + p0.size() + p1.size() );
+    primes.insert( primes.end(), pg.begin(), pg.end() );
+    std::set_difference( p0.begin(), p0.end(), pg.begin(), pg.end(), std::back_inserter( primes ) );
+    const auto mid = primes.size();
+    std::set_difference( p1.begin(), p1.end(), pg.begin(), pg.end(), std::back_inserter( primes ) );
+    for ( auto i = pg.size(); i < primes.size(); ++i )
+    {
+      primes[i].add_literal( var_index, i >= mid );
+    }
+
+    /* adding a literal of a variable above the support keeps each part sorted */
+    std::inplace_merge( primes.begin() + pg.size(), primes.begin() + mid, primes.end() );
+    std::inplace_merge( primes.begin(), primes.begin() + pg.size(), primes.end() );
+    return primes;
+  }
+
+  std::vector<Cube> run_word( uint64_t f, uint32_t k )
+  {
+    if ( f == 0u )
+    {
+      return {};
+    }
+    if ( f == word_mask( k ) )
+    {
+      return { Cube() };
+    }
+
+    if ( k == 6u )
+    {
+      if ( const auto it = _word_cache.find( f ); it != _word_cache.end() )
+      {
+        return it->second;
+      }
+    }
+
+    const auto half = 1u << ( k - 1u );
+    const auto f0 = f & word_mask( k - 1u );
+    const auto f1 = f >> half;
+    const auto g = f0 & f1;
+
+    std::vector<Cube> primes;
+    if ( f0 == f1 )
+    {
+      primes = run_word( f0, k - 1u );
+    }
+    else if ( g == f0 )
+    {
+      primes = combine( run_word( f0, k - 1u ), {}, run_word( f1, k - 1u ), k - 1u );
+    }
+    else if ( g == f1 )
+    {
+      primes = combine( run_word( f1, k - 1u ), run_word( f0, k - 1u ), {}, k - 1u );
+    }
+    else
+    {
+      primes = combine( run_word( g, k - 1u ), run_word( f0, k - 1u ), run_word( f1, k - 1u ), k - 1u );
+    }
+
+    if ( k == 6u )
+    {
+      _word_cache.emplace( f, primes );
+    }
+    return primes;
+  }
+
+  std::vector<Cube> run_child( const uint64_t* f, uint32_t k )
+  {
+    return k == 6u ? run_word( *f, 6u ) : run_words( f, k );
+  }
+
+  std::vector<Cube> run_words( const uint64_t* f, uint32_t k )
+  {
+    const auto num_words = uint64_t( 1 ) << ( k - 6u );
+    if ( std::all_of( f, f + num_words, []( auto w ) { return w == 0u; } ) )
+    {
+      return {};
+    }
+    if ( std::all_of( f, f + num_words, []( auto w ) { return w == ~uint64_t( 0 ); } ) )
+    {
+      return { Cube() };
+    }
+
+    const auto half = num_words >> 1u;
+    const auto* f0 = f;
+    const auto* f1 = f + half;
+    auto* g = _buffers[k].data();
+
+    auto g_is_f0 = true, g_is_f1 = true;
+    for ( auto i = 0u; i < half; ++i )
+    {
+      g[i] = f0[i] & f1[i];
+      g_is_f0 = g_is_f0 && g[i] == f0[i];
+      g_is_f1 = g_is_f1 && g[i] == f1[i];
+    }
+
+    if ( g_is_f0 && g_is_f1 )
+    {
+      return run_child( f0, k - 1u );
+    }
+    else if ( g_is_f0 )
+    {
+      return combine( run_child( f0, k - 1u ), {}, run_child( f1, k - 1u ), k - 1u );
+    }
+    else if ( g_is_f1 )
+    {
+      return combine( run_child( f1, k - 1u ), run_child( f0, k - 1u ), {}, k - 1u );
+    }
+    else
+    {
+      /* g is computed before recursing, lower levels use other buffers */
+      return combine( run_child( g, k - 1u ), run_child( f0, k - 1u ), run_child( f1, k - 1u ), k - 1u );
+    }
+  }
+
+private:
+  std::vector<std::vector<uint64_t>> _buffers;
+  std::unordered_map<uint64_t, std::vector<Cube>> _word_cache;
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Computes all prime implicants (from truth table, recursively)
+
+  This algorithm computes all prime implicants, i.e., the Blake canonical
+  form, by recursion on the cofactors of the truth table.  The primes of a
+  function are the primes of the conjunction \f$g = f_{\bar x} \land f_x\f$
+  of its cofactors, together with the primes of each cofactor that are not
+  primes of \f$g\f$, extended by the corresponding literal of \f$x\f$.
+
+  In contrast to `get_prime_implicants_morreale`, the algorithm does not
+  construct the list of minterms.  Cofactors and their conjunction are
+  computed on truth table words, and primes of sub-functions over up to 6
+  variables are cached.  The returned cubes are sorted.
+
+  \param tt Truth table
+*/
+template<typename TT, typename Cube = cube>
+std::vector<Cube> get_prime_implicants_blake( const TT& tt )
 {
   static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
 
-  return get_prime_implicants_morreale( get_minterms( tt ), tt.num_vars() );
+  return detail::blake_prime_generator<Cube>( tt.num_vars() ).run( &*tt.cbegin(), tt.num_vars() );
 }
 } // namespace kitty
\ No newline at end of file
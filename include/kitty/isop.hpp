@@ -32,9 +32,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "cube.hpp"
+#include "detail/constants.hpp"
+#include "detail/striped_cache.hpp"
+#include "detail/work_stealing_pool.hpp"
 #include "operations.hpp"
 #include "operators.hpp"
+#include "static_truth_table.hpp"
 #include "traits.hpp"
 
 namespace kitty
@@ -43,8 +52,8 @@ namespace kitty
 /*! \cond PRIVATE */
 namespace detail
 {
-template<typename TT>
-TT isop_rec( const TT& tt, const TT& dc, uint8_t var_index, std::vector<cube>& cubes )
+template<typename TT, typename Cube>
+TT isop_rec( const TT& tt, const TT& dc, uint32_t var_index, std::vector<Cube>& cubes )
 {
   assert( var_index <= tt.num_vars() );
   assert( is_const0( tt & ~dc ) );
@@ -106,6 +115,77 @@ TT isop_rec( const TT& tt, const TT& dc, uint8_t var_index, std::vector<cube>& c
 
   return res2;
 }
+
+/* replicates the bits of a function with less than 6 variables over the whole word */
+inline uint64_t isop_replicate( uint64_t word, uint32_t num_vars )
+{
+  for ( auto v = num_vars; v < 6u; ++v )
+  {
+    word |= word << ( 1u << v );
+  }
+  return word;
+}
+
+inline bool isop_has_var( uint64_t word, uint32_t var_index )
+{
+  return ( ( word >> ( 1u << var_index ) ) & projections_neg[var_index] ) != ( word & projections_neg[var_index] );
+}
+
+/* ISOP on a single word, in which functions over less than 6 variables are replicated */
+template<typename Cube>
+inline uint64_t isop_rec_word( uint64_t tt, uint64_t dc, uint32_t var_index, std::vector<Cube>& cubes )
+{
+  if ( tt == 0u )
+  {
+    return 0u;
+  }
+
+  if ( dc == ~uint64_t( 0 ) )
+  {
+    cubes.emplace_back(); /* add empty cube */
+    return dc;
+  }
+
+  assert( var_index > 0 );
+
+  int var = var_index - 1;
+  for ( ; var >= 0; --var )
+  {
+    if ( isop_has_var( tt, var ) || isop_has_var( dc, var ) )
+    {
+      break;
+    }
+  }
+
+  assert( var >= 0 );
+
+  /* co-factor */
+  const auto shift = 1u << var;
+  const auto tt0 = ( tt & projections_neg[var] ) | ( ( tt & projections_neg[var] ) << shift );
+  const auto tt1 = ( tt & projections[var] ) | ( ( tt & projections[var] ) >> shift );
+  const auto dc0 = ( dc & projections_neg[var] ) | ( ( dc & projections_neg[var] ) << shift );
+  const auto dc1 = ( dc & projections[var] ) | ( ( dc & projections[var] ) >> shift );
+
+  const auto beg0 = cubes.size();
+  const auto res0 = isop_rec_word( tt0 & ~dc1, dc0, var, cubes );
+  const auto end0 = cubes.size();
+  const auto res1 = isop_rec_word( tt1 & ~dc0, dc1, var, cubes );
+  const auto end1 = cubes.size();
+  auto res2 = isop_rec_word( ( tt0 & ~res0 ) | ( tt1 & ~res1 ), dc0 & dc1, var, cubes );
+
+  res2 |= ( res0 & projections_neg[var] ) | ( res1 & projections[var] );
+
+  for ( auto c = beg0; c < end0; ++c )
+  {
+    cubes[c].add_literal( var, false );
+  }
+  for ( auto c = end0; c < end1; ++c )
+  {
+    cubes[c].add_literal( var, true );
+  }
+
+  return res2;
+}
 } /* namespace detail */
 /* \endcond */
 
@@ -115,16 +195,680 @@ TT isop_rec( const TT& tt, const TT& dc, uint8_t var_index, std::vector<cube>& c
   Minato-Morreale algorithm [S. Minato, IEEE Trans. CAD 15(4), 1996,
   377-384].
 
+  The cube type can be changed to `wide_cube` or `dynamic_cube` to obtain
+  cubes with more than 32 variables.
+
   \param tt Truth table
 */
+template<typename TT, typename Cube = cube>
+inline std::vector<Cube> isop( const TT& tt )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  std::vector<Cube> cubes;
+  detail::isop_rec( tt, tt, tt.num_vars(), cubes );
+  return cubes;
+}
+
+/*! \cond PRIVATE */
+template<uint32_t NumVars>
+inline std::vector<cube> isop( const static_truth_table<NumVars, true>& tt )
+{
+  std::vector<cube> cubes;
+  const auto word = detail::isop_replicate( tt._bits, NumVars );
+  detail::isop_rec_word( word, word, NumVars, cubes );
+  return cubes;
+}
+/*! \endcond */
+
+/*! \brief Parameters for isop_cache */
+struct isop_cache_params
+{
+  /*! Memory budget in bytes for all stored entries (0 disables caching). */
+  uint64_t memory_budget{ UINT64_C( 64 ) << 20 };
+
+  /*! Number of independently locked stripes (rounded up to a power of 2). */
+  uint32_t num_stripes{ 64u };
+
+  /*! Number of slots that are probed for each key (rounded up to a power of 2). */
+  uint32_t associativity{ 4u };
+
+  /*! Only subproblems with at least this many variables are cached.  Smaller
+      subproblems are solved faster than they are looked up and stored. */
+  uint32_t min_vars{ 10u };
+};
+
+/*! \brief Statistics for isop_cache
+
+  Contains the number of hits and misses, the number of evicted and stored
+  entries, and the estimated memory usage in bytes.
+*/
+using isop_cache_statistics = detail::cache_statistics;
+
+/*! \brief Computed table for ISOP subproblems
+
+  Stores the results of ISOP subproblems that are computed by `isop_engine`.
+  A subproblem is identified by its onset and its care set (onset and don't
+  cares) after removing the variables above the top-most variable in its
+  support.  For each subproblem the cache stores the cover as truth table and
+  the cubes of the ISOP, which only contain literals of the variables in the
+  subproblem, such that they can be reused in any context in which the same
+  subproblem occurs, e.g., for different outputs of a multi-output function
+  or for repeated calls on related functions.
+
+  The cache is bounded by a memory budget and thread-safe.  It can be shared
+  by several engines, one for each thread.  Cached results are identical to
+  computed ones, therefore the ISOP does not depend on the cache contents.
+
+  Example:
+
+  \verbatim embed:rst
+  .. code-block:: c++
+
+     kitty::isop_cache cache;
+     kitty::isop_engine engine( 16u, &cache );
+     std::vector<kitty::cube> cubes;
+     for ( const auto& tt : outputs )
+     {
+       engine.run( tt, cubes );
+     }
+     std::cout << cache.statistics().hit_rate() << std::endl;
+  \endverbatim
+*/
+class isop_cache
+{
+  using value_type = std::pair<std::vector<uint64_t>, std::vector<cube>>;
+
+  /* compares a stored key to the concatenation of onset and care set */
+  struct matcher
+  {
+    bool operator()( const std::vector<uint64_t>& key ) const
+    {
+      return key.size() == 2u * num_words && std::equal( tt, tt + num_words, key.begin() ) && std::equal( dc, dc + num_words, key.begin() + num_words );
+    }
+
+    const uint64_t* tt;
+    const uint64_t* dc;
+    uint64_t num_words;
+  };
+
+public:
+  /*! \brief Constructor
+
+    \param ps Parameters
+  */
+  explicit isop_cache( const isop_cache_params& ps = {} )
+      : _min_vars( ps.min_vars ),
+        _cache( ps.memory_budget, ps.num_stripes, ps.associativity )
+  {
+  }
+
+  /*! \brief Smallest number of variables of cached subproblems */
+  uint32_t min_vars() const
+  {
+    return _min_vars;
+  }
+
+  /*! \brief Looks up a subproblem
+
+    On a hit, the cubes of the cover are appended to `cubes` and the first
+    `num_words` words of the cover are written to `res`.
+
+    \param tt Onset with `num_words` words
+    \param dc Care set with `num_words` words
+    \param num_words Number of words
+    \param res Resulting cover
+    \param cubes Cubes, to which the result is appended
+  */
+  bool find( const uint64_t* tt, const uint64_t* dc, uint64_t num_words, uint64_t* res, std::vector<cube>& cubes )
+  {
+    return _cache.find( key_hash( tt, dc, num_words ), matcher{ tt, dc, num_words }, [&]( const value_type& value ) {
+      std::copy( value.first.begin(), value.first.end(), res );
+      cubes.insert( cubes.end(), value.second.begin(), value.second.end() );
+    } );
+  }
+
+  /*! \brief Stores the result of a subproblem
+
+    \param tt Onset with `num_words` words
+    \param dc Care set with `num_words` words
+    \param num_words Number of words
+    \param res Cover with `num_words` words
+    \param cubes_begin Begin of the cubes of the cover
+    \param cubes_end End of the cubes of the cover
+  */
+  void insert( const uint64_t* tt, const uint64_t* dc, uint64_t num_words, const uint64_t* res,
+               std::vector<cube>::const_iterator cubes_begin, std::vector<cube>::const_iterator cubes_end )
+  {
+    std::vector<uint64_t> key( 2u * num_words );
+    std::copy( tt, tt + num_words, key.begin() );
+    std::copy( dc, dc + num_words, key.begin() + num_words );
+
+    _cache.insert( key_hash( tt, dc, num_words ), matcher{ tt, dc, num_words }, std::move( key ),
+                   value_type( std::vector<uint64_t>( res, res + num_words ), std::vector<cube>( cubes_begin, cubes_end ) ) );
+  }
+
+  /*! \brief Removes all entries
+
+    Statistics are not reset.
+  */
+  void clear()
+  {
+    _cache.clear();
+  }
+
+  /*! \brief Returns accumulated statistics over all stripes */
+  isop_cache_statistics statistics() const
+  {
+    return _cache.statistics();
+  }
+
+  /*! \brief Resets hit, miss, and eviction counters */
+  void reset_statistics()
+  {
+    _cache.reset_statistics();
+  }
+
+private:
+  static uint64_t key_hash( const uint64_t* tt, const uint64_t* dc, uint64_t num_words )
+  {
+    uint64_t h = num_words;
+    for ( auto i = 0u; i < num_words; ++i )
+    {
+      h = ( h ^ tt[i] ) * UINT64_C( 0x9e3779b97f4a7c15 );
+      h = ( h ^ dc[i] ) * UINT64_C( 0xff51afd7ed558ccd );
+      h ^= h >> 32;
+    }
+    return detail::mix_hash( h );
+  }
+
+private:
+  uint32_t _min_vars;
+  detail::striped_cache<std::vector<uint64_t>, value_type> _cache;
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+class parallel_isop_impl;
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Allocation-free ISOP computation
+
+  This class computes the same ISOP as `isop`, but it does not allocate
+  truth tables during the recursion.  Instead, it preallocates a scratch stack
+  with one set of tables for each recursion depth, in which the table size is
+  halved with each level, and computes cofactors and intermediate covers in
+  these tables.  Cofactors with respect to the upper variables are not copied
+  but accessed as the lower and upper half of the current table, and
+  subproblems with at most 6 variables are solved on single words in
+  registers.
+
+  The engine can be reused for many functions to amortize the allocation of
+  the scratch stack, which is resized if a function with more variables is
+  passed.  An engine must not be used concurrently from different threads.
+
+  Optionally, an `isop_cache` can be passed, in which the results of larger
+  subproblems are memoized.  Several engines may share the same cache.
+
+  Example:
+
+  \verbatim embed:rst
+  .. code-block:: c++
+
+     kitty::isop_engine engine( 16u );
+     std::vector<kitty::cube> cubes;
+     for ( const auto& tt : functions )
+     {
+       engine.run( tt, cubes ); // same result as kitty::isop( tt )
+     }
+  \endverbatim
+*/
+class isop_engine
+{
+  struct level
+  {
+    uint64_t* tt;
+    uint64_t* dc;
+    uint64_t* res0;
+    uint64_t* res1;
+    uint64_t* res2;
+  };
+
+public:
+  /*! \brief Constructor
+
+    \param num_vars Number of variables for which scratch tables are preallocated
+    \param cache Optional cache for subproblems
+  */
+  explicit isop_engine( uint32_t num_vars = 6u, isop_cache* cache = nullptr )
+      : _cache( cache )
+  {
+    reserve( num_vars );
+  }
+
+  /* scratch tables are referenced by pointers */
+  isop_engine( const isop_engine& ) = delete;
+  isop_engine& operator=( const isop_engine& ) = delete;
+  isop_engine( isop_engine&& ) = default;
+  isop_engine& operator=( isop_engine&& ) = default;
+
+  /*! \brief Sets the cache for subproblems (or disables it for `nullptr`) */
+  void set_cache( isop_cache* cache )
+  {
+    _cache = cache;
+  }
+
+  /*! \brief Preallocates scratch tables for functions with up to `num_vars` variables */
+  void reserve( uint32_t num_vars )
+  {
+    if ( num_vars <= _num_vars && !_levels.empty() )
+    {
+      return;
+    }
+    _num_vars = std::max( num_vars, 6u );
+
+    /* five tables for each level with 2^(v-6) words for children with v >= 6 variables, plus the result */
+    uint64_t total = num_words( _num_vars );
+    for ( auto v = 6u; v < _num_vars; ++v )
+    {
+      total += 5u * num_words( v );
+    }
+    _storage.assign( total, 0u );
+    _levels.resize( _num_vars );
+
+    auto* p = _storage.data();
+    _result = p;
+    p += num_words( _num_vars );
+    for ( auto v = 6u; v < _num_vars; ++v )
+    {
+      const auto w = num_words( v );
+      _levels[v] = { p, p + w, p + 2 * w, p + 3 * w, p + 4 * w };
+      p += 5 * w;
+    }
+  }
+
+  /*! \brief Computes ISOP representation
+
+    The cubes are written to `cubes`, which is cleared before.
+
+    \param tt Truth table
+    \param cubes Resulting cubes
+  */
+  template<typename TT>
+  void run( const TT& tt, std::vector<cube>& cubes )
+  {
+    run( tt, tt, cubes );
+  }
+
+  /*! \brief Computes ISOP representation of an incompletely specified function
+
+    Computes a cover that contains all minterms in `tt` and is contained in
+    `dc`, which is the union of the onset and the don't care set.  The cubes
+    are written to `cubes`, which is cleared before.
+
+    \param tt Truth table of onset
+    \param dc Truth table of onset and don't care set
+    \param cubes Resulting cubes
+  */
+  template<typename TT>
+  void run( const TT& tt, const TT& dc, std::vector<cube>& cubes )
+  {
+    static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+    assert( is_const0( tt & ~dc ) );
+
+    cubes.clear();
+
+    const auto num_vars = tt.num_vars();
+    if ( num_vars <= 6u )
+    {
+      const auto word_tt = detail::isop_replicate( *tt.cbegin(), num_vars );
+      const auto word_dc = detail::isop_replicate( *dc.cbegin(), num_vars );
+      detail::isop_rec_word( word_tt, word_dc, num_vars, cubes );
+      return;
+    }
+
+    reserve( num_vars );
+    rec( &( *tt.cbegin() ), &( *dc.cbegin() ), num_vars, _result, cubes );
+  }
+
+private:
+  friend class detail::parallel_isop_impl;
+
+  static inline uint64_t num_words( uint32_t num_vars )
+  {
+    return num_vars <= 6u ? 1u : ( uint64_t( 1 ) << ( num_vars - 6u ) );
+  }
+
+  static bool has_var( const uint64_t* tt, uint64_t words, uint32_t var_index )
+  {
+    if ( var_index < 6u )
+    {
+      return std::any_of( tt, tt + words, [var_index]( auto word ) { return detail::isop_has_var( word, var_index ); } );
+    }
+
+    const auto step = uint64_t( 1 ) << ( var_index - 6u );
+    for ( uint64_t i = 0u; i < words; i += 2 * step )
+    {
+      if ( !std::equal( tt + i, tt + i + step, tt + i + step ) )
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* computes the ISOP of tt and dc with 2^(num_vars - 6) words into res */
+  void rec( const uint64_t* tt, const uint64_t* dc, uint32_t num_vars, uint64_t* res, std::vector<cube>& cubes )
+  {
+    const auto words = num_words( num_vars );
+
+    if ( num_vars <= 6u )
+    {
+      *res = detail::isop_rec_word( *tt, *dc, num_vars, cubes );
+      return;
+    }
+
+    if ( std::all_of( tt, tt + words, []( auto word ) { return word == 0u; } ) )
+    {
+      std::fill( res, res + words, 0u );
+      return;
+    }
+
+    if ( std::all_of( dc, dc + words, []( auto word ) { return word == ~uint64_t( 0 ); } ) )
+    {
+      cubes.emplace_back(); /* add empty cube */
+      std::fill( res, res + words, ~uint64_t( 0 ) );
+      return;
+    }
+
+    int var = num_vars - 1;
+    for ( ; var >= 6; --var )
+    {
+      if ( has_var( tt, words, var ) || has_var( dc, words, var ) )
+      {
+        break;
+      }
+    }
+
+    if ( var < 6 )
+    {
+      /* the function only depends on the first word */
+      std::fill( res, res + words, detail::isop_rec_word( *tt, *dc, 6u, cubes ) );
+      return;
+    }
+
+    /* co-factors are the two halves of the first 2^(var - 5) words */
+    const auto half = num_words( var );
+    const auto* tt0 = tt;
+    const auto* tt1 = tt + half;
+    const auto* dc0 = dc;
+    const auto* dc1 = dc + half;
+    const auto& l = _levels[var];
+
+    const auto cached = _cache != nullptr && static_cast<uint32_t>( var ) + 1u >= _cache->min_vars();
+    if ( cached && _cache->find( tt, dc, 2 * half, res, cubes ) )
+    {
+      for ( auto i = 2 * half; i < words; i += 2 * half )
+      {
+        std::copy( res, res + 2 * half, res + i );
+      }
+      return;
+    }
+
+    const auto beg0 = cubes.size();
+    for ( auto i = 0u; i < half; ++i )
+    {
+      l.tt[i] = tt0[i] & ~dc1[i];
+    }
+    rec( l.tt, dc0, var, l.res0, cubes );
+    const auto end0 = cubes.size();
+
+    for ( auto i = 0u; i < half; ++i )
+    {
+      l.tt[i] = tt1[i] & ~dc0[i];
+    }
+    rec( l.tt, dc1, var, l.res1, cubes );
+    const auto end1 = cubes.size();
+
+    for ( auto i = 0u; i < half; ++i )
+    {
+      l.tt[i] = ( tt0[i] & ~l.res0[i] ) | ( tt1[i] & ~l.res1[i] );
+      l.dc[i] = dc0[i] & dc1[i];
+    }
+    rec( l.tt, l.dc, var, l.res2, cubes );
+
+    for ( auto i = 0u; i < half; ++i )
+    {
+      res[i] = l.res0[i] | l.res2[i];
+      res[half + i] = l.res1[i] | l.res2[i];
+    }
+    for ( auto i = 2 * half; i < words; i += 2 * half )
+    {
+      std::copy( res, res + 2 * half, res + i );
+    }
+
+    for ( auto c = beg0; c < end0; ++c )
+    {
+      cubes[c].add_literal( var, false );
+    }
+    for ( auto c = end0; c < end1; ++c )
+    {
+      cubes[c].add_literal( var, true );
+    }
+
+    if ( cached )
+    {
+      _cache->insert( tt, dc, 2 * half, res, cubes.cbegin() + beg0, cubes.cend() );
+    }
+  }
+
+private:
+  isop_cache* _cache{ nullptr };
+  uint32_t _num_vars{ 0u };
+  std::vector<uint64_t> _storage;
+  std::vector<level> _levels;
+  uint64_t* _result{ nullptr };
+};
+
+/*! \brief Parameters for parallel_isop */
+struct parallel_isop_params
+{
+  /*! Number of threads (0 = hardware concurrency). */
+  uint32_t num_threads{ 0u };
+
+  /*! Subproblems with fewer variables are not split into parallel tasks. */
+  uint32_t min_vars{ 14u };
+
+  /*! Number of recursion levels that are split into parallel tasks (0 = derived from number of threads). */
+  uint32_t parallel_depth{ 0u };
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+class parallel_isop_impl
+{
+public:
+  explicit parallel_isop_impl( const parallel_isop_params& ps )
+      : _pool( ps.num_threads ),
+        _engines( _pool.num_threads() ),
+        _min_vars( std::max( ps.min_vars, 7u ) ),
+        _depth( ps.parallel_depth )
+  {
+    if ( _depth == 0u )
+    {
+      /* about 4 tasks per thread for load balancing */
+      while ( ( 1u << _depth ) < 4u * _pool.num_threads() )
+      {
+        ++_depth;
+      }
+    }
+  }
+
+  void run( const uint64_t* tt, const uint64_t* dc, uint32_t num_vars, uint64_t* res, std::vector<cube>& cubes )
+  {
+    rec( tt, dc, num_vars, res, cubes, 0u );
+  }
+
+private:
+  /* solves a subproblem sequentially with the engine of the calling worker */
+  void leaf( const uint64_t* tt, const uint64_t* dc, uint32_t num_vars, uint64_t* res, std::vector<cube>& cubes )
+  {
+    auto& engine = _engines[_pool.worker_index()];
+    engine.reserve( num_vars );
+    engine.rec( tt, dc, num_vars, res, cubes );
+  }
+
+  void rec( const uint64_t* tt, const uint64_t* dc, uint32_t num_vars, uint64_t* res, std::vector<cube>& cubes, uint32_t depth )
+  {
+    if ( depth >= _depth || num_vars < _min_vars )
+    {
+      leaf( tt, dc, num_vars, res, cubes );
+      return;
+    }
+
+    const auto words = isop_engine::num_words( num_vars );
+    auto var = static_cast<int>( num_vars ) - 1;
+    for ( ; var >= 6; --var )
+    {
+      if ( isop_engine::has_var( tt, words, var ) || isop_engine::has_var( dc, words, var ) )
+      {
+        break;
+      }
+    }
+
+    /* terminal cases and small subproblems are handled like in the engine */
+    if ( static_cast<uint32_t>( var ) + 1u < _min_vars ||
+         std::all_of( tt, tt + words, []( auto word ) { return word == 0u; } ) ||
+         std::all_of( dc, dc + words, []( auto word ) { return word == ~uint64_t( 0 ); } ) )
+    {
+      leaf( tt, dc, num_vars, res, cubes );
+      return;
+    }
+
+    const auto half = isop_engine::num_words( var );
+    const auto* tt0 = tt;
+    const auto* tt1 = tt + half;
+    const auto* dc0 = dc;
+    const auto* dc1 = dc + half;
+
+    /* tables for tt0, tt1, tt2, dc2, res0, res1, res2 */
+    std::vector<uint64_t> storage( 7u * half );
+    auto* c_tt0 = storage.data();
+    auto* c_tt1 = c_tt0 + half;
+    auto* c_tt2 = c_tt1 + half;
+    auto* c_dc2 = c_tt2 + half;
+    auto* res0 = c_dc2 + half;
+    auto* res1 = res0 + half;
+    auto* res2 = res1 + half;
+
+    for ( auto i = 0u; i < half; ++i )
+    {
+      c_tt0[i] = tt0[i] & ~dc1[i];
+      c_tt1[i] = tt1[i] & ~dc0[i];
+    }
+
+    /* the first two subproblems are independent, each task writes into its own cube buffer */
+    std::vector<cube> cubes0, cubes1, cubes2;
+    task_group group;
+    _pool.submit( group, [&]() { rec( c_tt1, dc1, var, res1, cubes1, depth + 1u ); } );
+    rec( c_tt0, dc0, var, res0, cubes0, depth + 1u );
+    _pool.wait( group );
+
+    for ( auto i = 0u; i < half; ++i )
+    {
+      c_tt2[i] = ( tt0[i] & ~res0[i] ) | ( tt1[i] & ~res1[i] );
+      c_dc2[i] = dc0[i] & dc1[i];
+    }
+    rec( c_tt2, c_dc2, var, res2, cubes2, depth + 1u );
+
+    for ( auto i = 0u; i < half; ++i )
+    {
+      res[i] = res0[i] | res2[i];
+      res[half + i] = res1[i] | res2[i];
+    }
+    for ( auto i = 2 * half; i < words; i += 2 * half )
+    {
+      std::copy( res, res + 2 * half, res + i );
+    }
+
+    /* concatenate in the order of the sequential algorithm */
+    cubes.reserve( cubes.size() + cubes0.size() + cubes1.size() + cubes2.size() );
+    for ( auto& c : cubes0 )
+    {
+      c.add_literal( var, false );
+      cubes.push_back( c );
+    }
+    for ( auto& c : cubes1 )
+    {
+      c.add_literal( var, true );
+      cubes.push_back( c );
+    }
+    cubes.insert( cubes.end(), cubes2.begin(), cubes2.end() );
+  }
+
+private:
+  work_stealing_pool _pool;
+  std::vector<isop_engine> _engines;
+  uint32_t _min_vars;
+  uint32_t _depth;
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Computes ISOP representation in parallel
+
+  Computes the same ISOP as `isop` for large functions using several threads.
+  The two independent subproblems in each of the top-most recursion levels
+  are processed as parallel tasks by a work-stealing thread pool, and the
+  third subproblem is processed after both of them finished.  Subproblems
+  below these levels are solved with one `isop_engine` per thread.  Each task
+  writes its cubes into its own buffer and the buffers are concatenated in
+  the order of the sequential algorithm, such that the result is
+  deterministic and equal to the one of `isop`.
+
+  This function is intended for functions with 18 or more variables; for
+  functions with fewer than `ps.min_vars` variables it computes the ISOP
+  sequentially.
+
+  \param tt Truth table of onset
+  \param dc Truth table of onset and don't care set
+  \param ps Parameters
+*/
 template<typename TT>
-inline std::vector<cube> isop( const TT& tt )
+std::vector<cube> parallel_isop( const TT& tt, const TT& dc, const parallel_isop_params& ps = {} )
 {
   static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+  assert( is_const0( tt & ~dc ) );
 
   std::vector<cube> cubes;
-  detail::isop_rec( tt, tt, tt.num_vars(), cubes );
+  const auto num_vars = tt.num_vars();
+  if ( num_vars < std::max( ps.min_vars, 7u ) || ps.num_threads == 1u )
+  {
+    isop_engine engine( num_vars );
+    engine.run( tt, dc, cubes );
+    return cubes;
+  }
+
+  std::vector<uint64_t> res( tt.num_blocks() );
+  detail::parallel_isop_impl impl( ps );
+  impl.run( &( *tt.cbegin() ), &( *dc.cbegin() ), num_vars, res.data(), cubes );
   return cubes;
 }
 
-} /* namespace kitty */
\ No newline at end of file
+/*! \brief Computes ISOP representation in parallel
+
+  \param tt Truth table
+  \param ps Parameters
+*/
+template<typename TT>
+std::vector<cube> parallel_isop( const TT& tt, const parallel_isop_params& ps = {} )
+{
+  return parallel_isop( tt, tt, ps );
+}
+
+} /* namespace kitty */
@@ -39,25 +39,36 @@
 #include "affine.hpp"
 #include "algorithm.hpp"
 #include "bit_operations.hpp"
+#include "canonization_cache.hpp"
 #include "cnf.hpp"
 #include "constructors.hpp"
 #include "cube.hpp"
 #include "decomposition.hpp"
 #include "enumeration.hpp"
-//#include "esop.hpp" // deprecated!
+#include "equivalence_classes.hpp"
+#include "esop.hpp"
+#include "espresso.hpp"
+#include "exact_sop.hpp"
+#include "exorcism.hpp"
 #include "hash.hpp"
 #include "implicant.hpp"
 #include "isop.hpp"
 #include "karnaugh_map.hpp"
+#include "multi_output_truth_table.hpp"
 #include "npn.hpp"
 #include "operations.hpp"
 #include "operators.hpp"
+#include "pattern_store.hpp"
 #include "permutation.hpp"
 #include "print.hpp"
 #include "properties.hpp"
+#include "pseudo_cube.hpp"
+#include "resubstitution.hpp"
 #include "spectral.hpp"
 #include "spp.hpp"
 #include "traits.hpp"
+#include "truth_table_store.hpp"
+#include "wide_cube.hpp"
 
 /*
          /\___/\
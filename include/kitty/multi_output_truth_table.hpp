@@ -0,0 +1,573 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file multi_output_truth_table.hpp
+  \brief Implements multi-output truth tables
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "bit_operations.hpp"
+#include "constructors.hpp"
+#include "dynamic_truth_table.hpp"
+#include "hash.hpp"
+#include "traits.hpp"
+#include "detail/constants.hpp"
+#include "detail/transpose.hpp"
+
+namespace kitty
+{
+
+/*! \brief Converts truth tables into minterm-major words
+
+  For truth tables `tts` with the same number of bits, writes for each
+  minterm `m` the values of all truth tables at `m` into `words`, starting
+  at `words[m * w]` with `w = (tts.size() + 63) / 64` words per minterm,
+  such that bit `k % 64` of word `k / 64` is the value of `tts[k]`.  The
+  conversion transposes tiles of 64 x 64 bits with word-wide operations.
+
+  \param tts Truth tables
+  \param words Pointer to `w` words per minterm
+*/
+template<typename TT>
+void to_minterm_major( const std::vector<TT>& tts, uint64_t* words )
+{
+  if ( tts.empty() )
+  {
+    return;
+  }
+  const uint64_t words_per_minterm = ( tts.size() + 63u ) >> 6;
+  detail::transpose_bit_matrix(
+      tts.size(), tts.front().num_bits(),
+      [&]( auto k ) { return &*tts[k].cbegin(); },
+      [&]( auto m ) { return words + m * words_per_minterm; } );
+}
+
+/*! \brief Converts truth tables into minterm-major words
+
+  \param tts Truth tables
+  \return `tts.front().num_bits() * (tts.size() + 63) / 64` words
+*/
+template<typename TT>
+std::vector<uint64_t> to_minterm_major( const std::vector<TT>& tts )
+{
+  std::vector<uint64_t> words( tts.empty() ? 0u : tts.front().num_bits() * ( ( tts.size() + 63u ) >> 6 ) );
+  to_minterm_major( tts, words.data() );
+  return words;
+}
+
+/*! \brief Creates truth tables from minterm-major words
+
+  Inverse of `to_minterm_major`.  The truth tables in `tts` must have been
+  constructed with the same number of bits, which determines the number of
+  minterms, and `tts.size()` determines the number of words per minterm.
+
+  \param tts Truth tables
+  \param words Pointer to minterm-major words
+*/
+template<typename TT>
+void create_from_minterm_major( std::vector<TT>& tts, const uint64_t* words )
+{
+  if ( tts.empty() )
+  {
+    return;
+  }
+  const uint64_t words_per_minterm = ( tts.size() + 63u ) >> 6;
+  detail::transpose_bit_matrix(
+      tts.front().num_bits(), tts.size(),
+      [&]( auto m ) { return words + m * words_per_minterm; },
+      [&]( auto k ) { return &*tts[k].begin(); } );
+}
+
+/*! \brief Truth table with multiple outputs
+
+  Stores the values of all outputs for each minterm contiguously, i.e., in
+  minterm-major order, with `words_per_minterm()` words per minterm.  This
+  is the layout in which, e.g., an S-box or a lookup table is evaluated,
+  and it is converted from and into single-output truth tables by bit-matrix
+  transposition.
+*/
+class multi_output_truth_table
+{
+public:
+  /*! \brief Constructs an empty multi-output truth table */
+  multi_output_truth_table() = default;
+
+  /*! \brief Constructs a multi-output truth table with all outputs 0
+
+    \param num_vars Number of variables
+    \param num_outputs Number of outputs
+  */
+  multi_output_truth_table( uint32_t num_vars, uint32_t num_outputs )
+      : _num_vars( num_vars ),
+        _num_outputs( num_outputs ),
+        _words_per_minterm( ( num_outputs + 63u ) >> 6 ),
+        _bits( ( uint64_t( 1 ) << num_vars ) * _words_per_minterm )
+  {
+  }
+
+  /*! \brief Constructs a multi-output truth table from truth tables
+
+    \param outputs Complete truth tables of the same number of variables
+  */
+  template<typename TT, typename = std::enable_if_t<is_complete_truth_table<TT>::value>>
+  explicit multi_output_truth_table( const std::vector<TT>& outputs )
+      : multi_output_truth_table( outputs.empty() ? 0u : static_cast<uint32_t>( outputs.front().num_vars() ), static_cast<uint32_t>( outputs.size() ) )
+  {
+    to_minterm_major( outputs, _bits.data() );
+  }
+
+  /*! \brief Returns number of variables */
+  inline uint32_t num_vars() const noexcept { return _num_vars; }
+
+  /*! \brief Returns number of outputs */
+  inline uint32_t num_outputs() const noexcept { return _num_outputs; }
+
+  /*! \brief Returns number of minterms */
+  inline uint64_t num_minterms() const noexcept { return uint64_t( 1 ) << _num_vars; }
+
+  /*! \brief Returns number of words per minterm */
+  inline uint32_t words_per_minterm() const noexcept { return _words_per_minterm; }
+
+  /*! \brief Returns the words with the output values of a minterm */
+  inline const uint64_t* minterm( uint64_t index ) const
+  {
+    return _bits.data() + index * _words_per_minterm;
+  }
+
+  /*! \brief Returns the words with the output values of a minterm */
+  inline uint64_t* minterm( uint64_t index )
+  {
+    return _bits.data() + index * _words_per_minterm;
+  }
+
+  /*! \brief Returns the value of an output at a minterm */
+  inline bool get_bit( uint64_t index, uint32_t output ) const
+  {
+    return ( minterm( index )[output >> 6] >> ( output & 0x3f ) ) & 1;
+  }
+
+  /*! \brief Sets the value of an output at a minterm to 1 */
+  inline void set_bit( uint64_t index, uint32_t output )
+  {
+    minterm( index )[output >> 6] |= uint64_t( 1 ) << ( output & 0x3f );
+  }
+
+  /*! \brief Sets the value of an output at a minterm to 0 */
+  inline void clear_bit( uint64_t index, uint32_t output )
+  {
+    minterm( index )[output >> 6] &= ~( uint64_t( 1 ) << ( output & 0x3f ) );
+  }
+
+  /*! \brief Returns one output as a truth table
+
+    \param index Output index
+  */
+  template<typename TT = dynamic_truth_table>
+  TT output( uint32_t index ) const
+  {
+    auto tt = create<TT>( _num_vars );
+    for ( uint64_t m = 0u; m < num_minterms(); ++m )
+    {
+      if ( get_bit( m, index ) )
+      {
+        kitty::set_bit( tt, m );
+      }
+    }
+    return tt;
+  }
+
+  /*! \brief Returns all outputs as truth tables */
+  template<typename TT = dynamic_truth_table>
+  std::vector<TT> outputs() const
+  {
+    std::vector<TT> tts( _num_outputs, create<TT>( _num_vars ) );
+    create_from_minterm_major( tts, _bits.data() );
+    return tts;
+  }
+
+  /*! \brief Checks whether two multi-output truth tables are equal */
+  inline bool operator==( const multi_output_truth_table& other ) const
+  {
+    return _num_vars == other._num_vars && _num_outputs == other._num_outputs && _bits == other._bits;
+  }
+
+  /*! \brief Checks whether two multi-output truth tables are different */
+  inline bool operator!=( const multi_output_truth_table& other ) const
+  {
+    return !( *this == other );
+  }
+
+  /*! \brief Checks whether a multi-output truth table is smaller than another
+
+    Minterms are compared from the last to the first one, and the outputs of
+    a minterm from the last to the first one.  For a single output, this is
+    the order of single-output truth tables.  Both truth tables must have
+    the same number of variables and outputs.
+  */
+  inline bool operator<( const multi_output_truth_table& other ) const
+  {
+    assert( _num_vars == other._num_vars && _num_outputs == other._num_outputs );
+    return std::lexicographical_compare( _bits.rbegin(), _bits.rend(), other._bits.rbegin(), other._bits.rend() );
+  }
+
+  /*! \cond PRIVATE */
+public: /* fields */
+  uint32_t _num_vars{ 0u };
+  uint32_t _num_outputs{ 0u };
+  uint32_t _words_per_minterm{ 0u };
+  std::vector<uint64_t> _bits;
+  /*! \endcond */
+};
+
+/*! \brief Swaps two variables in all outputs
+
+  \param mo Multi-output truth table
+  \param var_index1 First variable
+  \param var_index2 Second variable
+*/
+inline void swap_inplace( multi_output_truth_table& mo, uint8_t var_index1, uint8_t var_index2 )
+{
+  if ( var_index1 == var_index2 )
+  {
+    return;
+  }
+  if ( var_index1 > var_index2 )
+  {
+    std::swap( var_index1, var_index2 );
+  }
+
+  /* exchanges the runs of minterms with bits (1, 0) and (0, 1) */
+  const uint64_t run1 = ( uint64_t( 1 ) << var_index1 ) * mo._words_per_minterm;
+  const uint64_t run2 = ( uint64_t( 1 ) << var_index2 ) * mo._words_per_minterm;
+  const auto bits = mo._bits.data();
+  for ( uint64_t i = 0u; i < mo._bits.size(); i += 2u * run2 )
+  {
+    for ( auto j = i; j < i + run2; j += 2u * run1 )
+    {
+      std::swap_ranges( bits + j + run1, bits + j + 2u * run1, bits + j + run2 );
+    }
+  }
+}
+
+/*! \brief Swaps two adjacent variables in all outputs
+
+  \param mo Multi-output truth table
+  \param var_index Variable, which is swapped with `var_index + 1`
+*/
+inline void swap_adjacent_inplace( multi_output_truth_table& mo, uint8_t var_index )
+{
+  swap_inplace( mo, var_index, var_index + 1 );
+}
+
+/*! \brief Flips a variable in all outputs
+
+  \param mo Multi-output truth table
+  \param var_index Variable
+*/
+inline void flip_inplace( multi_output_truth_table& mo, uint8_t var_index )
+{
+  const uint64_t run = ( uint64_t( 1 ) << var_index ) * mo._words_per_minterm;
+  const auto bits = mo._bits.data();
+  for ( uint64_t i = 0u; i < mo._bits.size(); i += 2u * run )
+  {
+    std::swap_ranges( bits + i, bits + i + run, bits + i + run );
+  }
+}
+
+/*! \brief Computes the co-factor with respect to 0 of all outputs
+
+  \param mo Multi-output truth table
+  \param var_index Variable
+*/
+inline void cofactor0_inplace( multi_output_truth_table& mo, uint8_t var_index )
+{
+  const uint64_t run = ( uint64_t( 1 ) << var_index ) * mo._words_per_minterm;
+  const auto bits = mo._bits.data();
+  for ( uint64_t i = 0u; i < mo._bits.size(); i += 2u * run )
+  {
+    std::copy( bits + i, bits + i + run, bits + i + run );
+  }
+}
+
+/*! \brief Computes the co-factor with respect to 1 of all outputs
+
+  \param mo Multi-output truth table
+  \param var_index Variable
+*/
+inline void cofactor1_inplace( multi_output_truth_table& mo, uint8_t var_index )
+{
+  const uint64_t run = ( uint64_t( 1 ) << var_index ) * mo._words_per_minterm;
+  const auto bits = mo._bits.data();
+  for ( uint64_t i = 0u; i < mo._bits.size(); i += 2u * run )
+  {
+    std::copy( bits + i + run, bits + i + 2u * run, bits + i );
+  }
+}
+
+/*! \brief Extends a multi-output truth table to more variables
+
+  The multi-output truth table `mo` must have at least as many variables as
+  `from` and the same number of outputs.  Its outputs are the outputs of
+  `from`, which do not depend on the additional variables.
+
+  \param mo Multi-output truth table with more variables
+  \param from Multi-output truth table
+*/
+inline void extend_to_inplace( multi_output_truth_table& mo, const multi_output_truth_table& from )
+{
+  assert( mo.num_vars() >= from.num_vars() && mo.num_outputs() == from.num_outputs() );
+
+  std::copy( from._bits.begin(), from._bits.end(), mo._bits.begin() );
+  for ( auto size = from._bits.size(); size < mo._bits.size(); size <<= 1 )
+  {
+    std::copy( mo._bits.begin(), mo._bits.begin() + size, mo._bits.begin() + size );
+  }
+}
+
+/*! \brief Extends a multi-output truth table to more variables
+
+  Out-of-place version of `extend_to_inplace`.
+
+  \param from Multi-output truth table
+  \param num_vars Number of variables
+*/
+inline multi_output_truth_table extend_to( const multi_output_truth_table& from, unsigned num_vars )
+{
+  multi_output_truth_table mo( num_vars, from.num_outputs() );
+  extend_to_inplace( mo, from );
+  return mo;
+}
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* compares a with its outputs negated such that the last minterm is 0 to b */
+inline bool multi_output_less_normalized( const multi_output_truth_table& a, const multi_output_truth_table& b )
+{
+  const auto w = a._words_per_minterm;
+  const auto last = a._bits.data() + a._bits.size() - w;
+  for ( auto i = a._bits.size(); i-- > 0u; )
+  {
+    const auto word = a._bits[i] ^ last[i % w];
+    if ( word != b._bits[i] )
+    {
+      return word < b._bits[i];
+    }
+  }
+  return false;
+}
+
+inline void multi_output_normalize( multi_output_truth_table& mo, std::vector<uint64_t>& phase )
+{
+  const auto w = mo._words_per_minterm;
+  phase.assign( mo._bits.end() - w, mo._bits.end() );
+  for ( auto i = 0u; i < mo._bits.size(); ++i )
+  {
+    mo._bits[i] ^= phase[i % w];
+  }
+}
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Exact P canonization of a multi-output truth table
+
+  Finds the smallest multi-output truth table, with respect to `operator<`,
+  that is obtained by permuting the inputs of all outputs in the same way.
+  For a single output, the result is the same as for the single-output
+  truth table.  Each of the `n!` permutations is obtained by one
+  adjacent swap of all outputs in a single pass.
+
+  The result is a tuple of
+
+  - the P representative
+  - input negations, which is 0 in this case
+  - input permutation to apply
+
+  \param mo Multi-output truth table (with at most 7 variables)
+  \return P configuration
+*/
+inline std::tuple<multi_output_truth_table, uint32_t, std::vector<uint8_t>> exact_p_canonization( const multi_output_truth_table& mo )
+{
+  const auto num_vars = mo.num_vars();
+  std::vector<uint8_t> perm( num_vars );
+  std::iota( perm.begin(), perm.end(), 0u );
+  if ( num_vars < 2u )
+  {
+    return std::make_tuple( mo, 0u, perm );
+  }
+
+  assert( num_vars <= 7u );
+
+  auto t1 = mo;
+  auto tmin = t1;
+
+  const auto& swaps = detail::swaps[num_vars - 2u];
+  int best_swap = -1;
+  for ( std::size_t i = 0; i < swaps.size(); ++i )
+  {
+    swap_adjacent_inplace( t1, swaps[i] );
+    if ( t1 < tmin )
+    {
+      best_swap = static_cast<int>( i );
+      tmin = t1;
+    }
+  }
+
+  for ( auto i = 0; i <= best_swap; ++i )
+  {
+    std::swap( perm[swaps[i]], perm[swaps[i] + 1] );
+  }
+  return std::make_tuple( tmin, 0u, perm );
+}
+
+/*! \brief Exact NPN canonization of a multi-output truth table
+
+  Finds the smallest multi-output truth table, with respect to `operator<`,
+  that is obtained by negating and permuting the inputs of all outputs in
+  the same way and by negating single outputs.  The outputs are not
+  permuted.  For each input transformation, the output negations are
+  chosen such that all outputs are 0 in the last minterm, which gives the
+  smallest multi-output truth table for this input transformation.  For a
+  single output, the result is the same as for the single-output truth
+  table.
+
+  The result is a tuple of
+
+  - the NPN representative
+  - input negations
+  - input permutation to apply
+  - output negations, with the same layout as the words of a minterm
+
+  \param mo Multi-output truth table (with at most 6 variables)
+  \return NPN configuration
+*/
+inline std::tuple<multi_output_truth_table, uint32_t, std::vector<uint8_t>, std::vector<uint64_t>> exact_npn_canonization( const multi_output_truth_table& mo )
+{
+  const auto num_vars = mo.num_vars();
+  assert( num_vars <= 6u );
+
+  std::vector<uint8_t> perm( num_vars );
+  std::iota( perm.begin(), perm.end(), 0u );
+
+  auto t1 = mo;
+  auto tmin = t1;
+  std::vector<uint64_t> phase;
+  detail::multi_output_normalize( tmin, phase );
+
+  /* the flip sequences start with 2 variables */
+  if ( num_vars < 2u )
+  {
+    uint32_t input_phase = 0u;
+    if ( num_vars == 1u )
+    {
+      flip_inplace( t1, 0u );
+      if ( detail::multi_output_less_normalized( t1, tmin ) )
+      {
+        tmin = t1;
+        detail::multi_output_normalize( tmin, phase );
+        input_phase = 1u;
+      }
+    }
+    return std::make_tuple( tmin, input_phase, perm, phase );
+  }
+
+  const auto& swaps = detail::swaps[num_vars - 2u];
+  const auto& flips = detail::flips[num_vars - 2u];
+
+  int best_swap = -1;
+  int best_flip = -1;
+
+  const auto update = [&]( int swap, int flip ) {
+    if ( detail::multi_output_less_normalized( t1, tmin ) )
+    {
+      best_swap = swap;
+      best_flip = flip;
+      tmin = t1;
+      detail::multi_output_normalize( tmin, phase );
+    }
+  };
+
+  for ( std::size_t i = 0; i < swaps.size(); ++i )
+  {
+    swap_adjacent_inplace( t1, swaps[i] );
+    update( static_cast<int>( i ), -1 );
+  }
+
+  for ( std::size_t j = 0; j < flips.size(); ++j )
+  {
+    swap_adjacent_inplace( t1, 0 );
+    flip_inplace( t1, flips[j] );
+    update( -1, static_cast<int>( j ) );
+
+    for ( std::size_t i = 0; i < swaps.size(); ++i )
+    {
+      swap_adjacent_inplace( t1, swaps[i] );
+      update( static_cast<int>( i ), static_cast<int>( j ) );
+    }
+  }
+
+  for ( auto i = 0; i <= best_swap; ++i )
+  {
+    std::swap( perm[swaps[i]], perm[swaps[i] + 1] );
+  }
+
+  uint32_t input_phase = 0u;
+  for ( auto i = 0; i <= best_flip; ++i )
+  {
+    input_phase ^= 1 << flips[i];
+  }
+
+  return std::make_tuple( tmin, input_phase, perm, phase );
+}
+
+/*! \cond PRIVATE */
+template<>
+struct hash<multi_output_truth_table> : detail::hash_seed
+{
+  using detail::hash_seed::hash_seed;
+
+  std::size_t operator()( const multi_output_truth_table& mo ) const
+  {
+    const auto shape = ( uint64_t( mo._num_vars ) << 32 ) | mo._num_outputs;
+    return hash_words( mo._bits.data(), mo._bits.size(), detail::hash_mum( seed ^ detail::hash_secret[2], shape ) );
+  }
+};
+/*! \endcond */
+
+} /* namespace kitty */
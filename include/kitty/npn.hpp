@@ -32,10 +32,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <numeric>
-
+#include <optional>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "bit_operations.hpp"
+#include "constructors.hpp"
 #include "detail/constants.hpp"
 #include "operators.hpp"
+#include "spectral.hpp"
 #include "traits.hpp"
 
 namespace kitty
@@ -50,6 +61,20 @@ void exact_npn_canonization_null_callback( const TT& tt )
 {
   (void)tt;
 }
+
+/* order in which canonization algorithms search for the smallest representative */
+template<typename TT>
+inline bool npn_less( const TT& first, const TT& second )
+{
+  return first < second;
+}
+
+/* ternary truth tables are compared by care set first, then by onset */
+template<typename TT>
+inline bool npn_less( const ternary_truth_table<TT>& first, const ternary_truth_table<TT>& second )
+{
+  return first._care < second._care || ( first._care == second._care && first._bits < second._bits );
+}
 } /* namespace detail */
 /*! \endcond */
 
@@ -440,7 +465,7 @@ void sifting_npn_canonization_loop( TT& npn, uint32_t& phase, std::vector<uint8_
         if ( k % 4u == 0u )
         {
           const auto next_t = swap( npn, i, i + 1 );
-          if ( next_t < npn )
+          if ( npn_less( next_t, npn ) )
           {
             npn = next_t;
             std::swap( perm[i], perm[i + 1] );
@@ -450,7 +475,7 @@ void sifting_npn_canonization_loop( TT& npn, uint32_t& phase, std::vector<uint8_
         else if ( k % 2u == 0u )
         {
           const auto next_t = flip( npn, i + 1 );
-          if ( next_t < npn )
+          if ( npn_less( next_t, npn ) )
           {
             npn = next_t;
             phase ^= 1 << perm[i + 1];
@@ -460,7 +485,7 @@ void sifting_npn_canonization_loop( TT& npn, uint32_t& phase, std::vector<uint8_
         else
         {
           const auto next_t = flip( npn, i );
-          if ( next_t < npn )
+          if ( npn_less( next_t, npn ) )
           {
             npn = next_t;
             phase ^= 1 << perm[i];
@@ -496,7 +521,7 @@ void sifting_p_canonization_loop( TT& p, uint32_t& phase, std::vector<uint8_t>&
       auto local_improvement = false;
 
       const auto next_t = swap( p, i, i + 1 );
-      if ( next_t < p )
+      if ( npn_less( next_t, p ) )
       {
         p = next_t;
         std::swap( perm[i], perm[i + 1] );
@@ -563,7 +588,7 @@ std::tuple<TT, uint32_t, std::vector<uint8_t>> sifting_npn_canonization( const T
 
   detail::sifting_npn_canonization_loop( npn, phase, perm );
 
-  if ( best_npn < npn )
+  if ( detail::npn_less( best_npn, npn ) )
   {
     perm = best_perm;
     phase = best_phase;
@@ -613,6 +638,259 @@ std::tuple<TT, uint32_t, std::vector<uint8_t>> sifting_p_canonization( const TT&
   return std::make_tuple( npn, phase, perm );
 }
 
+/*! \brief Sifting NP heuristic
+
+  The algorithm will always consider two adjacent variables and try all possible
+  input transformations on these two.  It will try once in forward direction and
+  once in backward direction.  In contrast to `sifting_npn_canonization`, the
+  output is not complemented.
+
+  The function returns a NPN configuration which contains the necessary
+  transformations to obtain the representative.  It is a tuple of
+
+  - the NP representative
+  - input negations, output negation is always 0
+  - input permutation to apply
+
+  \param tt Truth table
+  \return NPN configuration
+*/
+template<typename TT>
+std::tuple<TT, uint32_t, std::vector<uint8_t>> sifting_np_canonization( const TT& tt )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  const auto num_vars = tt.num_vars();
+
+  /* initialize permutation and phase */
+  std::vector<uint8_t> perm( num_vars );
+  std::iota( perm.begin(), perm.end(), 0u );
+  uint32_t phase{ 0u };
+
+  if ( num_vars < 2u )
+  {
+    return std::make_tuple( tt, phase, perm );
+  }
+
+  auto np = tt;
+
+  detail::sifting_npn_canonization_loop( np, phase, perm );
+
+  return std::make_tuple( np, phase, perm );
+}
+
+/*! \brief Parameters for multi_start_sifting_npn_canonization */
+struct multi_start_sifting_params
+{
+  /*! Number of randomized restarts in addition to the initial ordering. */
+  uint32_t num_restarts{ 16u };
+
+  /*! Number of worker threads (0 uses the hardware concurrency). */
+  uint32_t num_threads{ 1u };
+
+  /*! Time budget after which no further restart is started (0 means no limit). */
+  std::chrono::microseconds time_budget{ 0 };
+
+  /*! Seed for the random initial orderings. */
+  uint64_t seed{ 0xcafeu };
+};
+
+/*! \brief Statistics for multi_start_sifting_npn_canonization */
+struct multi_start_sifting_stats
+{
+  /*! Number of performed restarts (including the initial ordering). */
+  uint32_t restarts{ 0u };
+
+  /*! Index of the restart that found the returned representative. */
+  uint32_t best_restart{ 0u };
+
+  /*! Total runtime. */
+  std::chrono::microseconds time{ 0 };
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+template<typename TT>
+std::tuple<TT, uint32_t, std::vector<uint8_t>> sifting_npn_canonization_restart( const TT& tt, uint32_t restart, uint64_t seed )
+{
+  const auto num_vars = tt.num_vars();
+
+  /* random initial ordering and input polarity (restart 0 keeps the identity) */
+  std::vector<uint8_t> init_perm( num_vars );
+  std::iota( init_perm.begin(), init_perm.end(), 0u );
+  uint64_t init_flips{ 0u };
+
+  std::default_random_engine gen( static_cast<std::default_random_engine::result_type>( seed + restart ) );
+  if ( restart != 0u )
+  {
+    std::shuffle( init_perm.begin(), init_perm.end(), gen );
+    init_flips = std::uniform_int_distribution<uint64_t>()( gen );
+  }
+
+  std::tuple<TT, uint32_t, std::vector<uint8_t>> best;
+
+  for ( auto polarity = 0u; polarity < 2u; ++polarity )
+  {
+    auto npn = polarity ? ~tt : tt;
+    uint32_t phase = polarity << num_vars;
+    std::vector<uint8_t> perm( num_vars );
+    std::iota( perm.begin(), perm.end(), 0u );
+
+    /* move variable init_perm[i] to position i */
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      const auto j = static_cast<uint32_t>( std::find( perm.begin() + i, perm.end(), init_perm[i] ) - perm.begin() );
+      if ( i != j )
+      {
+        swap_inplace( npn, i, j );
+        std::swap( perm[i], perm[j] );
+      }
+    }
+
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      if ( ( init_flips >> i ) & 1 )
+      {
+        flip_inplace( npn, i );
+        phase ^= 1 << perm[i];
+      }
+    }
+
+    sifting_npn_canonization_loop( npn, phase, perm );
+
+    if ( polarity == 0u || npn_less( npn, std::get<0>( best ) ) )
+    {
+      best = std::make_tuple( npn, phase, perm );
+    }
+  }
+
+  return best;
+}
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Multi-start sifting NPN heuristic
+
+  The sifting heuristic (see `sifting_npn_canonization`) often ends in a local
+  minimum that depends on the initial variable ordering.  This function runs
+  the sifting heuristic several times, each time starting from a different
+  random input permutation and input negation, and returns the smallest
+  representative found.  The first run uses the identity ordering, hence the
+  result is never worse than the one of `sifting_npn_canonization`.
+
+  Restarts can be distributed over several threads.  Since each restart
+  derives its random ordering from the seed and its index, the result does not
+  depend on the number of threads as long as no time budget is given.  If a
+  time budget is given, no new restart is started after it has expired.
+
+  The function returns a NPN configuration which contains the necessary
+  transformations to obtain the representative.  It is a tuple of
+
+  - the NPN representative
+  - input negations and output negation, output negation is stored as bit *n*,
+    where *n* is the number of variables in `tt`
+  - input permutation to apply
+
+  \param tt Truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+  \return NPN configuration
+*/
+template<typename TT>
+std::tuple<TT, uint32_t, std::vector<uint8_t>> multi_start_sifting_npn_canonization( const TT& tt, const multi_start_sifting_params& ps = {}, multi_start_sifting_stats* pst = nullptr )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + ps.time_budget;
+  const auto num_runs = ps.num_restarts + 1u;
+
+  if ( tt.num_vars() < 2u )
+  {
+    if ( pst )
+    {
+      *pst = multi_start_sifting_stats{ 1u, 0u, std::chrono::microseconds( 0 ) };
+    }
+    return sifting_npn_canonization( tt );
+  }
+
+  auto num_threads = ps.num_threads == 0u ? std::max( std::thread::hardware_concurrency(), 1u ) : ps.num_threads;
+  num_threads = std::min( num_threads, num_runs );
+
+  struct result_t
+  {
+    std::tuple<TT, uint32_t, std::vector<uint8_t>> config;
+    uint32_t restart{ 0u };
+    uint32_t runs{ 0u };
+    bool valid{ false };
+  };
+  std::vector<result_t> results( num_threads );
+  std::atomic<uint32_t> next{ 0u };
+
+  const auto worker = [&]( uint32_t id ) {
+    auto& res = results[id];
+    while ( true )
+    {
+      const auto restart = next.fetch_add( 1u );
+      if ( restart >= num_runs || ( restart != 0u && ps.time_budget.count() != 0 && std::chrono::steady_clock::now() >= deadline ) )
+      {
+        break;
+      }
+
+      auto config = detail::sifting_npn_canonization_restart( tt, restart, ps.seed );
+      ++res.runs;
+
+      /* ties are broken towards smaller restart index to be deterministic */
+      if ( !res.valid || detail::npn_less( std::get<0>( config ), std::get<0>( res.config ) ) || ( std::get<0>( config ) == std::get<0>( res.config ) && restart < res.restart ) )
+      {
+        res.config = std::move( config );
+        res.restart = restart;
+        res.valid = true;
+      }
+    }
+  };
+
+  if ( num_threads == 1u )
+  {
+    worker( 0u );
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    for ( auto i = 0u; i < num_threads; ++i )
+    {
+      threads.emplace_back( worker, i );
+    }
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+  }
+
+  auto best = std::find_if( results.begin(), results.end(), []( const auto& r ) { return r.valid; } );
+  uint32_t runs{ 0u };
+  for ( auto it = results.begin(); it != results.end(); ++it )
+  {
+    runs += it->runs;
+    if ( it->valid && ( detail::npn_less( std::get<0>( it->config ), std::get<0>( best->config ) ) || ( std::get<0>( it->config ) == std::get<0>( best->config ) && it->restart < best->restart ) ) )
+    {
+      best = it;
+    }
+  }
+
+  if ( pst )
+  {
+    pst->restarts = runs;
+    pst->best_restart = best->restart;
+    pst->time = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start );
+  }
+
+  return best->config;
+}
+
 /*! \brief Exact NP enumeration
 
   Given a truth table, this function enumerates all the functions in its
@@ -943,4 +1221,492 @@ TT create_from_npn_config( const std::tuple<TT, uint32_t, std::vector<uint8_t>>&
   return res;
 }
 
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* cofactor signatures used to constrain the search in npn_match */
+struct npn_match_signature
+{
+  template<typename TT>
+  explicit npn_match_signature( const TT& tt )
+      : num_vars( tt.num_vars() ),
+        ones( count_ones( tt ) ),
+        ones1( num_vars ),
+        ones11( num_vars * num_vars )
+  {
+    std::vector<TT> vars( num_vars, tt.construct() );
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      create_nth_var( vars[i], i );
+      vars[i] &= tt;
+      ones1[i] = count_ones( vars[i] );
+    }
+
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      for ( auto k = i + 1; k < num_vars; ++k )
+      {
+        ones11[i * num_vars + k] = ones11[k * num_vars + i] = count_ones( vars[i] & vars[k] );
+      }
+    }
+  }
+
+  /* number of ones in the cofactor x_i = a */
+  inline uint64_t cofactor( uint32_t i, bool a ) const
+  {
+    return a ? ones1[i] : ones - ones1[i];
+  }
+
+  /* number of ones in the cofactor x_i = a, x_k = b */
+  inline uint64_t cofactor( uint32_t i, bool a, uint32_t k, bool b ) const
+  {
+    const auto n11 = ones11[i * num_vars + k];
+    if ( a && b )
+    {
+      return n11;
+    }
+    if ( a )
+    {
+      return ones1[i] - n11;
+    }
+    if ( b )
+    {
+      return ones1[k] - n11;
+    }
+    return ones - ones1[i] - ones1[k] + n11;
+  }
+
+  /* sorted list of unordered cofactor pairs, invariant under input negation and permutation */
+  std::vector<std::pair<uint64_t, uint64_t>> cofactor_multiset() const
+  {
+    std::vector<std::pair<uint64_t, uint64_t>> pairs( num_vars );
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      pairs[i] = std::minmax( cofactor( i, false ), cofactor( i, true ) );
+    }
+    std::sort( pairs.begin(), pairs.end() );
+    return pairs;
+  }
+
+  uint32_t num_vars;
+  uint64_t ones;
+  std::vector<uint64_t> ones1;
+  std::vector<uint64_t> ones11;
+};
+
+template<typename TT>
+class npn_match_impl
+{
+public:
+  npn_match_impl( const TT& f, const TT& g, bool out_neg )
+      : f( f ),
+        g( g ),
+        sf( f ),
+        sg( out_neg ? ~g : g ),
+        num_vars( f.num_vars() ),
+        perm( num_vars ),
+        used( num_vars, false ),
+        phase( static_cast<uint32_t>( out_neg ) << num_vars )
+  {
+    /* assign the variables with the rarest signature first */
+    order.resize( num_vars );
+    std::iota( order.begin(), order.end(), 0u );
+    std::vector<uint32_t> candidates( num_vars, 0u );
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      for ( auto j = 0u; j < num_vars; ++j )
+      {
+        candidates[i] += compatible_polarities( i, j ) != 0u;
+      }
+    }
+    std::stable_sort( order.begin(), order.end(), [&]( auto a, auto b ) { return candidates[a] < candidates[b]; } );
+  }
+
+  std::optional<std::tuple<TT, uint32_t, std::vector<uint8_t>>> run()
+  {
+    if ( search( 0u ) )
+    {
+      return std::make_tuple( f, phase, perm );
+    }
+    return std::nullopt;
+  }
+
+private:
+  /* bit 0: variable i of f can be mapped to variable j of g, bit 1: same with negation */
+  inline uint32_t compatible_polarities( uint32_t i, uint32_t j ) const
+  {
+    uint32_t res{ 0u };
+    if ( sf.cofactor( i, false ) == sg.cofactor( j, false ) )
+    {
+      res |= 1u;
+    }
+    if ( sf.cofactor( i, true ) == sg.cofactor( j, false ) )
+    {
+      res |= 2u;
+    }
+    return res;
+  }
+
+  bool search( uint32_t level )
+  {
+    if ( level == num_vars )
+    {
+      return create_from_npn_config( std::make_tuple( f, phase, perm ) ) == g;
+    }
+
+    const auto i = order[level];
+    for ( auto j = 0u; j < num_vars; ++j )
+    {
+      if ( used[j] )
+      {
+        continue;
+      }
+
+      const auto pols = compatible_polarities( i, j );
+      for ( auto p = 0u; p < 2u; ++p )
+      {
+        if ( ( ( pols >> p ) & 1u ) == 0u || !consistent( level, i, j, p ) )
+        {
+          continue;
+        }
+
+        perm[i] = static_cast<uint8_t>( j );
+        phase ^= p << j;
+        used[j] = true;
+
+        if ( search( level + 1u ) )
+        {
+          return true;
+        }
+
+        used[j] = false;
+        phase ^= p << j;
+      }
+    }
+
+    return false;
+  }
+
+  /* compares the pairwise cofactors with all previously assigned variables */
+  bool consistent( uint32_t level, uint32_t i, uint32_t j, uint32_t p ) const
+  {
+    for ( auto l = 0u; l < level; ++l )
+    {
+      const auto k = order[l];
+      const auto m = perm[k];
+      const auto q = ( phase >> m ) & 1u;
+      if ( sf.cofactor( i, p, k, q ) != sg.cofactor( j, false, m, false ) ||
+           sf.cofactor( i, !p, k, q ) != sg.cofactor( j, true, m, false ) ||
+           sf.cofactor( i, p, k, !q ) != sg.cofactor( j, false, m, true ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  const TT& f;
+  const TT& g;
+  npn_match_signature sf;
+  npn_match_signature sg;
+  uint32_t num_vars;
+  std::vector<uint8_t> perm;
+  std::vector<bool> used;
+  std::vector<uint32_t> order;
+  uint32_t phase;
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief NPN equivalence check (Boolean matching)
+
+  Checks whether two functions `f` and `g` are NPN equivalent without
+  canonizing them.  The function first compares invariants that are cheap to
+  compute: the number of ones, the multiset of cofactor sizes with respect to
+  each variable, and the distribution of absolute Walsh coefficients.  Only if
+  all invariants match, a search over input permutations and negations is
+  performed, in which each variable of `f` can only be mapped to variables of
+  `g` with compatible cofactor sizes, also with respect to all previously
+  mapped variables.
+
+  If the functions are NPN equivalent, the function returns a NPN
+  configuration with `f` as first element, such that `create_from_npn_config`
+  returns `g` when applied to it.  Otherwise, `std::nullopt` is returned.
+
+  \param f Truth table
+  \param g Truth table
+  \return NPN configuration that maps `f` to `g`, if one exists
+*/
+template<typename TT>
+std::optional<std::tuple<TT, uint32_t, std::vector<uint8_t>>> npn_match( const TT& f, const TT& g )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  if ( f.num_vars() != g.num_vars() )
+  {
+    return std::nullopt;
+  }
+
+  const auto num_vars = f.num_vars();
+  const auto ones_f = count_ones( f );
+  const auto ones_g = count_ones( g );
+  const auto try_pos = ones_f == ones_g;
+  const auto try_neg = ones_f == f.num_bits() - ones_g;
+
+  if ( !try_pos && !try_neg )
+  {
+    return std::nullopt;
+  }
+
+  if ( num_vars == 0u )
+  {
+    return std::make_tuple( f, static_cast<uint32_t>( f != g ), std::vector<uint8_t>{} );
+  }
+
+  const detail::npn_match_signature sig_f( f );
+  const auto multiset_f = sig_f.cofactor_multiset();
+  const auto try_pos_sig = try_pos && detail::npn_match_signature( g ).cofactor_multiset() == multiset_f;
+  const auto try_neg_sig = try_neg && detail::npn_match_signature( ~g ).cofactor_multiset() == multiset_f;
+
+  if ( !try_pos_sig && !try_neg_sig )
+  {
+    return std::nullopt;
+  }
+
+  /* absolute Walsh coefficients are invariant under NPN transformations */
+  if ( spectrum_distribution( rademacher_walsh_spectrum( f ) ) != spectrum_distribution( rademacher_walsh_spectrum( g ) ) )
+  {
+    return std::nullopt;
+  }
+
+  for ( auto out_neg : { false, true } )
+  {
+    if ( out_neg ? try_neg_sig : try_pos_sig )
+    {
+      if ( auto config = detail::npn_match_impl<TT>( f, g, out_neg ).run() )
+      {
+        return config;
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* visits all NP transformations of a ternary truth table together with their NPN configurations */
+template<typename TT, typename Callback>
+void ternary_np_enumeration( const ternary_truth_table<TT>& tt, uint32_t output_phase, Callback&& fn )
+{
+  if ( tt.num_vars() == 1u )
+  {
+    /* exact_np_enumeration does not flip the single input */
+    fn( tt, output_phase, std::vector<uint8_t>{ 0 } );
+    fn( flip( tt, 0 ), output_phase | 1u, std::vector<uint8_t>{ 0 } );
+    return;
+  }
+
+  exact_np_enumeration( tt, [&]( const auto& t, uint32_t phase, const std::vector<uint8_t>& perm ) {
+    fn( t, phase | output_phase, perm );
+  } );
+}
+
+template<typename TT, typename Callback>
+std::tuple<ternary_truth_table<TT>, uint32_t, std::vector<uint8_t>> exact_ternary_canonization( const ternary_truth_table<TT>& tt, bool output_negation, Callback&& fn )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  const auto num_vars = tt.num_vars();
+  assert( num_vars <= 6 );
+
+  auto best = std::make_tuple( tt, 0u, std::vector<uint8_t>( num_vars ) );
+  std::iota( std::get<2>( best ).begin(), std::get<2>( best ).end(), 0u );
+
+  const auto update = [&]( const auto& t, uint32_t phase, const std::vector<uint8_t>& perm ) {
+    fn( t );
+    if ( npn_less( t, std::get<0>( best ) ) )
+    {
+      best = std::make_tuple( t, phase, perm );
+    }
+  };
+
+  ternary_np_enumeration( tt, 0u, update );
+  if ( output_negation )
+  {
+    ternary_np_enumeration( ~tt, 1u << num_vars, update );
+  }
+
+  return best;
+}
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Exact NP canonization
+
+  Given a truth table, this function finds the smallest truth table in its NP
+  class, i.e., under input negations and input permutations.  The function
+  can also be applied to ternary truth tables (see
+  `exact_npn_canonization` for the order that is used in this case).
+
+  The function returns a NPN configuration which contains the necessary
+  transformations to obtain the representative.  It is a tuple of
+
+  - the NP representative
+  - input negations, output negation is always 0
+  - input permutation to apply
+
+  \param tt The truth table (with at most 6 variables)
+  \param fn Callback for each visited truth table in the class (default does nothing)
+  \return NPN configuration
+*/
+template<typename TT, typename Callback = decltype( detail::exact_npn_canonization_null_callback<TT> )>
+std::tuple<TT, uint32_t, std::vector<uint8_t>> exact_np_canonization( const TT& tt, Callback&& fn = detail::exact_npn_canonization_null_callback<TT> )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  if constexpr ( is_completely_specified_truth_table<TT>::value )
+  {
+    auto best = std::make_tuple( tt, 0u, std::vector<uint8_t>( tt.num_vars() ) );
+    std::iota( std::get<2>( best ).begin(), std::get<2>( best ).end(), 0u );
+
+    const auto update = [&]( const TT& t, uint32_t phase, const std::vector<uint8_t>& perm ) {
+      fn( t );
+      if ( t < std::get<0>( best ) )
+      {
+        best = std::make_tuple( t, phase, perm );
+      }
+    };
+
+    if ( tt.num_vars() == 1u )
+    {
+      update( tt, 0u, std::vector<uint8_t>{ 0 } );
+      update( flip( tt, 0 ), 1u, std::vector<uint8_t>{ 0 } );
+    }
+    else
+    {
+      exact_np_enumeration( tt, update );
+    }
+    return best;
+  }
+  else
+  {
+    return detail::exact_ternary_canonization( tt, false, fn );
+  }
+}
+
+/*! \brief Exact NPN canonization for incompletely specified functions
+
+  Finds the smallest ternary truth table in the NPN class of `tt`, in which
+  input and output transformations are applied to care set and onset
+  together.  Truth tables are first compared by their care set and then by
+  their onset, hence the representative can be used as a key for functions
+  that agree in both their care set and their onset up to NPN
+  transformations.  The output negation complements the onset within the care
+  set.
+
+  The function returns a NPN configuration as `exact_npn_canonization` does
+  for completely specified truth tables, and `create_from_npn_config` can be
+  used to obtain `tt` from it.  For a heuristic alternative, the functions
+  `sifting_npn_canonization` and `sifting_np_canonization` can be applied to
+  ternary truth tables, too.
+
+  \param tt The ternary truth table (with at most 6 variables)
+  \param fn Callback for each visited truth table in the class (default does nothing)
+  \return NPN configuration
+*/
+template<typename TT, typename Callback = decltype( detail::exact_npn_canonization_null_callback<ternary_truth_table<TT>> )>
+std::tuple<ternary_truth_table<TT>, uint32_t, std::vector<uint8_t>> exact_npn_canonization( const ternary_truth_table<TT>& tt, Callback&& fn = detail::exact_npn_canonization_null_callback<ternary_truth_table<TT>> )
+{
+  return detail::exact_ternary_canonization( tt, true, fn );
+}
+
+/*! \brief NPN matching of an incompletely specified function
+
+  Checks whether the completely specified function `g` can implement the
+  incompletely specified function `f` after input negations, input
+  permutations, and output negation, i.e., whether some member of the NPN
+  class of `g` agrees with `f` on its care set.
+
+  If such a transformation exists, the function returns a NPN configuration
+  with `g` as first element, such that `create_from_npn_config` returns a
+  function that agrees with `f` on the care set of `f`.
+
+  \param f Ternary truth table (with at most 6 variables)
+  \param g Truth table
+  \return NPN configuration that maps `g` to an implementation of `f`, if one exists
+*/
+template<typename TT>
+std::optional<std::tuple<TT, uint32_t, std::vector<uint8_t>>> npn_match( const ternary_truth_table<TT>& f, const TT& g )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  if ( f.num_vars() != g.num_vars() )
+  {
+    return std::nullopt;
+  }
+
+  const auto num_vars = f.num_vars();
+  const auto ones_on = count_ones( f._bits );
+  const auto ones_off = count_ones( f._care ) - ones_on;
+  const auto ones_g = count_ones( g );
+
+  std::optional<std::tuple<TT, uint32_t, std::vector<uint8_t>>> res;
+  const auto check = [&]( const auto& t, uint32_t phase, const std::vector<uint8_t>& perm ) {
+    if ( !res && is_const0( ( g ^ t._bits ) & t._care ) )
+    {
+      res = std::make_tuple( g, phase, perm );
+    }
+  };
+
+  if ( num_vars == 0u )
+  {
+    check( f, 0u, {} );
+    check( ~f, 1u, {} );
+    return res;
+  }
+
+  /* g must have as many ones as the onset plus some don't cares */
+  if ( ones_g >= ones_on && ones_g <= g.num_bits() - ones_off )
+  {
+    detail::ternary_np_enumeration( f, 0u, check );
+  }
+  if ( !res && ones_g >= ones_off && ones_g <= g.num_bits() - ones_on )
+  {
+    detail::ternary_np_enumeration( ~f, 1u << num_vars, check );
+  }
+
+  return res;
+}
+
+/*! \brief Finds a library function that implements an incompletely specified function
+
+  Searches the range `[begin, end)` of completely specified functions for the
+  first one that can implement `f` up to NPN transformations (see
+  `npn_match`).  The function returns an iterator to the library function and
+  the NPN configuration, or `std::nullopt`, if no library function matches.
+
+  \param f Ternary truth table (with at most 6 variables)
+  \param begin Begin iterator of library functions
+  \param end End iterator of library functions
+*/
+template<typename TT, typename Iterator>
+std::optional<std::pair<Iterator, std::tuple<TT, uint32_t, std::vector<uint8_t>>>> find_npn_match( const ternary_truth_table<TT>& f, Iterator begin, Iterator end )
+{
+  for ( auto it = begin; it != end; ++it )
+  {
+    if ( auto config = npn_match( f, *it ) )
+    {
+      return std::make_pair( it, *config );
+    }
+  }
+  return std::nullopt;
+}
+
 } /* namespace kitty */
\ No newline at end of file
@@ -43,10 +43,12 @@
 #include "traits.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <functional>
 #include <iterator>
 #include <optional>
+#include <vector>
 
 namespace kitty
 {
@@ -2128,6 +2130,186 @@ inline TT shift_right( const TT& tt, uint64_t shift )
   return copy;
 }
 
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* evaluates a function over the variables 0, ..., NumVars - 1, whose truth
+   table is replicated to the whole word, with a mux tree; constant
+   cofactors and variables outside of the support are skipped */
+template<uint32_t NumVars>
+inline uint64_t evaluate_batch_word( uint64_t tt, const uint64_t* inputs )
+{
+  if ( tt == 0u || tt == ~uint64_t( 0 ) )
+  {
+    return tt;
+  }
+  if constexpr ( NumVars == 0u )
+  {
+    return tt; /* unreachable, constant after replication */
+  }
+  else
+  {
+    constexpr auto v = NumVars - 1u;
+    constexpr auto shift = uint64_t( 1 ) << v;
+    auto c0 = tt & projections_neg[v];
+    c0 |= c0 << shift;
+    auto c1 = tt & projections[v];
+    c1 |= c1 >> shift;
+
+    const auto r0 = evaluate_batch_word<v>( c0, inputs );
+    if ( c0 == c1 )
+    {
+      return r0;
+    }
+    if ( c0 == ~c1 )
+    {
+      return r0 ^ inputs[v];
+    }
+    const auto r1 = evaluate_batch_word<v>( c1, inputs );
+    return r0 ^ ( inputs[v] & ( r0 ^ r1 ) );
+  }
+}
+
+/* replicates a truth table with less than 6 variables to the whole word */
+inline uint64_t evaluate_batch_replicate( uint64_t tt, uint32_t num_vars )
+{
+  tt &= masks[num_vars];
+  for ( auto i = num_vars; i < 6u; ++i )
+  {
+    tt |= tt << ( uint64_t( 1 ) << i );
+  }
+  return tt;
+}
+
+inline uint64_t evaluate_batch_word( uint64_t tt, uint32_t num_vars, const uint64_t* inputs )
+{
+  switch ( num_vars )
+  {
+  case 0u:
+    return evaluate_batch_word<0u>( evaluate_batch_replicate( tt, 0u ), inputs );
+  case 1u:
+    return evaluate_batch_word<1u>( evaluate_batch_replicate( tt, 1u ), inputs );
+  case 2u:
+    return evaluate_batch_word<2u>( evaluate_batch_replicate( tt, 2u ), inputs );
+  case 3u:
+    return evaluate_batch_word<3u>( evaluate_batch_replicate( tt, 3u ), inputs );
+  case 4u:
+    return evaluate_batch_word<4u>( evaluate_batch_replicate( tt, 4u ), inputs );
+  case 5u:
+    return evaluate_batch_word<5u>( evaluate_batch_replicate( tt, 5u ), inputs );
+  default:
+    return evaluate_batch_word<6u>( tt, inputs );
+  }
+}
+
+/* mux tree over the blocks for variables 6, ..., num_vars - 1 */
+inline uint64_t evaluate_batch_blocks( const uint64_t* begin, uint64_t num_blocks, uint32_t num_vars, const uint64_t* inputs )
+{
+  if ( num_blocks == 1u )
+  {
+    return evaluate_batch_word<6u>( *begin, inputs );
+  }
+  const auto half = num_blocks >> 1;
+  const auto v = num_vars - 1u;
+  const auto r0 = evaluate_batch_blocks( begin, half, v, inputs );
+  if ( std::equal( begin, begin + half, begin + half ) )
+  {
+    return r0;
+  }
+  const auto r1 = evaluate_batch_blocks( begin + half, half, v, inputs );
+  return r0 ^ ( inputs[v] & ( r0 ^ r1 ) );
+}
+
+/* looks up the function for each assignment */
+inline uint64_t evaluate_batch_lookup( const uint64_t* tt, uint32_t num_vars, const uint64_t* inputs )
+{
+  std::array<uint32_t, 64> index{};
+  for ( auto j = 0u; j < num_vars; ++j )
+  {
+    for ( auto w = inputs[j]; w; w &= w - 1 )
+    {
+      index[__builtin_ctzll( w )] |= 1u << j;
+    }
+  }
+
+  uint64_t result = 0u;
+  for ( auto p = 0u; p < 64u; ++p )
+  {
+    result |= ( ( tt[index[p] >> 6] >> ( index[p] & 0x3f ) ) & 1 ) << p;
+  }
+  return result;
+}
+
+/* number of variables up to which the mux tree is used */
+static constexpr uint32_t evaluate_batch_mux_vars = 7u;
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Evaluates a function on 64 input assignments
+
+  The word `inputs[j]` contains the values of variable `j` in 64 input
+  assignments, e.g., simulation patterns, and bit `p` of the result is the
+  value of `tt` for the assignment in bits `p` of the input words.  This
+  computes the same as 64 calls to `get_bit`, but in a bit-parallel way:
+  functions with up to 7 variables are evaluated with a mux tree over the
+  input words, which skips constant cofactors and variables that are not
+  in the support, such that, e.g., an AND gate costs a single operation.
+  For functions with more variables, the 64 indexes into the truth table
+  are collected from the set bits of the input words.
+
+  \param tt Truth table
+  \param inputs Pointer to `tt.num_vars()` input words
+*/
+template<typename TT, typename = std::enable_if_t<is_complete_truth_table<TT>::value>>
+inline uint64_t evaluate_batch( const TT& tt, const uint64_t* inputs )
+{
+  const auto num_vars = static_cast<uint32_t>( tt.num_vars() );
+  if ( num_vars <= 6u )
+  {
+    return detail::evaluate_batch_word( *tt.cbegin(), num_vars, inputs );
+  }
+  if ( num_vars <= detail::evaluate_batch_mux_vars )
+  {
+    return detail::evaluate_batch_blocks( &*tt.cbegin(), tt.num_blocks(), num_vars, inputs );
+  }
+  return detail::evaluate_batch_lookup( &*tt.cbegin(), num_vars, inputs );
+}
+
+/*! \cond PRIVATE */
+template<uint32_t NumVars>
+inline uint64_t evaluate_batch( const static_truth_table<NumVars, true>& tt, const uint64_t* inputs )
+{
+  return detail::evaluate_batch_word<NumVars>( detail::evaluate_batch_replicate( tt._bits, NumVars ), inputs );
+}
+/*! \endcond */
+
+/*! \brief Evaluates a function on many input assignments
+
+  Evaluates `tt` on `num_words` words of 64 input assignments each, where
+  `inputs[j]` points to the `num_words` words of variable `j`, and writes
+  the results to `output`.
+
+  \param tt Truth table
+  \param inputs Pointers to the words of each variable
+  \param output Pointer to `num_words` output words
+  \param num_words Number of words
+*/
+template<typename TT, typename = std::enable_if_t<is_complete_truth_table<TT>::value>>
+inline void evaluate_batch( const TT& tt, const uint64_t* const* inputs, uint64_t* output, uint64_t num_words )
+{
+  std::vector<uint64_t> words( tt.num_vars() );
+  for ( uint64_t i = 0u; i < num_words; ++i )
+  {
+    for ( auto j = 0u; j < words.size(); ++j )
+    {
+      words[j] = inputs[j][i];
+    }
+    output[i] = evaluate_batch( tt, words.data() );
+  }
+}
+
 /*! \brief Composes a truth table.
 
   Given a function `f`, and a set of truth tables as arguments, computes the
@@ -2146,22 +2328,17 @@ inline auto compose_truth_table( const TTf& f, const std::vector<TTv>& vars )
   assert( vars.size() == static_cast<std::size_t>( f.num_vars() ) );
   auto composed = vars[0].construct();
 
-  for ( uint64_t i = 0u; i < composed.num_bits(); ++i )
+  std::vector<uint64_t> inputs( vars.size() );
+  auto it = composed.begin();
+  for ( uint64_t i = 0u; i < composed.num_blocks(); ++i )
   {
-    uint64_t index = 0u;
-    for ( uint64_t j = 0u; j < vars.size(); ++j )
-    {
-      index += get_bit( vars[j], i ) << j;
-    }
-    if ( get_bit( f, index ) )
-    {
-      set_bit( composed, i );
-    }
-    else
+    for ( auto j = 0u; j < vars.size(); ++j )
     {
-      clear_bit( composed, i );
+      inputs[j] = *( vars[j].cbegin() + i );
     }
+    *it++ = evaluate_batch( f, inputs.data() );
   }
+  composed.mask_bits();
 
   return composed;
 }
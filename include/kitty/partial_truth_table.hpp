@@ -201,20 +201,24 @@ struct partial_truth_table
   {
     assert( num_bits <= 64 );
 
-    if ( ( _num_bits & 0x3f ) + num_bits <= 64 ) /* no need for a new block */
+    if ( num_bits == 0 )
     {
-      if ( _bits.size() == 0u )
-      {
-        _bits.emplace_back( 0u );
-      }
-      _bits.back() |= bits << ( _num_bits & 0x3f );
+      return;
+    }
+    bits &= 0xFFFFFFFFFFFFFFFF >> ( 64 - num_bits );
+
+    if ( ( _num_bits & 0x3f ) == 0 ) /* last block is full */
+    {
+      _bits.emplace_back( bits );
     }
     else
     {
       auto first_half_len = 64 - ( _num_bits & 0x3f );
       _bits.back() |= bits << ( _num_bits & 0x3f );
-      _bits.emplace_back( 0u );
-      _bits.back() |= ( bits & ( 0xFFFFFFFFFFFFFFFF >> ( 64 - num_bits ) ) ) >> first_half_len;
+      if ( static_cast<uint32_t>( num_bits ) > first_half_len ) /* need a new block */
+      {
+        _bits.emplace_back( bits >> first_half_len );
+      }
     }
     _num_bits += num_bits;
   }
@@ -0,0 +1,415 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file pattern_store.hpp
+  \brief Shared storage for the simulation patterns of many signals
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "partial_truth_table.hpp"
+
+namespace kitty
+{
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* contiguous range of words that behaves like the `_bits` member of truth tables */
+template<typename Word>
+struct word_span
+{
+  Word* _data;
+  uint64_t _size;
+
+  inline Word& operator[]( uint64_t index ) const noexcept { return _data[index]; }
+  inline Word* begin() const noexcept { return _data; }
+  inline Word* end() const noexcept { return _data + _size; }
+  inline Word& front() const noexcept { return _data[0]; }
+  inline Word& back() const noexcept { return _data[_size - 1]; }
+  inline Word* data() const noexcept { return _data; }
+  inline uint64_t size() const noexcept { return _size; }
+};
+
+struct aligned_words_deleter
+{
+  void operator()( uint64_t* p ) const
+  {
+    ::operator delete( p, std::align_val_t( 64 ) );
+  }
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief View on the bits of a signal in a pattern store
+
+  The view has the same block interface as `partial_truth_table`
+  (`num_bits`, `num_blocks`, iterators, and the `_bits` member), so that bit
+  access functions such as `get_bit`, `set_bit`, `count_ones`, `is_const0`,
+  or `for_each_one_bit` can be applied directly.  Explicit conversion
+  creates a `partial_truth_table` copy.
+
+  A view is invalidated when the pattern store reallocates, i.e., when the
+  number of bits exceeds its capacity.
+
+  \tparam Word `uint64_t` for mutable views, `const uint64_t` for read-only
+               views
+*/
+template<typename Word>
+class partial_truth_table_view
+{
+public:
+  /*! \brief Constructs a view
+
+    \param data Pointer to the first block
+    \param num_bits Number of bits
+  */
+  partial_truth_table_view( Word* data, uint32_t num_bits )
+      : _bits{ data, num_bits ? ( ( ( num_bits - 1 ) >> 6 ) + 1u ) : 0u },
+        _num_bits( num_bits )
+  {
+  }
+
+  /*! \brief Constructs a read-only view from a mutable view
+
+    \param other Mutable view
+  */
+  template<typename OtherWord, typename = std::enable_if_t<std::is_const<Word>::value && !std::is_const<OtherWord>::value>>
+  partial_truth_table_view( const partial_truth_table_view<OtherWord>& other ) /* NOLINT */
+      : _bits{ other._bits.data(), other._bits.size() },
+        _num_bits( other._num_bits )
+  {
+  }
+
+  /*! \brief Returns number of blocks. */
+  inline auto num_blocks() const noexcept { return _bits.size(); }
+
+  /*! \brief Returns number of bits. */
+  inline auto num_bits() const noexcept { return _num_bits; }
+
+  /*! \brief Begin iterator to bits. */
+  inline auto begin() const noexcept { return _bits.begin(); }
+
+  /*! \brief End iterator to bits. */
+  inline auto end() const noexcept { return _bits.end(); }
+
+  /*! \brief Constant begin iterator to bits. */
+  inline const uint64_t* cbegin() const noexcept { return _bits.begin(); }
+
+  /*! \brief Constant end iterator to bits. */
+  inline const uint64_t* cend() const noexcept { return _bits.end(); }
+
+  /*! \brief Copies the bits of a partial truth table with the same number of bits
+
+    \param tt Partial truth table
+  */
+  void assign( const partial_truth_table& tt ) const
+  {
+    assert( tt.num_bits() == _num_bits );
+    std::copy( tt.cbegin(), tt.cend(), _bits.begin() );
+  }
+
+  /*! \brief Creates a partial truth table with the same bits */
+  explicit operator partial_truth_table() const
+  {
+    partial_truth_table tt( _num_bits );
+    std::copy( cbegin(), cend(), tt.begin() );
+    return tt;
+  }
+
+public: /* fields */
+  /*! \cond PRIVATE */
+  detail::word_span<Word> _bits;
+  uint32_t _num_bits;
+  /*! \endcond */
+};
+
+/*! \brief Simulation patterns of many signals in a shared arena
+
+  Stores a partial truth table of the same length for each signal.  Unlike a
+  vector of `partial_truth_table`, in which each table grows and reallocates
+  separately, all signals share one capacity that grows geometrically, and
+  bits are appended to all signals at once.
+
+  Signals are stored in chunks of a fixed number of signals.  In each chunk,
+  the blocks of a signal are contiguous and start at a 64-byte boundary, so
+  that views on a signal are plain arrays of words and signals do not share
+  cache lines.  Adding signals allocates new chunks without moving existing
+  signals, and growing the capacity reallocates one chunk at a time.
+*/
+class pattern_store
+{
+public:
+  /*! \brief Constructs a pattern store
+
+    \param num_signals Initial number of signals
+    \param signals_per_chunk Number of signals in each chunk
+  */
+  explicit pattern_store( uint32_t num_signals = 0u, uint32_t signals_per_chunk = 64u )
+      : _signals_per_chunk( std::max( signals_per_chunk, 1u ) )
+  {
+    for ( auto i = 0u; i < num_signals; ++i )
+    {
+      add_signal();
+    }
+  }
+
+  /*! \brief Adds a signal with all bits set to 0
+
+    Returns the index of the new signal.
+  */
+  uint32_t add_signal()
+  {
+    const auto index = _num_signals++;
+    if ( index % _signals_per_chunk == 0u )
+    {
+      _chunks.emplace_back( allocate( _capacity ) );
+    }
+    std::fill_n( signal_data( index ), _capacity, uint64_t( 0 ) );
+    return index;
+  }
+
+  /*! \brief Returns the number of signals. */
+  inline uint32_t num_signals() const noexcept { return _num_signals; }
+
+  /*! \brief Returns the number of bits of each signal. */
+  inline uint32_t num_bits() const noexcept { return _num_bits; }
+
+  /*! \brief Returns the number of blocks of each signal. */
+  inline uint64_t num_blocks() const noexcept { return blocks( _num_bits ); }
+
+  /*! \brief Returns the number of blocks that can be stored without reallocation. */
+  inline uint64_t capacity() const noexcept { return _capacity; }
+
+  /*! \brief Reserves capacity for a number of bits
+
+    \param num_bits Number of bits
+  */
+  void reserve( uint32_t num_bits )
+  {
+    const auto needed = blocks( num_bits );
+    if ( needed <= _capacity )
+    {
+      return;
+    }
+
+    /* round to cache lines */
+    const auto capacity = ( needed + 7u ) & ~uint64_t( 7 );
+    const auto used = num_blocks();
+    for ( auto c = 0u; c < _chunks.size(); ++c )
+    {
+      auto chunk = allocate( capacity );
+      const auto signals = std::min( _signals_per_chunk, _num_signals - c * _signals_per_chunk );
+      for ( auto s = 0u; s < signals; ++s )
+      {
+        const auto from = _chunks[c].get() + s * _capacity;
+        const auto to = chunk.get() + s * capacity;
+        std::copy( from, from + used, to );
+        std::fill( to + used, to + capacity, uint64_t( 0 ) );
+      }
+      _chunks[c] = std::move( chunk );
+    }
+    _capacity = capacity;
+  }
+
+  /*! \brief Resizes all signals
+
+    New bits are set to 0.
+
+    \param num_bits Number of bits
+  */
+  void resize( uint32_t num_bits )
+  {
+    grow( num_bits );
+
+    const auto old_blocks = num_blocks();
+    const auto new_blocks = blocks( num_bits );
+    for ( auto s = 0u; s < _num_signals; ++s )
+    {
+      auto data = signal_data( s );
+      if ( new_blocks > old_blocks )
+      {
+        std::fill( data + old_blocks, data + new_blocks, uint64_t( 0 ) );
+      }
+      else if ( num_bits & 0x3f )
+      {
+        data[new_blocks - 1] &= 0xFFFFFFFFFFFFFFFF >> ( 64 - ( num_bits & 0x3f ) );
+      }
+    }
+    _num_bits = num_bits;
+  }
+
+  /*! \brief Appends bits to all signals
+
+    The bits for signal `i` are taken from the `num_bits` least significant
+    bits of `words[i]`.
+
+    \param words Array with one word for each signal
+    \param num_bits Number of bits to append
+  */
+  void add_bits( const uint64_t* words, uint32_t num_bits = 64u )
+  {
+    assert( num_bits <= 64u );
+    if ( num_bits == 0u )
+    {
+      return;
+    }
+    grow( _num_bits + num_bits );
+
+    const auto mask = 0xFFFFFFFFFFFFFFFF >> ( 64 - num_bits );
+    const auto block = _num_bits >> 6;
+    const auto offset = _num_bits & 0x3f;
+    for ( auto s = 0u; s < _num_signals; ++s )
+    {
+      auto data = signal_data( s ) + block;
+      const auto word = words[s] & mask;
+      if ( offset == 0u )
+      {
+        data[0] = word;
+      }
+      else
+      {
+        data[0] |= word << offset;
+        if ( offset + num_bits > 64u )
+        {
+          data[1] = word >> ( 64 - offset );
+        }
+      }
+    }
+    _num_bits += num_bits;
+  }
+
+  /*! \brief Appends blocks to all signals
+
+    Appends `num_blocks * 64` bits.  The blocks are stored signal by signal,
+    i.e., block `j` of signal `i` is `words[i * num_blocks + j]`.
+
+    \param words Array with `num_blocks` words for each signal
+    \param num_blocks Number of blocks to append
+  */
+  void add_blocks( const uint64_t* words, uint32_t num_blocks )
+  {
+    grow( _num_bits + ( num_blocks << 6 ) );
+
+    const auto block = _num_bits >> 6;
+    const auto offset = _num_bits & 0x3f;
+    for ( auto s = 0u; s < _num_signals; ++s )
+    {
+      auto data = signal_data( s ) + block;
+      const auto src = words + uint64_t( s ) * num_blocks;
+      if ( offset == 0u )
+      {
+        std::copy( src, src + num_blocks, data );
+        continue;
+      }
+      for ( auto j = 0u; j < num_blocks; ++j )
+      {
+        data[j] |= src[j] << offset;
+        data[j + 1] = src[j] >> ( 64 - offset );
+      }
+    }
+    _num_bits += num_blocks << 6;
+  }
+
+  /*! \brief Returns a mutable view on the bits of a signal
+
+    \param signal Signal index
+  */
+  partial_truth_table_view<uint64_t> view( uint32_t signal )
+  {
+    assert( signal < _num_signals );
+    return { signal_data( signal ), _num_bits };
+  }
+
+  /*! \brief Returns a read-only view on the bits of a signal
+
+    \param signal Signal index
+  */
+  partial_truth_table_view<const uint64_t> view( uint32_t signal ) const
+  {
+    assert( signal < _num_signals );
+    return { signal_data( signal ), _num_bits };
+  }
+
+  /*! \brief Returns a copy of the bits of a signal
+
+    \param signal Signal index
+  */
+  partial_truth_table to_partial_truth_table( uint32_t signal ) const
+  {
+    return static_cast<partial_truth_table>( view( signal ) );
+  }
+
+private:
+  using chunk_t = std::unique_ptr<uint64_t[], detail::aligned_words_deleter>;
+
+  static inline uint64_t blocks( uint32_t num_bits )
+  {
+    return num_bits ? ( ( ( num_bits - 1 ) >> 6 ) + 1u ) : 0u;
+  }
+
+  chunk_t allocate( uint64_t capacity ) const
+  {
+    const auto words = std::max<uint64_t>( capacity * _signals_per_chunk, 8u );
+    return chunk_t( static_cast<uint64_t*>( ::operator new( words * sizeof( uint64_t ), std::align_val_t( 64 ) ) ) );
+  }
+
+  /* geometric growth */
+  void grow( uint32_t num_bits )
+  {
+    if ( blocks( num_bits ) > _capacity )
+    {
+      reserve( std::max<uint64_t>( num_bits, std::min<uint64_t>( _capacity * 128u, 0xffffffffu ) ) );
+    }
+  }
+
+  inline uint64_t* signal_data( uint32_t signal ) const
+  {
+    return _chunks[signal / _signals_per_chunk].get() + uint64_t( signal % _signals_per_chunk ) * _capacity;
+  }
+
+private:
+  uint32_t _signals_per_chunk;
+  uint32_t _num_signals{ 0u };
+  uint32_t _num_bits{ 0u };
+  uint64_t _capacity{ 0u };
+  std::vector<chunk_t> _chunks;
+};
+
+} // namespace kitty
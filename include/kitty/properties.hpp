@@ -292,23 +292,58 @@ std::vector<uint32_t> runlength_pattern( const TT& tt )
   return pattern;
 }
 
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* positions in a word whose index has k ones */
+static constexpr uint64_t degree_masks[] = {
+    UINT64_C( 0x0000000000000001 ),
+    UINT64_C( 0x0000000100010116 ),
+    UINT64_C( 0x0001011601161668 ),
+    UINT64_C( 0x0116166816686880 ),
+    UINT64_C( 0x1668688068808000 ),
+    UINT64_C( 0x6880800080000000 ),
+    UINT64_C( 0x8000000000000000 ) };
+
+} // namespace detail
+/*! \endcond */
+
 /*! \brief Compute polynomial degree
   The polyomial degree is the number of variables in the largest monomial in
   the functoons ANF (PPRM).
+
+  The degree is computed from the ANF truth table without constructing
+  cubes: the degree of a monomial is the number of ones in the index of its
+  word plus the number of ones of its position inside the word, which is
+  looked up by masks for all positions of the same degree.
   \param tt Truth table
 */
 template<typename TT>
 inline uint32_t polynomial_degree( const TT& tt )
 {
-  const auto cubes = esop_from_pprm( tt );
-  if ( cubes.empty() ) /* zero function */
+  const auto anf = detail::algebraic_normal_form( tt );
+
+  uint32_t degree = 0u;
+  uint64_t index = 0u;
+  for ( auto it = anf.cbegin(); it != anf.cend(); ++it, ++index )
   {
-    return 0u;
+    const auto word = *it;
+    const auto high = static_cast<uint32_t>( __builtin_popcount( index & 0xffffffff ) + __builtin_popcount( index >> 32 ) );
+    if ( word == 0u || high + 6u <= degree )
+    {
+      continue;
+    }
+    for ( auto k = 6; k >= 0; --k )
+    {
+      if ( word & detail::degree_masks[k] )
+      {
+        degree = std::max( degree, high + k );
+        break;
+      }
+    }
   }
-  const auto max = std::max_element( cubes.begin(), cubes.end(),
-                                     []( auto const& c1, auto const& c2 )
-                                     { return c1.num_literals() < c2.num_literals(); } );
-  return max->num_literals();
+  return degree;
 }
 
 /*! \brief Returns the absolute distinguishing power of a function
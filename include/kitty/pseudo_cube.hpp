@@ -0,0 +1,370 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file pseudo_cube.hpp
+  \brief Pseudo cubes (affine subspaces of the Boolean space)
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <tuple>
+
+#include "cube.hpp"
+#include "hash.hpp"
+#include "detail/mscfix.hpp"
+
+namespace kitty
+{
+
+/*! \brief Pseudo cube with up to 16 variables
+
+  A pseudo cube is an affine subspace \f$p + \langle b_1, \dots, b_k\rangle\f$
+  of the Boolean space, i.e., a set of \f$2^k\f$ minterms that is closed under
+  adding any two of its directions.  Its characteristic function is a pseudo
+  product, a conjunction of XOR factors [A. Bernasconi, V. Ciriani, F. Luccio,
+  and L. Pagli, IEEE Trans. Computers 52(11), 2003].  Each cube is a pseudo
+  cube whose directions are unit vectors.
+
+  The representation is canonical: the directions form a basis in reduced row
+  echelon form over GF(2).  The pivot of a basis vector is its most
+  significant bit, basis vectors are sorted by decreasing pivot, and no other
+  basis vector and not the point have a 1 at a pivot.  The pivot variables
+  are the free (canonical) variables of the pseudo product; each other
+  variable is determined by the XOR of the pivot variables of the basis
+  vectors that contain it.
+*/
+class pseudo_cube
+{
+public:
+  /*! Maximum number of variables */
+  static constexpr uint32_t max_vars = 16u;
+
+  /*! \brief Constructs the pseudo cube that contains only minterm 0 */
+  pseudo_cube() = default;
+
+  /*! \brief Constructs the pseudo cube that contains a single minterm
+
+    \param minterm Minterm
+  */
+  explicit pseudo_cube( uint32_t minterm ) : _point( minterm )
+  {
+    assert( minterm < ( 1u << max_vars ) );
+  }
+
+  /*! \brief Constructs a pseudo cube from a cube
+
+    \param c Cube
+    \param num_vars Number of variables
+  */
+  pseudo_cube( const cube& c, uint32_t num_vars ) : _point( c._bits & c._mask )
+  {
+    assert( num_vars <= max_vars );
+    for ( auto i = static_cast<int>( num_vars ) - 1; i >= 0; --i )
+    {
+      if ( !c.get_mask( i ) )
+      {
+        _basis[_dim++] = 1u << i;
+      }
+    }
+  }
+
+  /*! \brief Returns the dimension */
+  inline uint32_t dimension() const
+  {
+    return _dim;
+  }
+
+  /*! \brief Returns the canonical minterm (zero at all pivots) */
+  inline uint32_t point() const
+  {
+    return _point;
+  }
+
+  /*! \brief Returns bitmask of pivot variables */
+  inline uint32_t pivots() const
+  {
+    uint32_t mask = 0u;
+    for ( auto i = 0u; i < _dim; ++i )
+    {
+      mask |= 1u << pivot( _basis[i] );
+    }
+    return mask;
+  }
+
+  /*! \brief Reduces a vector by the basis
+
+    Returns the representative of `x` in the quotient space, i.e., the unique
+    vector in `x + span(basis)` with zeros at all pivots.
+
+    \param x Vector
+  */
+  inline uint32_t reduce( uint32_t x ) const
+  {
+    for ( auto i = 0u; i < _dim; ++i )
+    {
+      if ( ( x >> pivot( _basis[i] ) ) & 1 )
+      {
+        x ^= _basis[i];
+      }
+    }
+    return x;
+  }
+
+  /*! \brief Checks whether the pseudo cube contains a minterm
+
+    \param minterm Minterm
+  */
+  inline bool contains( uint32_t minterm ) const
+  {
+    return reduce( minterm ) == _point;
+  }
+
+  /*! \brief Checks whether the pseudo cube contains another pseudo cube
+
+    \param that Other pseudo cube
+  */
+  inline bool contains( const pseudo_cube& that ) const
+  {
+    if ( that._dim > _dim || !contains( that._point ) )
+    {
+      return false;
+    }
+    for ( auto i = 0u; i < that._dim; ++i )
+    {
+      if ( reduce( that._basis[i] ) != 0u )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief Adds a direction
+
+    Extends the pseudo cube `p + V` to `p + V + <d>`, which doubles its
+    number of minterms.  Returns false, if `d` is already in `V`.
+
+    \param d Direction
+  */
+  bool add_direction( uint32_t d )
+  {
+    d = reduce( d );
+    if ( d == 0u )
+    {
+      return false;
+    }
+    assert( _dim < max_vars );
+
+    /* eliminate new pivot from basis and point */
+    const auto q = pivot( d );
+    for ( auto i = 0u; i < _dim; ++i )
+    {
+      if ( ( _basis[i] >> q ) & 1 )
+      {
+        _basis[i] ^= d;
+      }
+    }
+    if ( ( _point >> q ) & 1 )
+    {
+      _point ^= d;
+    }
+
+    /* insert sorted by decreasing pivot */
+    auto i = _dim++;
+    for ( ; i > 0u && _basis[i - 1] < d; --i )
+    {
+      _basis[i] = _basis[i - 1];
+    }
+    _basis[i] = d;
+    return true;
+  }
+
+  /*! \brief Iterates over the XOR factors of the pseudo product
+
+    For each variable that is not a pivot, the callback is called with a
+    bitmask `mask` of variables and a value `value`, representing the factor
+    \f$\bigoplus_{i \in \mathit{mask}} x_i = \mathit{value}\f$.  Factors with
+    a single variable are literals.
+
+    \param num_vars Number of variables
+    \param fn Callback function with signature `void(uint32_t, bool)`
+  */
+  template<class Fn>
+  void foreach_factor( uint32_t num_vars, Fn&& fn ) const
+  {
+    const auto pivot_mask = pivots();
+    for ( auto j = 0u; j < num_vars; ++j )
+    {
+      if ( ( pivot_mask >> j ) & 1 )
+      {
+        continue;
+      }
+      uint32_t mask = 1u << j;
+      for ( auto i = 0u; i < _dim; ++i )
+      {
+        if ( ( _basis[i] >> j ) & 1 )
+        {
+          mask |= 1u << pivot( _basis[i] );
+        }
+      }
+      fn( mask, ( ( _point >> j ) & 1 ) == 1 );
+    }
+  }
+
+  /*! \brief Returns the number of literals in the pseudo product
+
+    \param num_vars Number of variables
+  */
+  uint32_t num_literals( uint32_t num_vars ) const
+  {
+    uint32_t literals = 0u;
+    foreach_factor( num_vars, [&]( auto mask, auto ) { literals += __builtin_popcount( mask ); } );
+    return literals;
+  }
+
+  /*! \brief Iterates over all minterms
+
+    Minterms are visited in Gray code order of the basis.
+
+    \param fn Callback function with signature `void(uint32_t)`
+  */
+  template<class Fn>
+  void foreach_minterm( Fn&& fn ) const
+  {
+    auto m = _point;
+    fn( m );
+    for ( uint32_t k = 1u; k < ( 1u << _dim ); ++k )
+    {
+      m ^= _basis[__builtin_ctz( k )];
+      fn( m );
+    }
+  }
+
+  /*! \brief Checks whether two pseudo cubes are equivalent */
+  inline bool operator==( const pseudo_cube& that ) const
+  {
+    return _point == that._point && _dim == that._dim && _basis == that._basis;
+  }
+
+  /*! \brief Checks whether two pseudo cubes are not equivalent */
+  inline bool operator!=( const pseudo_cube& that ) const
+  {
+    return !( *this == that );
+  }
+
+  /*! \brief Default comparison operator */
+  inline bool operator<( const pseudo_cube& that ) const
+  {
+    return std::tie( _dim, _basis, _point ) < std::tie( that._dim, that._basis, that._point );
+  }
+
+  /*! \brief Prints the pseudo product
+
+    Literals are printed as `x3` or `!x3`, XOR factors as `(x0^x2)` or
+    `!(x0^x2)`, and the constant-1 product as `1`.
+
+    \param num_vars Number of variables
+    \param os Output stream
+  */
+  void print( uint32_t num_vars, std::ostream& os = std::cout ) const
+  {
+    auto first = true;
+    foreach_factor( num_vars, [&]( auto mask, auto value ) {
+      if ( !first )
+      {
+        os << ' ';
+      }
+      first = false;
+      if ( !value )
+      {
+        os << '!';
+      }
+      const auto is_xor = __builtin_popcount( mask ) > 1;
+      if ( is_xor )
+      {
+        os << '(';
+      }
+      auto first_var = true;
+      for ( auto i = 0u; i < num_vars; ++i )
+      {
+        if ( ( mask >> i ) & 1 )
+        {
+          os << ( first_var ? "x" : "^x" ) << i;
+          first_var = false;
+        }
+      }
+      if ( is_xor )
+      {
+        os << ')';
+      }
+    } );
+    if ( first )
+    {
+      os << '1';
+    }
+  }
+
+private:
+  static inline uint32_t pivot( uint32_t b )
+  {
+    return 31u - __builtin_clz( b );
+  }
+
+public:
+  /* canonical point */
+  uint32_t _point{ 0u };
+
+  /* dimension */
+  uint32_t _dim{ 0u };
+
+  /* basis in reduced row echelon form, unused entries are 0 */
+  std::array<uint32_t, max_vars> _basis{};
+};
+
+/*! \cond PRIVATE */
+template<>
+struct hash<pseudo_cube>
+{
+  std::size_t operator()( const pseudo_cube& c ) const
+  {
+    std::size_t seed = hash_block( ( static_cast<uint64_t>( c._dim ) << 32u ) | c._point );
+    for ( auto i = 0u; i < c._dim; ++i )
+    {
+      hash_combine( seed, hash_block( c._basis[i] ) );
+    }
+    return seed;
+  }
+};
+/*! \endcond */
+
+} // namespace kitty
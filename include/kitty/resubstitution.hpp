@@ -0,0 +1,643 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file resubstitution.hpp
+  \brief Search for resubstitution candidates
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "bit_operations.hpp"
+#include "dynamic_truth_table.hpp"
+#include "detail/work_stealing_pool.hpp"
+
+namespace kitty
+{
+
+/*! \brief Parameters for find_resubstitution */
+struct resubstitution_params
+{
+  /*! Maximum number of divisors (at most 3). */
+  uint32_t max_divisors{ 3u };
+
+  /*! Try XOR gates of two divisors. */
+  bool use_xor{ true };
+
+  /*! Number of threads (0 = hardware concurrency). */
+  uint32_t num_threads{ 1u };
+};
+
+/*! \brief Statistics for find_resubstitution */
+struct resubstitution_stats
+{
+  /*! Number of divisors whose literal is contained in the target or its
+      complement. */
+  uint32_t unate_literals{ 0u };
+
+  /*! Number of candidates checked on the simulation words. */
+  uint64_t candidates{ 0u };
+
+  /*! Number of loops that were cut off by popcount bounds. */
+  uint64_t cutoffs{ 0u };
+};
+
+/*! \brief Result of find_resubstitution */
+struct resubstitution_candidate
+{
+  /*! Indexes of the divisors in increasing order. */
+  std::vector<uint32_t> divisors;
+
+  /*! Function over the divisors, variable i corresponds to `divisors[i]`. */
+  dynamic_truth_table function;
+
+  /*! Assignments of the divisors that occur in the care set of the target. */
+  dynamic_truth_table care;
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+inline uint64_t resub_count( const uint64_t* a, const uint64_t* b, uint64_t mask, uint64_t num_blocks )
+{
+  uint64_t count = 0u;
+  for ( auto i = 0u; i < num_blocks; ++i )
+  {
+    const auto w = ( a[i] ^ mask ) & b[i];
+    count += __builtin_popcount( w & 0xffffffff ) + __builtin_popcount( w >> 32 );
+  }
+  return count;
+}
+
+class resub_engine
+{
+public:
+  resub_engine( uint64_t num_blocks, std::vector<uint64_t>&& on, std::vector<uint64_t>&& off, std::vector<const uint64_t*>&& divisors, const resubstitution_params& ps, resubstitution_stats& st )
+      : _num_blocks( num_blocks ),
+        _on( std::move( on ) ),
+        _off( std::move( off ) ),
+        _divisors( std::move( divisors ) ),
+        _ps( ps ),
+        _st( st )
+  {
+  }
+
+  std::optional<std::vector<uint32_t>> run()
+  {
+    const auto num_on = resub_count( _on.data(), _on.data(), 0u, _num_blocks );
+    const auto num_off = resub_count( _off.data(), _off.data(), 0u, _num_blocks );
+    if ( num_on == 0u || num_off == 0u )
+    {
+      return std::vector<uint32_t>{};
+    }
+    if ( _ps.max_divisors == 0u )
+    {
+      return std::nullopt;
+    }
+
+    /* one divisor */
+    for ( auto i = 0u; i < _divisors.size(); ++i )
+    {
+      ++_st.candidates;
+      if ( is_equal( lit( i, false ) ) || is_equal( lit( i, true ) ) )
+      {
+        return std::vector<uint32_t>{ i };
+      }
+    }
+    if ( _ps.max_divisors == 1u )
+    {
+      return std::nullopt;
+    }
+
+    compute_unate_literals( num_on, num_off );
+
+    /* two divisors */
+    if ( const auto res = search_or2() )
+    {
+      return res;
+    }
+    if ( _ps.use_xor )
+    {
+      if ( const auto res = search_xor2() )
+      {
+        return res;
+      }
+    }
+    if ( _ps.max_divisors == 2u )
+    {
+      return std::nullopt;
+    }
+
+    /* three divisors */
+    if ( const auto res = search_or3() )
+    {
+      return res;
+    }
+    return search_dependency3( num_on * num_off );
+  }
+
+private:
+  /* literal of a divisor, i.e., divisor index and complement */
+  static inline uint32_t lit( uint32_t divisor, bool complement )
+  {
+    return ( divisor << 1 ) | ( complement ? 1u : 0u );
+  }
+
+  inline const uint64_t* words( uint32_t lit ) const
+  {
+    return _divisors[lit >> 1];
+  }
+
+  static inline uint64_t mask( uint32_t lit )
+  {
+    return ( lit & 1 ) ? ~uint64_t( 0 ) : uint64_t( 0 );
+  }
+
+  /* the literal equals the target on the care set */
+  bool is_equal( uint32_t l ) const
+  {
+    const auto x = words( l );
+    const auto m = mask( l );
+    for ( auto i = 0u; i < _num_blocks; ++i )
+    {
+      const auto w = x[i] ^ m;
+      if ( ( w & _off[i] ) | ( ~w & _on[i] ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* literals that imply the target (index 0) or its complement (index 1) on
+     the care set, sorted by decreasing number of covered onset minterms */
+  void compute_unate_literals( uint64_t num_on, uint64_t num_off )
+  {
+    _num_on = { num_on, num_off };
+    for ( auto p = 0u; p < 2u; ++p )
+    {
+      const auto& on = p ? _off : _on;
+      const auto& off = p ? _on : _off;
+
+      std::vector<std::pair<uint64_t, uint32_t>> lits;
+      for ( auto l = 0u; l < 2u * _divisors.size(); ++l )
+      {
+        if ( resub_count( words( l ), off.data(), mask( l ), _num_blocks ) != 0u )
+        {
+          continue;
+        }
+        const auto count = resub_count( words( l ), on.data(), mask( l ), _num_blocks );
+        if ( count != 0u )
+        {
+          lits.emplace_back( count, l );
+        }
+      }
+      std::sort( lits.begin(), lits.end(), []( const auto& a, const auto& b ) { return a.first > b.first || ( a.first == b.first && a.second < b.second ); } );
+
+      _unate[p].clear();
+      _unate_count[p].clear();
+      for ( const auto& [count, l] : lits )
+      {
+        _unate[p].push_back( l );
+        _unate_count[p].push_back( count );
+      }
+      _st.unate_literals += static_cast<uint32_t>( lits.size() );
+    }
+  }
+
+  /* the disjunction of the literals covers the onset of the target or its
+     complement */
+  template<std::size_t K>
+  bool covers( uint32_t p, const std::array<uint32_t, K>& lits ) const
+  {
+    const auto& on = p ? _off : _on;
+    for ( auto i = 0u; i < _num_blocks; ++i )
+    {
+      auto w = on[i];
+      for ( auto l : lits )
+      {
+        w &= ~( words( l )[i] ^ mask( l ) );
+      }
+      if ( w )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* OR (p = 0) or AND (p = 1) of two unate literals */
+  std::optional<std::vector<uint32_t>> search_or2()
+  {
+    const auto size0 = _unate[0].size();
+    return search( size0 + _unate[1].size(), [&]( uint64_t index, uint64_t& candidates ) -> std::optional<std::vector<uint32_t>> {
+      const auto p = index < size0 ? 0u : 1u;
+      const auto i = p ? index - size0 : index;
+      const auto& lits = _unate[p];
+      const auto& count = _unate_count[p];
+      for ( auto j = i + 1u; j < lits.size(); ++j )
+      {
+        if ( count[i] + count[j] < _num_on[p] )
+        {
+          ++_cutoffs;
+          break;
+        }
+        if ( ( lits[i] >> 1 ) == ( lits[j] >> 1 ) )
+        {
+          continue;
+        }
+        ++candidates;
+        if ( covers<2>( p, { lits[i], lits[j] } ) )
+        {
+          return std::vector<uint32_t>{ lits[i] >> 1, lits[j] >> 1 };
+        }
+      }
+      return std::nullopt;
+    } );
+  }
+
+  /* XOR of two divisors */
+  std::optional<std::vector<uint32_t>> search_xor2()
+  {
+    const auto n = static_cast<uint32_t>( _divisors.size() );
+    return search( n, [&]( uint64_t i, uint64_t& candidates ) -> std::optional<std::vector<uint32_t>> {
+      const auto a = _divisors[i];
+      for ( auto j = static_cast<uint32_t>( i ) + 1u; j < n; ++j )
+      {
+        if ( aborted( i ) )
+        {
+          break;
+        }
+        ++candidates;
+
+        /* the XOR equals the target (bit 0) or its complement (bit 1) */
+        const auto b = _divisors[j];
+        auto ok = 3u;
+        for ( auto k = 0u; k < _num_blocks && ok; ++k )
+        {
+          const auto w = a[k] ^ b[k];
+          if ( ( w & _off[k] ) | ( ~w & _on[k] ) )
+          {
+            ok &= ~1u;
+          }
+          if ( ( w & _on[k] ) | ( ~w & _off[k] ) )
+          {
+            ok &= ~2u;
+          }
+        }
+        if ( ok )
+        {
+          return std::vector<uint32_t>{ static_cast<uint32_t>( i ), j };
+        }
+      }
+      return std::nullopt;
+    } );
+  }
+
+  /* OR (p = 0) or AND (p = 1) of three unate literals */
+  std::optional<std::vector<uint32_t>> search_or3()
+  {
+    const auto size0 = _unate[0].size();
+    return search( size0 + _unate[1].size(), [&]( uint64_t index, uint64_t& candidates ) -> std::optional<std::vector<uint32_t>> {
+      const auto p = index < size0 ? 0u : 1u;
+      const auto i = p ? index - size0 : index;
+      const auto& lits = _unate[p];
+      const auto& count = _unate_count[p];
+      for ( auto j = i + 1u; j + 1u < lits.size(); ++j )
+      {
+        if ( aborted( index ) )
+        {
+          break;
+        }
+        if ( count[i] + count[j] + count[j + 1u] < _num_on[p] )
+        {
+          ++_cutoffs;
+          break;
+        }
+        if ( ( lits[i] >> 1 ) == ( lits[j] >> 1 ) )
+        {
+          continue;
+        }
+        for ( auto k = j + 1u; k < lits.size(); ++k )
+        {
+          if ( count[i] + count[j] + count[k] < _num_on[p] )
+          {
+            ++_cutoffs;
+            break;
+          }
+          if ( ( lits[k] >> 1 ) == ( lits[i] >> 1 ) || ( lits[k] >> 1 ) == ( lits[j] >> 1 ) )
+          {
+            continue;
+          }
+          ++candidates;
+          if ( covers<3>( p, { lits[i], lits[j], lits[k] } ) )
+          {
+            return std::vector<uint32_t>{ lits[i] >> 1, lits[j] >> 1, lits[k] >> 1 };
+          }
+        }
+      }
+      return std::nullopt;
+    } );
+  }
+
+  /* the target is a function of three divisors, i.e., no assignment of the
+     divisors occurs in both the onset and the offset */
+  bool is_dependent( const uint64_t* a, const uint64_t* b, const uint64_t* c ) const
+  {
+    uint32_t seen_on = 0u, seen_off = 0u;
+    for ( auto i = 0u; i < _num_blocks; ++i )
+    {
+      for ( auto m = 0u; m < 8u; ++m )
+      {
+        const auto cell = ( ( m & 1 ) ? a[i] : ~a[i] ) & ( ( m & 2 ) ? b[i] : ~b[i] ) & ( ( m & 4 ) ? c[i] : ~c[i] );
+        seen_on |= ( ( cell & _on[i] ) != 0u ) << m;
+        seen_off |= ( ( cell & _off[i] ) != 0u ) << m;
+      }
+      if ( seen_on & seen_off )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* any function of three divisors; a pair of an onset and an offset
+     minterm must be distinguished by one of the divisors, hence the sum of
+     the distinguished pairs must be at least the number of all pairs */
+  std::optional<std::vector<uint32_t>> search_dependency3( uint64_t num_pairs )
+  {
+    const auto n = _divisors.size();
+    std::vector<uint64_t> power( n );
+    for ( auto i = 0u; i < n; ++i )
+    {
+      const auto d = _divisors[i];
+      power[i] = resub_count( d, _on.data(), 0u, _num_blocks ) * resub_count( d, _off.data(), ~uint64_t( 0 ), _num_blocks ) +
+                 resub_count( d, _on.data(), ~uint64_t( 0 ), _num_blocks ) * resub_count( d, _off.data(), 0u, _num_blocks );
+    }
+    std::vector<uint32_t> order( n );
+    std::iota( order.begin(), order.end(), 0u );
+    std::stable_sort( order.begin(), order.end(), [&]( auto a, auto b ) { return power[a] > power[b]; } );
+
+    return search( n, [&]( uint64_t i, uint64_t& candidates ) -> std::optional<std::vector<uint32_t>> {
+      const auto a = order[i];
+      for ( auto j = i + 1u; j + 1u < n; ++j )
+      {
+        if ( aborted( i ) )
+        {
+          break;
+        }
+        const auto b = order[j];
+        if ( power[a] + power[b] + power[order[j + 1u]] < num_pairs )
+        {
+          ++_cutoffs;
+          break;
+        }
+        for ( auto k = j + 1u; k < n; ++k )
+        {
+          const auto c = order[k];
+          if ( power[a] + power[b] + power[c] < num_pairs )
+          {
+            ++_cutoffs;
+            break;
+          }
+          ++candidates;
+          if ( is_dependent( _divisors[a], _divisors[b], _divisors[c] ) )
+          {
+            return std::vector<uint32_t>{ a, b, c };
+          }
+        }
+      }
+      return std::nullopt;
+    } );
+  }
+
+  inline bool aborted( uint64_t index ) const
+  {
+    return _best.load( std::memory_order_relaxed ) < index;
+  }
+
+  /* calls fn for outer indexes in increasing order and returns the solution
+     for the smallest index that has one; in parallel, indexes larger than
+     an index with a solution are abandoned */
+  template<typename Fn>
+  std::optional<std::vector<uint32_t>> search( uint64_t n, Fn&& fn )
+  {
+    std::vector<std::vector<uint32_t>> solutions( n );
+    std::atomic<uint64_t> candidates{ 0u };
+    _best = n;
+    _cutoffs = 0u;
+
+    const auto run = [&]( uint64_t from, uint64_t to ) {
+      uint64_t local = 0u;
+      for ( auto i = from; i < to && !aborted( i ); ++i )
+      {
+        if ( const auto sol = fn( i, local ) )
+        {
+          solutions[i] = *sol;
+          auto best = _best.load();
+          while ( i < best && !_best.compare_exchange_weak( best, i ) )
+          {
+          }
+          break;
+        }
+      }
+      candidates += local;
+    };
+
+    if ( _ps.num_threads == 1u || n < 2u )
+    {
+      run( 0u, n );
+    }
+    else
+    {
+      work_stealing_pool pool( _ps.num_threads );
+      task_group group;
+      const auto chunk = std::max<uint64_t>( 1u, n / ( 8u * pool.num_threads() ) );
+      for ( auto from = uint64_t( 0 ); from < n; from += chunk )
+      {
+        pool.submit( group, [&run, from, to = std::min( from + chunk, n )]() { run( from, to ); } );
+      }
+      pool.wait( group );
+    }
+
+    _st.candidates += candidates;
+    _st.cutoffs += _cutoffs;
+
+    const auto best = _best.load();
+    if ( best == n )
+    {
+      return std::nullopt;
+    }
+    auto& divisors = solutions[best];
+    std::sort( divisors.begin(), divisors.end() );
+    return std::move( divisors );
+  }
+
+private:
+  uint64_t _num_blocks;
+  std::vector<uint64_t> _on;
+  std::vector<uint64_t> _off;
+  std::vector<const uint64_t*> _divisors;
+  const resubstitution_params& _ps;
+  resubstitution_stats& _st;
+
+  std::array<uint64_t, 2> _num_on;
+  std::array<std::vector<uint32_t>, 2> _unate;
+  std::array<std::vector<uint64_t>, 2> _unate_count;
+
+  std::atomic<uint64_t> _best{ 0u };
+  std::atomic<uint64_t> _cutoffs{ 0u };
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Finds a resubstitution of a target function with few divisors
+
+  Finds at most `ps.max_divisors` (at most 3) divisors such that the target
+  function is a function of the divisors on the care set.  All truth tables
+  must have the same number of bits, e.g., partial truth tables of
+  simulation patterns or complete truth tables.  Candidates are tried in
+  the following order, and the first one that is found is returned:
+
+  - no divisor, if the target is constant
+  - one divisor, if the target equals a divisor or its complement
+  - two divisors that are combined with an AND gate, where the inputs and
+    the output may be complemented
+  - two divisors that are combined with an XOR gate (if `ps.use_xor`)
+  - three divisors that are combined with an AND gate with complemented
+    inputs and output
+  - three divisors with any function
+
+  AND gates are only searched for among the unate literals, i.e., divisors
+  or complemented divisors that imply the target or its complement.  These
+  literals are sorted by how many minterms of the target they cover, such
+  that loops can be cut off when the sum of these counts is too small.
+  Similarly, triples of divisors for arbitrary functions are sorted by the
+  number of onset-offset pairs of the target they distinguish, compare
+  `relative_distinguishing_power`.  A candidate is checked in a single pass
+  over the words of its divisors, which stops at the first word that
+  refutes it.
+
+  If `ps.num_threads` is not 1, outer loops are distributed over threads,
+  and loops with larger indexes than an index with a solution are stopped.
+  The result does not depend on the number of threads.
+
+  The returned candidate contains the function over the divisors and the
+  assignments of the divisors that occur in the care set.  The function is
+  0 for the other assignments.
+
+  \param target Target function
+  \param care Care set
+  \param divisors Divisor functions
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::optional<resubstitution_candidate> find_resubstitution( const TT& target, const TT& care, const std::vector<TT>& divisors, const resubstitution_params& ps = {}, resubstitution_stats* pst = nullptr )
+{
+  assert( ps.max_divisors <= 3u );
+  assert( target.num_bits() == care.num_bits() );
+  assert( std::all_of( divisors.begin(), divisors.end(), [&]( const auto& d ) { return d.num_bits() == target.num_bits(); } ) );
+
+  const uint64_t num_blocks = target.num_blocks();
+  const auto last_mask = ( target.num_bits() & 0x3f ) ? ( 0xFFFFFFFFFFFFFFFF >> ( 64 - ( target.num_bits() & 0x3f ) ) ) : 0xFFFFFFFFFFFFFFFF;
+
+  std::vector<uint64_t> on( num_blocks ), off( num_blocks );
+  std::transform( target.cbegin(), target.cend(), care.cbegin(), on.begin(), []( auto t, auto c ) { return t & c; } );
+  std::transform( target.cbegin(), target.cend(), care.cbegin(), off.begin(), []( auto t, auto c ) { return ~t & c; } );
+  if ( num_blocks )
+  {
+    on.back() &= last_mask;
+    off.back() &= last_mask;
+  }
+
+  std::vector<const uint64_t*> words( divisors.size() );
+  std::transform( divisors.begin(), divisors.end(), words.begin(), []( const auto& d ) { return &*d.cbegin(); } );
+
+  resubstitution_stats st;
+  const auto indexes = detail::resub_engine( num_blocks, std::vector<uint64_t>( on ), std::vector<uint64_t>( off ), std::move( words ), ps, st ).run();
+  if ( pst )
+  {
+    *pst = st;
+  }
+  if ( !indexes )
+  {
+    return std::nullopt;
+  }
+
+  /* function and care set over the divisors */
+  const auto k = static_cast<uint32_t>( indexes->size() );
+  resubstitution_candidate res{ *indexes, dynamic_truth_table( k ), dynamic_truth_table( k ) };
+  for ( auto i = 0u; i < num_blocks; ++i )
+  {
+    for ( auto m = 0u; m < ( 1u << k ); ++m )
+    {
+      auto cell = on[i] | off[i];
+      for ( auto v = 0u; v < k; ++v )
+      {
+        const auto w = *( divisors[( *indexes )[v]].cbegin() + i );
+        cell &= ( ( m >> v ) & 1 ) ? w : ~w;
+      }
+      if ( cell )
+      {
+        set_bit( res.care, m );
+      }
+      if ( cell & on[i] )
+      {
+        set_bit( res.function, m );
+      }
+    }
+  }
+  return res;
+}
+
+/*! \brief Finds a resubstitution of a completely specified target function
+
+  \param target Target function
+  \param divisors Divisor functions
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::optional<resubstitution_candidate> find_resubstitution( const TT& target, const std::vector<TT>& divisors, const resubstitution_params& ps = {}, resubstitution_stats* pst = nullptr )
+{
+  return find_resubstitution( target, ~target.construct(), divisors, ps, pst );
+}
+
+} /* namespace kitty */
@@ -32,16 +32,65 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
+#include <numeric>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "bit_operations.hpp"
+#include "constructors.hpp"
 #include "cube.hpp"
+#include "exact_sop.hpp"
+#include "isop.hpp"
+#include "operators.hpp"
+#include "pseudo_cube.hpp"
+#include "ternary_truth_table.hpp"
 #include "traits.hpp"
+#include "detail/constants.hpp"
+#include "detail/mscfix.hpp"
 
 namespace kitty
 {
 
+/*! \brief Parameters for minimize_spp */
+struct spp_params
+{
+  /*! Compute a cover of all prime pseudo cubes with the minimum number of
+      pseudo products instead of a greedy cover. */
+  bool exact{ false };
+
+  /*! Maximum number of direction spaces that are visited when generating
+      prime pseudo cubes in exact mode; if the limit is exceeded, the greedy
+      cover is returned. */
+  uint32_t max_spaces{ 10000u };
+
+  /*! Maximum number of branch-and-bound nodes in exact mode (0 = no limit). */
+  uint64_t max_nodes{ 0u };
+};
+
+/*! \brief Statistics for minimize_spp */
+struct spp_stats
+{
+  /*! Number of candidate pseudo cubes (prime pseudo cubes in exact mode,
+      pseudo cubes before removing redundant ones in greedy mode). */
+  uint32_t candidates{ 0u };
+
+  /*! Number of pseudo products in the result. */
+  uint32_t pseudo_cubes{ 0u };
+
+  /*! Number of literals in the result. */
+  uint32_t literals{ 0u };
+
+  /*! Number of branch-and-bound nodes in exact mode. */
+  uint64_t nodes{ 0u };
+
+  /*! Whether the result is proven to be minimum. */
+  bool optimal{ false };
+};
+
 /*! \brief Merges products in an ESOP into pseudo products
 
   Given, e.g., the two cubes `abc` and `abd`, this algorithm will combine them
@@ -153,4 +202,500 @@ void create_from_spp( TT& tt, const std::vector<cube>& cubes, const std::vector<
   }
 }
 
-} // namespace kitty
\ No newline at end of file
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* minterm sets over at most 16 variables with one bit per minterm */
+template<typename TT>
+std::vector<uint64_t> spp_words( const TT& tt )
+{
+  std::vector<uint64_t> words( tt.cbegin(), tt.cend() );
+  if ( tt.num_vars() < 6u )
+  {
+    words[0] &= masks[tt.num_vars()];
+  }
+  return words;
+}
+
+/* translates a word by the lower 6 bits of d, i.e., maps bit x to bit x ^ d */
+inline uint64_t spp_translate_word( uint64_t word, uint32_t d )
+{
+  for ( auto i = 0u; i < 6u; ++i )
+  {
+    if ( ( d >> i ) & 1 )
+    {
+      const auto s = 1u << i;
+      word = ( ( word & projections_neg[i] ) << s ) | ( ( word & projections[i] ) >> s );
+    }
+  }
+  return word;
+}
+
+/* computes { x in set : x ^ d in set }, returns false if empty */
+inline bool spp_intersect_translate( const std::vector<uint64_t>& set, uint32_t d, std::vector<uint64_t>& result )
+{
+  result.resize( set.size() );
+  uint64_t any = 0u;
+  const auto offset = d >> 6u;
+  for ( auto j = 0u; j < set.size(); ++j )
+  {
+    result[j] = set[j] & spp_translate_word( set[j ^ offset], d );
+    any |= result[j];
+  }
+  return any != 0u;
+}
+
+template<typename Fn>
+void spp_foreach_minterm( const std::vector<uint64_t>& set, Fn&& fn )
+{
+  for ( auto j = 0u; j < set.size(); ++j )
+  {
+    for ( auto word = set[j]; word; word &= word - 1 )
+    {
+      fn( ( j << 6u ) | static_cast<uint32_t>( __builtin_ctzll( word ) ) );
+    }
+  }
+}
+
+inline bool spp_has_minterm( const std::vector<uint64_t>& set, uint32_t m )
+{
+  return ( set[m >> 6u] >> ( m & 63u ) ) & 1;
+}
+
+class spp_minimizer
+{
+public:
+  spp_minimizer( std::vector<uint64_t> on, std::vector<uint64_t> f, std::vector<pseudo_cube> seeds, uint32_t num_vars, const spp_params& ps, spp_stats& st )
+      : _on( std::move( on ) ),
+        _f( std::move( f ) ),
+        _seeds( std::move( seeds ) ),
+        _num_vars( num_vars ),
+        _ps( ps ),
+        _st( st )
+  {
+  }
+
+  std::vector<pseudo_cube> run()
+  {
+    std::vector<pseudo_cube> cover;
+    std::vector<pseudo_cube> primes;
+    if ( _ps.exact && prime_pseudo_cubes( primes ) )
+    {
+      cover = exact_cover( primes );
+    }
+    else
+    {
+      cover = greedy_cover();
+      _st.optimal = false;
+    }
+
+    _st.pseudo_cubes = static_cast<uint32_t>( cover.size() );
+    _st.literals = 0u;
+    for ( const auto& c : cover )
+    {
+      _st.literals += c.num_literals( _num_vars );
+    }
+    return cover;
+  }
+
+private:
+  /* Grows pseudo cubes from the seed cubes that cover uncovered minterms,
+     starting with small cubes.  For the current pseudo cube p + V, the set g
+     contains all x for which x + V is contained in the function and
+     counts[x] is the number of uncovered minterms in x + V (valid for x in
+     g).  Each direction p ^ y with y in g keeps the pseudo cube inside the
+     function, the one that covers most uncovered minterms is added, and g
+     and counts are updated in linear time. */
+  std::vector<pseudo_cube> greedy_cover()
+  {
+    std::vector<pseudo_cube> cover;
+    auto remaining = _on;
+    std::vector<uint32_t> counts( _f.size() << 6u, 0u );
+    std::vector<uint64_t> g, tmp;
+
+    std::stable_sort( _seeds.begin(), _seeds.end(), []( const auto& a, const auto& b ) { return a.dimension() < b.dimension(); } );
+    for ( const auto& seed : _seeds )
+    {
+      auto uncovered = false;
+      seed.foreach_minterm( [&]( auto m ) { uncovered = uncovered || spp_has_minterm( remaining, m ); } );
+      if ( !uncovered )
+      {
+        continue;
+      }
+
+      pseudo_cube pc( seed.point() );
+      g = _f;
+      spp_foreach_minterm( g, [&]( auto x ) { counts[x] = spp_has_minterm( remaining, x ) ? 1u : 0u; } );
+
+      const auto extend = [&]( uint32_t d ) {
+        pc.add_direction( d );
+        spp_intersect_translate( g, d, tmp );
+        std::swap( g, tmp );
+
+        const auto bit = 31u - __builtin_clz( d );
+        spp_foreach_minterm( g, [&]( auto x ) {
+          if ( ( ( x >> bit ) & 1 ) == 0u )
+          {
+            counts[x] = counts[x ^ d] = counts[x] + counts[x ^ d];
+          }
+        } );
+      };
+
+      for ( auto i = 0u; i < seed.dimension(); ++i )
+      {
+        extend( seed._basis[i] );
+      }
+
+      while ( true )
+      {
+        /* canonical representatives of cosets have zeros at all pivots */
+        const auto pivot_mask = pc.pivots();
+        const auto point = pc.point();
+        uint32_t best_d = 0u, best_count = 0u, best_weight = 0u;
+        spp_foreach_minterm( g, [&]( auto y ) {
+          if ( ( y & pivot_mask ) != 0u || y == point )
+          {
+            return;
+          }
+          const auto d = y ^ point;
+          const auto weight = static_cast<uint32_t>( __builtin_popcount( d ) );
+          if ( best_d == 0u || counts[y] > best_count || ( counts[y] == best_count && weight < best_weight ) )
+          {
+            best_d = d;
+            best_count = counts[y];
+            best_weight = weight;
+          }
+        } );
+
+        if ( best_d == 0u )
+        {
+          break;
+        }
+        extend( best_d );
+      }
+
+      pc.foreach_minterm( [&]( auto m ) { remaining[m >> 6u] &= ~( uint64_t( 1 ) << ( m & 63u ) ); } );
+      cover.push_back( pc );
+    }
+    assert( std::all_of( remaining.begin(), remaining.end(), []( auto w ) { return w == 0u; } ) );
+
+    _st.candidates = static_cast<uint32_t>( cover.size() );
+    irredundant( cover );
+    return cover;
+  }
+
+  /* removes pseudo cubes whose care minterms are covered by others, trying
+     pseudo cubes with many literals first */
+  void irredundant( std::vector<pseudo_cube>& cover ) const
+  {
+    std::vector<uint32_t> covered( _on.size() << 6u, 0u );
+    for ( const auto& c : cover )
+    {
+      c.foreach_minterm( [&]( auto m ) { ++covered[m]; } );
+    }
+
+    std::vector<uint32_t> literals( cover.size() );
+    std::transform( cover.begin(), cover.end(), literals.begin(), [&]( const auto& c ) { return c.num_literals( _num_vars ); } );
+    std::vector<uint32_t> order( cover.size() );
+    std::iota( order.begin(), order.end(), 0u );
+    std::stable_sort( order.begin(), order.end(), [&]( auto a, auto b ) { return literals[a] > literals[b]; } );
+
+    std::vector<bool> removed( cover.size(), false );
+    for ( auto i : order )
+    {
+      auto redundant = true;
+      cover[i].foreach_minterm( [&]( auto m ) {
+        if ( covered[m] == 1u && spp_has_minterm( _on, m ) )
+        {
+          redundant = false;
+        }
+      } );
+      if ( redundant )
+      {
+        removed[i] = true;
+        cover[i].foreach_minterm( [&]( auto m ) { --covered[m]; } );
+      }
+    }
+
+    auto i = 0u;
+    cover.erase( std::remove_if( cover.begin(), cover.end(), [&]( const auto& ) { return removed[i++]; } ), cover.end() );
+  }
+
+  /* Enumerates direction spaces V by increasing dimension together with the
+     set g_V of minterms x such that x + V is contained in the function.  The
+     spaces of the next level are V + <d> for differences d of coset
+     representatives in g_V, indexed in a hash set, and g_{V + <d>} is the set
+     of x in g_V with x ^ d in g_V.  If g_V contains two cosets of V, both are
+     contained in a pseudo cube of the next dimension, hence the prime pseudo
+     cubes are the spaces with exactly one coset. */
+  bool prime_pseudo_cubes( std::vector<pseudo_cube>& primes )
+  {
+    struct space
+    {
+      pseudo_cube directions;
+      std::vector<uint64_t> cosets;
+    };
+
+    std::vector<space> level;
+    if ( std::any_of( _f.begin(), _f.end(), []( auto w ) { return w != 0u; } ) )
+    {
+      level.push_back( { pseudo_cube(), _f } );
+    }
+
+    uint32_t visited = 1u;
+    std::vector<uint32_t> reps, differences;
+    std::vector<uint64_t> cosets;
+    while ( !level.empty() )
+    {
+      std::vector<space> next;
+      std::unordered_set<pseudo_cube, hash<pseudo_cube>> seen;
+
+      for ( const auto& s : level )
+      {
+        const auto pivot_mask = s.directions.pivots();
+        reps.clear();
+        spp_foreach_minterm( s.cosets, [&]( auto x ) {
+          if ( ( x & pivot_mask ) == 0u )
+          {
+            reps.push_back( x );
+          }
+        } );
+
+        if ( reps.size() == 1u )
+        {
+          auto prime = s.directions;
+          prime._point = reps.front();
+          primes.push_back( prime );
+          continue;
+        }
+
+        /* candidate directions, either from pairs of cosets or all reduced vectors */
+        differences.clear();
+        const auto num_reduced = uint64_t( 1 ) << ( _num_vars - s.directions.dimension() );
+        if ( uint64_t( reps.size() ) * ( reps.size() - 1u ) / 2u <= num_reduced )
+        {
+          for ( auto a = 0u; a < reps.size(); ++a )
+          {
+            for ( auto b = a + 1u; b < reps.size(); ++b )
+            {
+              differences.push_back( reps[a] ^ reps[b] );
+            }
+          }
+          std::sort( differences.begin(), differences.end() );
+          differences.erase( std::unique( differences.begin(), differences.end() ), differences.end() );
+        }
+        else
+        {
+          for ( auto d = 1u; d < ( 1u << _num_vars ); ++d )
+          {
+            if ( ( d & pivot_mask ) == 0u )
+            {
+              differences.push_back( d );
+            }
+          }
+        }
+
+        for ( auto d : differences )
+        {
+          auto directions = s.directions;
+          directions.add_direction( d );
+          if ( !seen.insert( directions ).second )
+          {
+            continue;
+          }
+          if ( spp_intersect_translate( s.cosets, d, cosets ) )
+          {
+            if ( ++visited > _ps.max_spaces )
+            {
+              return false;
+            }
+            next.push_back( { directions, cosets } );
+          }
+        }
+      }
+
+      level = std::move( next );
+    }
+
+    return true;
+  }
+
+  std::vector<pseudo_cube> exact_cover( const std::vector<pseudo_cube>& primes )
+  {
+    /* rows are care minterms of the onset */
+    std::vector<uint32_t> row_index( _on.size() << 6u, 0u );
+    uint32_t num_rows = 0u;
+    spp_foreach_minterm( _on, [&]( auto m ) { row_index[m] = num_rows++; } );
+
+    std::vector<pseudo_cube> columns;
+    std::vector<covering_matrix::bitset> cols;
+    std::vector<uint32_t> costs;
+    for ( const auto& p : primes )
+    {
+      covering_matrix::bitset rows( ( num_rows + 63u ) >> 6u, 0u );
+      auto covers = false;
+      p.foreach_minterm( [&]( auto m ) {
+        if ( spp_has_minterm( _on, m ) )
+        {
+          const auto r = row_index[m];
+          rows[r >> 6] |= uint64_t( 1 ) << ( r & 63 );
+          covers = true;
+        }
+      } );
+      if ( covers )
+      {
+        columns.push_back( p );
+        cols.push_back( std::move( rows ) );
+        costs.push_back( p.num_literals( _num_vars ) );
+      }
+    }
+    _st.candidates = static_cast<uint32_t>( columns.size() );
+
+    std::vector<pseudo_cube> cover;
+    exact_sop_stats cst;
+    if ( num_rows > 0u )
+    {
+      covering_matrix matrix( num_rows, std::move( cols ), std::move( costs ), _ps.max_nodes );
+      for ( auto c : matrix.solve( cst ) )
+      {
+        cover.push_back( columns[c] );
+      }
+    }
+    _st.nodes = cst.nodes;
+    _st.optimal = cst.optimal;
+    return cover;
+  }
+
+private:
+  std::vector<uint64_t> _on;
+  std::vector<uint64_t> _f;
+  std::vector<pseudo_cube> _seeds;
+  uint32_t _num_vars;
+  const spp_params& _ps;
+  spp_stats& _st;
+};
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief SPP minimization
+
+  Computes a sum of pseudo products (SPP) for an incompletely specified
+  function with up to 16 variables, i.e., a disjunction of pseudo cubes that
+  covers the onset and is contained in the union of onset and don't care set.
+  Pseudo products generalize products by XOR factors; e.g., parity functions
+  have a single pseudo product.
+
+  In the default mode, pseudo cubes are grown greedily from the cubes of an
+  ISOP that still cover uncovered minterms: a direction is added as long as
+  the doubled pseudo cube stays inside the function, preferring directions
+  that cover most uncovered minterms and then directions with few variables.
+  Afterwards, redundant pseudo cubes are removed.  The resulting pseudo cubes
+  are prime and there are at most as many as cubes in the ISOP.
+
+  If `ps.exact` is set, all prime pseudo cubes are generated level by level
+  over their direction spaces, which are represented in reduced row echelon
+  form over GF(2) and indexed in a hash set.  The unate covering problem is
+  then solved as in `exact_sop`, minimizing the number of pseudo products
+  and then the number of literals.  Since functions can have very many
+  pseudo cubes, generation is limited by `ps.max_spaces`, and the greedy
+  cover is returned if the limit is exceeded.
+
+  Use `create_from_spp` to compute the truth table of the result.
+
+  \param on Truth table of onset
+  \param dc Truth table of don't care set
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<pseudo_cube> minimize_spp( const TT& on, const TT& dc, const spp_params& ps = {}, spp_stats* pst = nullptr )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+  assert( on.num_vars() <= pseudo_cube::max_vars );
+
+  const auto care_on = on & ~dc;
+  const auto f = on | dc;
+
+  /* the cubes of an ISOP are the seeds for the greedy cover */
+  std::vector<cube> cubes;
+  isop_engine( on.num_vars() ).run( care_on, f, cubes );
+  std::vector<pseudo_cube> seeds;
+  for ( const auto& c : cubes )
+  {
+    seeds.emplace_back( c, on.num_vars() );
+  }
+
+  spp_stats st;
+  const auto cover = detail::spp_minimizer( detail::spp_words( care_on ), detail::spp_words( f ), std::move( seeds ), on.num_vars(), ps, st ).run();
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return cover;
+}
+
+/*! \brief SPP minimization of a completely specified function
+
+  \param tt Truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<pseudo_cube> minimize_spp( const TT& tt, const spp_params& ps = {}, spp_stats* pst = nullptr )
+{
+  return minimize_spp( tt, tt.construct(), ps, pst );
+}
+
+/*! \brief SPP minimization of a ternary truth table
+
+  \param tt Ternary truth table
+  \param ps Parameters
+  \param pst Statistics (optional)
+*/
+template<typename TT>
+std::vector<pseudo_cube> minimize_spp( const ternary_truth_table<TT>& tt, const spp_params& ps = {}, spp_stats* pst = nullptr )
+{
+  return minimize_spp( tt._bits & tt._care, ~tt._care, ps, pst );
+}
+
+/*! \brief Creates truth table from a sum of pseudo products
+
+  Computes the disjunction of the pseudo products, e.g., of the result of
+  `minimize_spp`.  Each XOR factor is simulated on the projection functions.
+
+  \param tt Truth table
+  \param pseudo_cubes Pseudo cubes
+*/
+template<typename TT>
+void create_from_spp( TT& tt, const std::vector<pseudo_cube>& pseudo_cubes )
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
+
+  std::vector<TT> vars( tt.num_vars(), tt.construct() );
+  for ( auto i = 0u; i < tt.num_vars(); ++i )
+  {
+    create_nth_var( vars[i], i );
+  }
+
+  clear( tt );
+  for ( const auto& c : pseudo_cubes )
+  {
+    auto product = ~tt.construct(); /* const1 of same size */
+    c.foreach_factor( tt.num_vars(), [&]( auto mask, auto value ) {
+      auto sum = tt.construct();
+      for ( auto i = 0u; i < tt.num_vars(); ++i )
+      {
+        if ( ( mask >> i ) & 1 )
+        {
+          sum ^= vars[i];
+        }
+      }
+      product &= value ? sum : ~sum;
+    } );
+    tt |= product;
+  }
+}
+
+} // namespace kitty
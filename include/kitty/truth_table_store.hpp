@@ -0,0 +1,474 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file truth_table_store.hpp
+  \brief Unique table for truth tables with integer handles
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "constructors.hpp"
+#include "hash.hpp"
+#include "partial_truth_table.hpp"
+#include "traits.hpp"
+#include "detail/mscfix.hpp"
+#include "detail/utils.hpp"
+
+namespace kitty
+{
+
+/*! \brief Parameters for truth_table_store */
+struct truth_table_store_params
+{
+  /*! Number of independently locked stripes of the index (rounded up to a power of 2). */
+  uint32_t num_stripes{ 64u };
+
+  /*! Number of words in a page of the arena. */
+  uint64_t page_words{ UINT64_C( 1 ) << 16 };
+};
+
+/*! \brief Statistics for truth_table_store */
+struct truth_table_store_statistics
+{
+  /*! Number of stored truth tables. */
+  uint64_t entries{ 0u };
+
+  /*! Number of calls to insert. */
+  uint64_t insertions{ 0u };
+
+  /*! Number of calls to insert for truth tables that were already stored. */
+  uint64_t duplicates{ 0u };
+
+  /*! Bytes allocated for the arena of truth table words. */
+  uint64_t arena_bytes{ 0u };
+
+  /*! Bytes allocated for the table of entries and the hash index. */
+  uint64_t index_bytes{ 0u };
+
+  /*! Total memory usage in bytes. */
+  inline uint64_t memory_usage() const
+  {
+    return arena_bytes + index_bytes;
+  }
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* the shape of a truth table determines its number of words and is stored
+   instead of the truth table object */
+template<typename TT>
+struct store_traits
+{
+  static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete and partial truth tables." );
+
+  static inline uint64_t shape( const TT& tt )
+  {
+    return tt.num_vars();
+  }
+
+  static inline uint64_t num_blocks( uint64_t shape )
+  {
+    return shape <= 6u ? 1u : ( uint64_t( 1 ) << ( shape - 6u ) );
+  }
+
+  static inline TT construct( uint64_t shape )
+  {
+    return create<TT>( static_cast<unsigned>( shape ) );
+  }
+};
+
+template<>
+struct store_traits<partial_truth_table>
+{
+  static inline uint64_t shape( const partial_truth_table& tt )
+  {
+    return tt.num_bits();
+  }
+
+  static inline uint64_t num_blocks( uint64_t shape )
+  {
+    return ( shape + 63u ) >> 6;
+  }
+
+  static inline partial_truth_table construct( uint64_t shape )
+  {
+    return partial_truth_table( static_cast<uint32_t>( shape ) );
+  }
+};
+
+inline uint64_t store_hash( const uint64_t* words, uint64_t num_blocks, uint64_t shape )
+{
+  return kitty::hash_words( words, num_blocks, shape );
+}
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Unique table for truth tables
+
+  Stores each distinct truth table once and identifies it by a 32-bit ID
+  (hash consing).  IDs are assigned consecutively from 0 in the order of
+  insertion and remain valid for the lifetime of the store, such that two
+  stored truth tables are equal if and only if their IDs are equal, and
+  caches of function properties can use IDs as keys.
+
+  The words of all truth tables are stored in a flat arena of pages, which
+  are never moved, and entries are stored in segments of doubling size,
+  such that truth tables can be accessed by ID without locks while other
+  threads insert.  The hash index that maps contents to IDs is split into
+  stripes, each protected by its own mutex and implemented as an open
+  addressing table, such that threads can insert and look up truth tables
+  concurrently.
+
+  The store accepts complete truth tables (for dynamic truth tables, of
+  different numbers of variables) and partial truth tables.
+
+  Example:
+
+  \verbatim embed:rst
+  .. code-block:: c++
+
+     kitty::truth_table_store<kitty::dynamic_truth_table> store;
+     const auto id1 = store.insert( tt1 );
+     const auto id2 = store.insert( tt2 );
+     if ( id1 == id2 ) { ... } // tt1 == tt2
+     const auto tt = store[id1];
+  \endverbatim
+*/
+template<typename TT>
+class truth_table_store
+{
+  struct entry
+  {
+    const uint64_t* words;
+    uint64_t shape;
+    uint64_t hash;
+  };
+
+  struct slot
+  {
+    uint32_t tag;
+    uint32_t id;
+  };
+
+  struct alignas( 64 ) stripe
+  {
+    std::mutex mutex;
+    std::vector<slot> slots;
+    uint64_t num_entries{ 0u };
+    uint64_t insertions{ 0u };
+    uint64_t duplicates{ 0u };
+  };
+
+  static constexpr uint32_t empty_id = 0xffffffff;
+
+  /* segment s holds 2^(s + first_segment_log) entries */
+  static constexpr uint32_t first_segment_log = 10u;
+  static constexpr uint32_t num_segments = 33u - first_segment_log;
+
+public:
+  /*! \brief Constructor
+
+    \param ps Parameters
+  */
+  explicit truth_table_store( const truth_table_store_params& ps = {} )
+      : _num_stripes( detail::next_power_of_two( std::max( ps.num_stripes, 1u ) ) ),
+        _page_words( std::max<uint64_t>( ps.page_words, 1u ) ),
+        _stripes( new stripe[_num_stripes] )
+  {
+  }
+
+  truth_table_store( const truth_table_store& ) = delete;
+  truth_table_store& operator=( const truth_table_store& ) = delete;
+
+  /*! \brief Inserts a truth table and returns its ID
+
+    Returns the ID of an equal truth table if one is stored already.  This
+    function can be called concurrently.
+
+    \param tt Truth table
+  */
+  uint32_t insert( const TT& tt )
+  {
+    const auto shape = detail::store_traits<TT>::shape( tt );
+    const auto num_blocks = detail::store_traits<TT>::num_blocks( shape );
+    const auto words = num_blocks ? &*tt.cbegin() : nullptr;
+    const auto h = detail::store_hash( words, num_blocks, shape );
+
+    auto& s = _stripes[stripe_index( h )];
+    std::lock_guard<std::mutex> lock( s.mutex );
+    ++s.insertions;
+    if ( const auto id = find_in_stripe( s, h, words, num_blocks, shape ); id != empty_id )
+    {
+      ++s.duplicates;
+      return id;
+    }
+
+    const auto id = allocate( words, num_blocks, shape, h );
+    if ( 2u * ( s.num_entries + 1u ) > s.slots.size() )
+    {
+      rehash( s );
+    }
+    insert_in_stripe( s, h, id );
+    ++s.num_entries;
+    return id;
+  }
+
+  /*! \brief Returns the ID of a stored truth table
+
+    This function can be called concurrently.
+
+    \param tt Truth table
+  */
+  std::optional<uint32_t> find( const TT& tt ) const
+  {
+    const auto shape = detail::store_traits<TT>::shape( tt );
+    const auto num_blocks = detail::store_traits<TT>::num_blocks( shape );
+    const auto words = num_blocks ? &*tt.cbegin() : nullptr;
+    const auto h = detail::store_hash( words, num_blocks, shape );
+
+    auto& s = _stripes[stripe_index( h )];
+    std::lock_guard<std::mutex> lock( s.mutex );
+    if ( const auto id = find_in_stripe( s, h, words, num_blocks, shape ); id != empty_id )
+    {
+      return id;
+    }
+    return std::nullopt;
+  }
+
+  /*! \brief Returns a copy of a stored truth table
+
+    \param id ID
+  */
+  TT operator[]( uint32_t id ) const
+  {
+    const auto& e = get_entry( id );
+    auto tt = detail::store_traits<TT>::construct( e.shape );
+    std::copy( e.words, e.words + detail::store_traits<TT>::num_blocks( e.shape ), tt.begin() );
+    return tt;
+  }
+
+  /*! \brief Returns the words of a stored truth table
+
+    The words are stored in the arena and remain valid for the lifetime of
+    the store.
+
+    \param id ID
+  */
+  const uint64_t* words( uint32_t id ) const
+  {
+    return get_entry( id ).words;
+  }
+
+  /*! \brief Returns the number of words of a stored truth table
+
+    \param id ID
+  */
+  uint64_t num_blocks( uint32_t id ) const
+  {
+    return detail::store_traits<TT>::num_blocks( get_entry( id ).shape );
+  }
+
+  /*! \brief Returns the hash value of a stored truth table
+
+    \param id ID
+  */
+  uint64_t hash( uint32_t id ) const
+  {
+    return get_entry( id ).hash;
+  }
+
+  /*! \brief Returns the number of stored truth tables */
+  uint32_t size() const
+  {
+    return _size.load( std::memory_order_acquire );
+  }
+
+  /*! \brief Returns statistics, including the memory usage */
+  truth_table_store_statistics statistics() const
+  {
+    truth_table_store_statistics st;
+    for ( auto i = 0u; i < _num_stripes; ++i )
+    {
+      auto& s = _stripes[i];
+      std::lock_guard<std::mutex> lock( s.mutex );
+      st.insertions += s.insertions;
+      st.duplicates += s.duplicates;
+      st.index_bytes += s.slots.capacity() * sizeof( slot );
+    }
+
+    std::lock_guard<std::mutex> lock( _arena_mutex );
+    st.entries = _size.load();
+    st.arena_bytes = _arena_bytes;
+    st.index_bytes += _num_stripes * sizeof( stripe );
+    for ( auto s = 0u; s < num_segments && _segments[s]; ++s )
+    {
+      st.index_bytes += ( uint64_t( 1 ) << ( s + first_segment_log ) ) * sizeof( entry );
+    }
+    return st;
+  }
+
+private:
+  inline uint32_t stripe_index( uint64_t h ) const
+  {
+    return static_cast<uint32_t>( h >> 40 ) & ( _num_stripes - 1u );
+  }
+
+  static inline uint32_t tag( uint64_t h )
+  {
+    return static_cast<uint32_t>( h >> 32 );
+  }
+
+  static inline std::pair<uint32_t, uint64_t> segment_of( uint32_t id )
+  {
+    const auto v = uint64_t( id ) + ( uint64_t( 1 ) << first_segment_log );
+    const auto log = 63u - static_cast<uint32_t>( __builtin_clzll( v ) );
+    return { log - first_segment_log, v - ( uint64_t( 1 ) << log ) };
+  }
+
+  const entry& get_entry( uint32_t id ) const
+  {
+    assert( id < size() );
+    const auto [s, offset] = segment_of( id );
+    return _segment_ptrs[s].load( std::memory_order_acquire )[offset];
+  }
+
+  uint32_t find_in_stripe( const stripe& s, uint64_t h, const uint64_t* words, uint64_t num_blocks, uint64_t shape ) const
+  {
+    if ( s.slots.empty() )
+    {
+      return empty_id;
+    }
+    const auto mask = s.slots.size() - 1u;
+    for ( auto i = h & mask;; i = ( i + 1u ) & mask )
+    {
+      const auto& sl = s.slots[i];
+      if ( sl.id == empty_id )
+      {
+        return empty_id;
+      }
+      if ( sl.tag == tag( h ) )
+      {
+        const auto& e = get_entry( sl.id );
+        if ( e.hash == h && e.shape == shape && std::equal( words, words + num_blocks, e.words ) )
+        {
+          return sl.id;
+        }
+      }
+    }
+  }
+
+  void insert_in_stripe( stripe& s, uint64_t h, uint32_t id )
+  {
+    const auto mask = s.slots.size() - 1u;
+    auto i = h & mask;
+    while ( s.slots[i].id != empty_id )
+    {
+      i = ( i + 1u ) & mask;
+    }
+    s.slots[i] = { tag( h ), id };
+  }
+
+  void rehash( stripe& s )
+  {
+    std::vector<slot> old( std::max<std::size_t>( 16u, 2u * s.slots.size() ), slot{ 0u, empty_id } );
+    std::swap( old, s.slots );
+    for ( const auto& sl : old )
+    {
+      if ( sl.id != empty_id )
+      {
+        insert_in_stripe( s, get_entry( sl.id ).hash, sl.id );
+      }
+    }
+  }
+
+  /* copies the words into the arena and creates a new entry */
+  uint32_t allocate( const uint64_t* words, uint64_t num_blocks, uint64_t shape, uint64_t h )
+  {
+    std::lock_guard<std::mutex> lock( _arena_mutex );
+
+    const auto id = _size.load( std::memory_order_relaxed );
+    assert( id != empty_id );
+
+    uint64_t* dest = nullptr;
+    if ( num_blocks > 0u )
+    {
+      if ( _page_used + num_blocks > _page_size )
+      {
+        _page_size = std::max( _page_words, num_blocks );
+        _pages.emplace_back( new uint64_t[_page_size] );
+        _arena_bytes += _page_size * sizeof( uint64_t );
+        _page_used = 0u;
+      }
+      dest = _pages.back().get() + _page_used;
+      _page_used += num_blocks;
+      std::copy( words, words + num_blocks, dest );
+    }
+
+    const auto [s, offset] = segment_of( id );
+    if ( !_segments[s] )
+    {
+      _segments[s].reset( new entry[uint64_t( 1 ) << ( s + first_segment_log )] );
+      _segment_ptrs[s].store( _segments[s].get(), std::memory_order_release );
+    }
+    _segments[s][offset] = { dest, shape, h };
+
+    _size.store( id + 1u, std::memory_order_release );
+    return id;
+  }
+
+private:
+  uint32_t _num_stripes;
+  uint64_t _page_words;
+  std::unique_ptr<stripe[]> _stripes;
+
+  mutable std::mutex _arena_mutex;
+  std::vector<std::unique_ptr<uint64_t[]>> _pages;
+  uint64_t _page_size{ 0u };
+  uint64_t _page_used{ 0u };
+  uint64_t _arena_bytes{ 0u };
+
+  std::array<std::unique_ptr<entry[]>, num_segments> _segments;
+  std::array<std::atomic<entry*>, num_segments> _segment_ptrs{};
+  std::atomic<uint32_t> _size{ 0u };
+};
+
+} /* namespace kitty */
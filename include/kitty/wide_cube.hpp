@@ -0,0 +1,660 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file wide_cube.hpp
+  \brief Cubes with more than 32 variables
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cube.hpp"
+#include "hash.hpp"
+#include "detail/mscfix.hpp"
+
+namespace kitty
+{
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+inline int popcount64( uint64_t word )
+{
+  return __builtin_popcount( word & 0xffffffff ) + __builtin_popcount( word >> 32 );
+}
+
+inline uint64_t hash_words( const uint64_t* bits, const uint64_t* mask, uint64_t num_words )
+{
+  uint64_t seed = 0u;
+  for ( auto i = 0u; i < num_words; ++i )
+  {
+    seed ^= std::hash<uint64_t>{}( bits[i] ) + 0x9e3779b97f4a7c15 + ( seed << 6 ) + ( seed >> 2 );
+    seed ^= std::hash<uint64_t>{}( mask[i] ) + 0x9e3779b97f4a7c15 + ( seed << 6 ) + ( seed >> 2 );
+  }
+  return seed;
+}
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Cube with a fixed number of variables
+
+  Like `cube`, but the polarity and care bitmasks are stored in
+  \f$\lceil \text{NumVars} / 64 \rceil\f$ words each, such that cubes with more
+  than 32 variables can be represented.  It provides the same interface as
+  `cube` and can be used as cube type in `isop`, `create_from_cubes`,
+  `get_prime_implicants_morreale`, and `cnf_characteristic`.
+
+  \tparam NumVars Maximum number of variables
+*/
+template<uint32_t NumVars>
+class wide_cube
+{
+public:
+  /*! Number of words for each bitmask */
+  static constexpr uint32_t num_words = ( NumVars + 63u ) >> 6u;
+
+  /*! \brief Constructs the empty cube
+
+    Represents the one-cube
+  */
+  wide_cube()
+  {
+    _bits.fill( 0u );
+    _mask.fill( 0u );
+  }
+
+  /*! \brief Constructs a cube from bits and mask of the first 64 variables
+
+    \param bits Polarity bitmask of variables (0: negative, 1: positive)
+    \param mask Care bitmask of variables (1: part of cube, 0: not part of cube)
+  */
+  wide_cube( uint64_t bits, uint64_t mask ) : wide_cube()
+  {
+    _bits[0] = bits;
+    _mask[0] = mask;
+  }
+
+  /*! \brief Constructs a cube from a string
+
+    Each character corresponds to one literal in the cube.  Only up to first
+    `NumVars` characters of the string will be considered.  A '1' in the
+    string corresponds to a postive literal, a '0' corresponds to a negative
+    literal.  All other characters represent don't care, but it is customary to
+    use '-'.
+
+    \param str String representing a cube
+  */
+  // cppcheck-suppress noExplicitConstructor
+  wide_cube( const std::string& str ) : wide_cube() /* NOLINT */
+  {
+    const auto length = std::min<uint64_t>( str.size(), NumVars );
+    for ( auto i = 0u; i < length; ++i )
+    {
+      if ( str[i] == '0' || str[i] == '1' )
+      {
+        add_literal( i, str[i] == '1' );
+      }
+    }
+  }
+
+  /*! \brief Returns number of literals */
+  inline int num_literals() const
+  {
+    int n = 0;
+    for ( auto i = 0u; i < num_words; ++i )
+    {
+      n += detail::popcount64( _mask[i] );
+    }
+    return n;
+  }
+
+  /*! \brief Returns the distance to another cube */
+  inline int distance( const wide_cube& that ) const
+  {
+    int n = 0;
+    for ( auto i = 0u; i < num_words; ++i )
+    {
+      n += detail::popcount64( ( _bits[i] ^ that._bits[i] ) | ( _mask[i] ^ that._mask[i] ) );
+    }
+    return n;
+  }
+
+  /*! \brief Checks whether two cubes are equivalent */
+  inline bool operator==( const wide_cube& that ) const
+  {
+    return _bits == that._bits && _mask == that._mask;
+  }
+
+  /*! \brief Checks whether two cubes are not equivalent */
+  inline bool operator!=( const wide_cube& that ) const
+  {
+    return !( *this == that );
+  }
+
+  /*! \brief Default comparison operator */
+  inline bool operator<( const wide_cube& that ) const
+  {
+    for ( auto i = num_words; i-- > 0u; )
+    {
+      if ( _mask[i] != that._mask[i] )
+      {
+        return _mask[i] < that._mask[i];
+      }
+      if ( _bits[i] != that._bits[i] )
+      {
+        return _bits[i] < that._bits[i];
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Returns the cube with negated literals
+
+    Unlike `cube::operator~`, which also complements the bits of variables
+    that do not appear in the cube, bits outside the mask are kept 0, such
+    that equality and hashing only depend on the literals of the cube.
+  */
+  inline wide_cube operator~() const
+  {
+    wide_cube c;
+    for ( auto i = 0u; i < num_words; ++i )
+    {
+      c._bits[i] = ~_bits[i] & _mask[i];
+      c._mask[i] = _mask[i];
+    }
+    return c;
+  }
+
+  /*! \brief Merges two cubes of distance-1 */
+  inline wide_cube merge( const wide_cube& that ) const
+  {
+    wide_cube c;
+    for ( auto i = 0u; i < num_words; ++i )
+    {
+      const auto d = ( _bits[i] ^ that._bits[i] ) | ( _mask[i] ^ that._mask[i] );
+      c._bits[i] = _bits[i] ^ ( ~that._bits[i] & d );
+      c._mask[i] = _mask[i] ^ ( that._mask[i] & d );
+    }
+    return c;
+  }
+
+  /*! \brief Adds literal to cube */
+  inline void add_literal( uint32_t var_index, bool polarity = true )
+  {
+    set_mask( var_index );
+
+    if ( polarity )
+    {
+      set_bit( var_index );
+    }
+    else
+    {
+      clear_bit( var_index );
+    }
+  }
+
+  /*! \brief Removes literal from cube */
+  inline void remove_literal( uint32_t var_index )
+  {
+    clear_mask( var_index );
+    clear_bit( var_index );
+  }
+
+  /*! \brief Constructs the elementary cube representing a single variable */
+  static wide_cube nth_var_cube( uint32_t var_index )
+  {
+    wide_cube c;
+    c.add_literal( var_index, true );
+    return c;
+  }
+
+  /*! \brief Constructs the elementary cube containing the first k positive literals */
+  static wide_cube pos_cube( uint32_t k )
+  {
+    wide_cube c;
+    for ( auto i = 0u; i < k; ++i )
+    {
+      c.add_literal( i, true );
+    }
+    return c;
+  }
+
+  /*! \brief Constructs the elementary cube containing the first k negative literals */
+  static wide_cube neg_cube( uint32_t k )
+  {
+    wide_cube c;
+    for ( auto i = 0u; i < k; ++i )
+    {
+      c.add_literal( i, false );
+    }
+    return c;
+  }
+
+  /*! \brief Prints a cube */
+  inline void print( unsigned length = NumVars, std::ostream& os = std::cout ) const
+  {
+    for ( auto i = 0u; i < length; ++i )
+    {
+      os << ( get_mask( i ) ? ( get_bit( i ) ? '1' : '0' ) : '-' );
+    }
+  }
+
+  /*! \brief Gets bit at index */
+  inline bool get_bit( uint32_t index ) const
+  {
+    return ( ( _bits[index >> 6] >> ( index & 63 ) ) & 1 ) != 0;
+  }
+
+  /*! \brief Gets mask at index */
+  inline bool get_mask( uint32_t index ) const
+  {
+    return ( ( _mask[index >> 6] >> ( index & 63 ) ) & 1 ) != 0;
+  }
+
+  /*! \brief Sets bit at index */
+  inline void set_bit( uint32_t index )
+  {
+    _bits[index >> 6] |= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /*! \brief Sets mask at index */
+  inline void set_mask( uint32_t index )
+  {
+    _mask[index >> 6] |= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /*! \brief Clears bit at index */
+  inline void clear_bit( uint32_t index )
+  {
+    _bits[index >> 6] &= ~( uint64_t( 1 ) << ( index & 63 ) );
+  }
+
+  /*! \brief Clears mask at index */
+  inline void clear_mask( uint32_t index )
+  {
+    _mask[index >> 6] &= ~( uint64_t( 1 ) << ( index & 63 ) );
+  }
+
+  /*! \brief Flips bit at index */
+  inline void flip_bit( uint32_t index )
+  {
+    _bits[index >> 6] ^= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /*! \brief Flips mask at index */
+  inline void flip_mask( uint32_t index )
+  {
+    _mask[index >> 6] ^= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /* cube data */
+  std::array<uint64_t, num_words> _bits;
+  std::array<uint64_t, num_words> _mask;
+};
+
+/*! \brief Cube with a variable number of variables
+
+  Like `wide_cube`, but the number of words grows with the largest variable
+  index in the cube.  Cubes that only differ in trailing zero words are
+  considered equal.
+*/
+class dynamic_cube
+{
+public:
+  /*! \brief Constructs the empty cube
+
+    Represents the one-cube
+  */
+  dynamic_cube() = default;
+
+  /*! \brief Constructs a cube from bits and mask of the first 64 variables
+
+    \param bits Polarity bitmask of variables (0: negative, 1: positive)
+    \param mask Care bitmask of variables (1: part of cube, 0: not part of cube)
+  */
+  dynamic_cube( uint64_t bits, uint64_t mask ) : _bits( 1u, bits ), _mask( 1u, mask ) {}
+
+  /*! \brief Constructs a cube from a string
+
+    Each character corresponds to one literal in the cube.  A '1' in the
+    string corresponds to a postive literal, a '0' corresponds to a negative
+    literal.  All other characters represent don't care, but it is customary to
+    use '-'.
+
+    \param str String representing a cube
+  */
+  // cppcheck-suppress noExplicitConstructor
+  dynamic_cube( const std::string& str ) /* NOLINT */
+  {
+    for ( auto i = 0u; i < str.size(); ++i )
+    {
+      if ( str[i] == '0' || str[i] == '1' )
+      {
+        add_literal( i, str[i] == '1' );
+      }
+    }
+  }
+
+  /*! \brief Returns number of literals */
+  inline int num_literals() const
+  {
+    int n = 0;
+    for ( auto word : _mask )
+    {
+      n += detail::popcount64( word );
+    }
+    return n;
+  }
+
+  /*! \brief Returns the distance to another cube */
+  inline int distance( const dynamic_cube& that ) const
+  {
+    int n = 0;
+    for ( auto i = 0u; i < std::max( _bits.size(), that._bits.size() ); ++i )
+    {
+      n += detail::popcount64( ( bits_word( i ) ^ that.bits_word( i ) ) | ( mask_word( i ) ^ that.mask_word( i ) ) );
+    }
+    return n;
+  }
+
+  /*! \brief Checks whether two cubes are equivalent */
+  inline bool operator==( const dynamic_cube& that ) const
+  {
+    for ( auto i = 0u; i < std::max( _bits.size(), that._bits.size() ); ++i )
+    {
+      if ( bits_word( i ) != that.bits_word( i ) || mask_word( i ) != that.mask_word( i ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief Checks whether two cubes are not equivalent */
+  inline bool operator!=( const dynamic_cube& that ) const
+  {
+    return !( *this == that );
+  }
+
+  /*! \brief Default comparison operator */
+  inline bool operator<( const dynamic_cube& that ) const
+  {
+    for ( auto i = std::max( _bits.size(), that._bits.size() ); i-- > 0u; )
+    {
+      if ( mask_word( i ) != that.mask_word( i ) )
+      {
+        return mask_word( i ) < that.mask_word( i );
+      }
+      if ( bits_word( i ) != that.bits_word( i ) )
+      {
+        return bits_word( i ) < that.bits_word( i );
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Returns the cube with negated literals
+
+    Unlike `cube::operator~`, which also complements the bits of variables
+    that do not appear in the cube, bits outside the mask are kept 0, such
+    that equality and hashing only depend on the literals of the cube.
+  */
+  inline dynamic_cube operator~() const
+  {
+    dynamic_cube c = *this;
+    for ( auto i = 0u; i < c._bits.size(); ++i )
+    {
+      c._bits[i] = ~c._bits[i] & c._mask[i];
+    }
+    return c;
+  }
+
+  /*! \brief Merges two cubes of distance-1 */
+  inline dynamic_cube merge( const dynamic_cube& that ) const
+  {
+    dynamic_cube c;
+    const auto size = std::max( _bits.size(), that._bits.size() );
+    c._bits.resize( size );
+    c._mask.resize( size );
+    for ( auto i = 0u; i < size; ++i )
+    {
+      const auto d = ( bits_word( i ) ^ that.bits_word( i ) ) | ( mask_word( i ) ^ that.mask_word( i ) );
+      c._bits[i] = bits_word( i ) ^ ( ~that.bits_word( i ) & d );
+      c._mask[i] = mask_word( i ) ^ ( that.mask_word( i ) & d );
+    }
+    return c;
+  }
+
+  /*! \brief Adds literal to cube */
+  inline void add_literal( uint32_t var_index, bool polarity = true )
+  {
+    set_mask( var_index );
+
+    if ( polarity )
+    {
+      set_bit( var_index );
+    }
+    else
+    {
+      clear_bit( var_index );
+    }
+  }
+
+  /*! \brief Removes literal from cube */
+  inline void remove_literal( uint32_t var_index )
+  {
+    clear_mask( var_index );
+    clear_bit( var_index );
+  }
+
+  /*! \brief Constructs the elementary cube representing a single variable */
+  static dynamic_cube nth_var_cube( uint32_t var_index )
+  {
+    dynamic_cube c;
+    c.add_literal( var_index, true );
+    return c;
+  }
+
+  /*! \brief Constructs the elementary cube containing the first k positive literals */
+  static dynamic_cube pos_cube( uint32_t k )
+  {
+    dynamic_cube c;
+    for ( auto i = 0u; i < k; ++i )
+    {
+      c.add_literal( i, true );
+    }
+    return c;
+  }
+
+  /*! \brief Constructs the elementary cube containing the first k negative literals */
+  static dynamic_cube neg_cube( uint32_t k )
+  {
+    dynamic_cube c;
+    for ( auto i = 0u; i < k; ++i )
+    {
+      c.add_literal( i, false );
+    }
+    return c;
+  }
+
+  /*! \brief Prints a cube */
+  inline void print( unsigned length, std::ostream& os = std::cout ) const
+  {
+    for ( auto i = 0u; i < length; ++i )
+    {
+      os << ( get_mask( i ) ? ( get_bit( i ) ? '1' : '0' ) : '-' );
+    }
+  }
+
+  /*! \brief Gets bit at index */
+  inline bool get_bit( uint32_t index ) const
+  {
+    return ( ( bits_word( index >> 6 ) >> ( index & 63 ) ) & 1 ) != 0;
+  }
+
+  /*! \brief Gets mask at index */
+  inline bool get_mask( uint32_t index ) const
+  {
+    return ( ( mask_word( index >> 6 ) >> ( index & 63 ) ) & 1 ) != 0;
+  }
+
+  /*! \brief Sets bit at index */
+  inline void set_bit( uint32_t index )
+  {
+    reserve( index );
+    _bits[index >> 6] |= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /*! \brief Sets mask at index */
+  inline void set_mask( uint32_t index )
+  {
+    reserve( index );
+    _mask[index >> 6] |= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /*! \brief Clears bit at index */
+  inline void clear_bit( uint32_t index )
+  {
+    if ( ( index >> 6 ) < _bits.size() )
+    {
+      _bits[index >> 6] &= ~( uint64_t( 1 ) << ( index & 63 ) );
+    }
+  }
+
+  /*! \brief Clears mask at index */
+  inline void clear_mask( uint32_t index )
+  {
+    if ( ( index >> 6 ) < _mask.size() )
+    {
+      _mask[index >> 6] &= ~( uint64_t( 1 ) << ( index & 63 ) );
+    }
+  }
+
+  /*! \brief Flips bit at index */
+  inline void flip_bit( uint32_t index )
+  {
+    reserve( index );
+    _bits[index >> 6] ^= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /*! \brief Flips mask at index */
+  inline void flip_mask( uint32_t index )
+  {
+    reserve( index );
+    _mask[index >> 6] ^= uint64_t( 1 ) << ( index & 63 );
+  }
+
+  /*! \brief Returns the number of words, excluding trailing zero words */
+  inline uint64_t num_words() const
+  {
+    auto size = _bits.size();
+    while ( size > 0u && _bits[size - 1u] == 0u && _mask[size - 1u] == 0u )
+    {
+      --size;
+    }
+    return size;
+  }
+
+private:
+  inline uint64_t bits_word( uint64_t index ) const
+  {
+    return index < _bits.size() ? _bits[index] : 0u;
+  }
+
+  inline uint64_t mask_word( uint64_t index ) const
+  {
+    return index < _mask.size() ? _mask[index] : 0u;
+  }
+
+  inline void reserve( uint32_t var_index )
+  {
+    if ( ( var_index >> 6 ) >= _bits.size() )
+    {
+      _bits.resize( ( var_index >> 6 ) + 1u, 0u );
+      _mask.resize( ( var_index >> 6 ) + 1u, 0u );
+    }
+  }
+
+public:
+  /* cube data */
+  std::vector<uint64_t> _bits;
+  std::vector<uint64_t> _mask;
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* negates all literals in a cube */
+inline void negate_literals( cube& c )
+{
+  c._bits = ~c._bits & c._mask;
+}
+
+template<uint32_t NumVars>
+inline void negate_literals( wide_cube<NumVars>& c )
+{
+  c = ~c;
+}
+
+inline void negate_literals( dynamic_cube& c )
+{
+  c = ~c;
+}
+
+} /* namespace detail */
+/*! \endcond */
+
+template<uint32_t NumVars>
+struct hash<wide_cube<NumVars>>
+{
+  std::size_t operator()( const wide_cube<NumVars>& c ) const
+  {
+    return detail::hash_words( c._bits.data(), c._mask.data(), wide_cube<NumVars>::num_words );
+  }
+};
+
+template<>
+struct hash<dynamic_cube>
+{
+  std::size_t operator()( const dynamic_cube& c ) const
+  {
+    return detail::hash_words( c._bits.data(), c._mask.data(), c.num_words() );
+  }
+};
+
+} // namespace kitty
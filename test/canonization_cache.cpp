@@ -0,0 +1,269 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <kitty/canonization_cache.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/static_truth_table.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class CanonizationCacheTest : public kitty::testing::Test
+{
+};
+
+TEST_F( CanonizationCacheTest, npn_static )
+{
+  exact_npn_canonization_cache<static_truth_table<4>> cache;
+
+  std::vector<static_truth_table<4>> funcs( 50u );
+  for ( auto& tt : funcs )
+  {
+    create_random( tt );
+  }
+
+  for ( auto round = 0; round < 2; ++round )
+  {
+    for ( const auto& tt : funcs )
+    {
+      const auto config = cache( tt );
+      EXPECT_EQ( config, exact_npn_canonization( tt ) );
+      EXPECT_EQ( create_from_npn_config( config ), tt );
+    }
+  }
+
+  const auto st = cache.statistics();
+  EXPECT_EQ( st.hits + st.misses, 100u );
+  EXPECT_GE( st.hits, 50u );
+  EXPECT_EQ( st.evictions, 0u );
+  EXPECT_EQ( st.entries, st.misses );
+  EXPECT_GT( st.memory_usage, 0u );
+
+  cache.reset_statistics();
+  cache.clear();
+  cache( funcs.front() );
+  EXPECT_EQ( cache.statistics().misses, 1u );
+  EXPECT_EQ( cache.statistics().entries, 1u );
+}
+
+TEST_F( CanonizationCacheTest, spectral_dynamic )
+{
+  exact_spectral_canonization_cache<dynamic_truth_table> cache;
+
+  dynamic_truth_table tt( 4u );
+  for ( auto i = 0; i < 20; ++i )
+  {
+    create_random( tt );
+    const auto first = cache( tt );
+    const auto second = cache( tt );
+    EXPECT_EQ( first.first, exact_spectral_canonization( tt ) );
+    EXPECT_EQ( first.first, second.first );
+    EXPECT_EQ( first.second.size(), second.second.size() );
+  }
+
+  EXPECT_EQ( cache.statistics().hits, 20u );
+}
+
+TEST_F( CanonizationCacheTest, custom_functor_and_eviction )
+{
+  canonization_cache_params ps;
+  ps.memory_budget = 1024u;
+  ps.num_stripes = 2u;
+
+  auto calls = 0u;
+  auto cache = make_canonization_cache<static_truth_table<6>>( [&]( const auto& tt ) { ++calls; return sifting_npn_canonization( tt ); }, ps );
+
+  static_truth_table<6> tt;
+  for ( auto i = 0u; i < 500u; ++i )
+  {
+    create_random( tt );
+    EXPECT_EQ( cache( tt ), sifting_npn_canonization( tt ) );
+  }
+
+  const auto st = cache.statistics();
+  EXPECT_EQ( calls, st.misses );
+  EXPECT_GT( st.evictions, 0u );
+  EXPECT_LE( st.memory_usage, ps.memory_budget );
+  EXPECT_EQ( st.entries + st.evictions, st.misses );
+
+  cache.set_memory_budget( 0u );
+  EXPECT_EQ( cache.statistics().entries, 0u );
+  EXPECT_EQ( cache.statistics().memory_usage, 0u );
+}
+
+TEST_F( CanonizationCacheTest, disabled_cache )
+{
+  canonization_cache_params ps;
+  ps.memory_budget = 0u;
+
+  auto calls = 0u;
+  auto cache = make_canonization_cache<static_truth_table<4>>( [&]( const auto& tt ) { ++calls; return exact_npn_canonization( tt ); }, ps );
+
+  static_truth_table<4> tt;
+  create_random( tt );
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    EXPECT_EQ( cache( tt ), exact_npn_canonization( tt ) );
+  }
+
+  const auto st = cache.statistics();
+  EXPECT_EQ( calls, 3u );
+  EXPECT_EQ( st.hits, 0u );
+  EXPECT_EQ( st.misses, 3u );
+  EXPECT_EQ( st.evictions, 0u );
+  EXPECT_EQ( st.entries, 0u );
+  EXPECT_EQ( st.memory_usage, 0u );
+
+  /* too small for a single bucket */
+  cache.set_memory_budget( 16u );
+  cache( tt );
+  EXPECT_EQ( cache.statistics().entries, 0u );
+  EXPECT_EQ( cache.statistics().evictions, 0u );
+
+  cache.set_memory_budget( UINT64_C( 1 ) << 20 );
+  cache( tt );
+  cache( tt );
+  EXPECT_EQ( cache.statistics().entries, 1u );
+  EXPECT_EQ( cache.statistics().hits, 1u );
+}
+
+namespace
+{
+/* result type without default constructor */
+struct num_ones
+{
+  explicit num_ones( uint64_t value ) : value( value ) {}
+
+  uint64_t value;
+};
+} // namespace
+
+TEST_F( CanonizationCacheTest, non_default_constructible_result )
+{
+  auto cache = make_canonization_cache<dynamic_truth_table>( []( const auto& tt ) { return num_ones( count_ones( tt ) ); } );
+
+  dynamic_truth_table tt( 7u );
+  create_random( tt );
+  EXPECT_EQ( cache( tt ).value, count_ones( tt ) );
+  EXPECT_EQ( cache( tt ).value, count_ones( tt ) );
+  EXPECT_EQ( cache.statistics().hits, 1u );
+}
+
+TEST_F( CanonizationCacheTest, concurrent_access )
+{
+  exact_npn_canonization_cache<static_truth_table<5>> cache;
+
+  std::vector<static_truth_table<5>> funcs( 64u );
+  for ( auto& tt : funcs )
+  {
+    create_random( tt );
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<uint32_t> errors( 4u, 0u );
+  for ( auto t = 0u; t < 4u; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      for ( auto round = 0u; round < 4u; ++round )
+      {
+        for ( const auto& tt : funcs )
+        {
+          if ( create_from_npn_config( cache( tt ) ) != tt )
+          {
+            ++errors[t];
+          }
+        }
+      }
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( auto e : errors )
+  {
+    EXPECT_EQ( e, 0u );
+  }
+
+  const auto st = cache.statistics();
+  EXPECT_EQ( st.hits + st.misses, 4u * 4u * 64u );
+  EXPECT_LE( st.entries, 64u );
+}
+
+TEST_F( CanonizationCacheTest, set_memory_budget_concurrently )
+{
+  exact_npn_canonization_cache<static_truth_table<4>> cache;
+
+  std::vector<static_truth_table<4>> funcs( 64u );
+  for ( auto& tt : funcs )
+  {
+    create_random( tt );
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<uint32_t> errors( 3u, 0u );
+  for ( auto t = 0u; t < 3u; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      for ( auto round = 0u; round < 8u; ++round )
+      {
+        for ( const auto& tt : funcs )
+        {
+          if ( cache( tt ) != exact_npn_canonization( tt ) )
+          {
+            ++errors[t];
+          }
+        }
+      }
+    } );
+  }
+  for ( auto round = 0u; round < 16u; ++round )
+  {
+    cache.set_memory_budget( round % 2u == 0u ? 0u : UINT64_C( 1 ) << 20 );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( auto e : errors )
+  {
+    EXPECT_EQ( e, 0u );
+  }
+
+  cache.set_memory_budget( 0u );
+  EXPECT_EQ( cache.memory_budget(), 0u );
+  cache( funcs.front() );
+  EXPECT_EQ( cache.statistics().entries, 0u );
+}
@@ -25,6 +25,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <kitty/constructors.hpp>
 #include <kitty/cnf.hpp>
 #include <kitty/dynamic_truth_table.hpp>
@@ -72,4 +77,219 @@ TEST_F( CNFTest, random_cnf_static )
     create_characteristic( f_c2, f );
     EXPECT_EQ( f_c1, f_c2 );
   }
-}
\ No newline at end of file
+}
+
+namespace
+{
+
+/* assigns inputs and returns the value of the output by unit propagation,
+   or -1 in case of a conflict */
+int propagate( const clause_arena& cnf, const std::vector<int>& units, int output )
+{
+  std::vector<int> value( cnf.num_vars() + 1u, -1 );
+  for ( auto lit : units )
+  {
+    auto& v = value[std::abs( lit )];
+    if ( v == ( lit > 0 ? 0 : 1 ) )
+    {
+      return -1;
+    }
+    v = lit > 0 ? 1 : 0;
+  }
+
+  auto changed = true;
+  while ( changed )
+  {
+    changed = false;
+    auto conflict = false;
+    cnf.foreach_clause( [&]( auto begin, auto end ) {
+      auto num_free = 0u;
+      auto free_lit = 0;
+      for ( auto it = begin; it != end; ++it )
+      {
+        const auto v = value[std::abs( *it )];
+        if ( v == -1 )
+        {
+          ++num_free;
+          free_lit = *it;
+        }
+        else if ( v == ( *it > 0 ? 1 : 0 ) )
+        {
+          return; /* satisfied */
+        }
+      }
+      if ( num_free == 0u )
+      {
+        conflict = true;
+      }
+      else if ( num_free == 1u )
+      {
+        value[std::abs( free_lit )] = free_lit > 0 ? 1 : 0;
+        changed = true;
+      }
+    } );
+    if ( conflict )
+    {
+      return -1;
+    }
+  }
+
+  const auto v = value[std::abs( output )];
+  return v == -1 ? v : ( output > 0 ? v : 1 - v );
+}
+
+template<typename Encoder>
+void check_encoding( const dynamic_truth_table& tt, Encoder&& encoder )
+{
+  clause_arena cnf;
+  std::vector<int> inputs;
+  for ( auto i = 0u; i < tt.num_vars(); ++i )
+  {
+    inputs.push_back( cnf.add_variable() );
+  }
+  const auto output = encoder( tt, inputs, cnf );
+
+  for ( auto m = 0u; m < tt.num_bits(); ++m )
+  {
+    std::vector<int> units;
+    for ( auto i = 0u; i < tt.num_vars(); ++i )
+    {
+      units.push_back( ( ( m >> i ) & 1 ) ? inputs[i] : -inputs[i] );
+    }
+    EXPECT_EQ( propagate( cnf, units, output ), get_bit( tt, m ) ? 1 : 0 );
+
+    /* the complemented output value is in conflict */
+    units.push_back( get_bit( tt, m ) ? -output : output );
+    EXPECT_EQ( propagate( cnf, units, output ), -1 );
+  }
+}
+
+} // namespace
+
+TEST_F( CNFTest, clause_arena_and_dimacs_writer )
+{
+  clause_arena arena;
+  std::stringstream streamed;
+  {
+    dimacs_writer writer( streamed );
+    arena.add_variable();
+    arena.add_variable();
+    arena.add_clause( { 1, -2 } );
+    arena.add_clause( { -1 } );
+    writer.add_variable();
+    writer.add_variable();
+    writer.add_clause( { 1, -2 } );
+    const std::vector<int> clause{ -1 };
+    writer.add_clause( clause.begin(), clause.end() );
+    EXPECT_EQ( writer.num_clauses(), 2u );
+  }
+
+  EXPECT_EQ( arena.num_vars(), 2u );
+  EXPECT_EQ( arena.num_clauses(), 2u );
+  EXPECT_EQ( arena.num_literals(), 3u );
+
+  std::stringstream written;
+  arena.write_dimacs( written );
+  EXPECT_EQ( written.str(), "p cnf 2 2\n1 -2 0\n-1 0\n" );
+
+  std::string header;
+  std::getline( streamed, header );
+  EXPECT_EQ( header.substr( 0u, header.find_last_not_of( ' ' ) + 1u ), "p cnf 2 2" );
+  EXPECT_EQ( streamed.str().substr( header.size() + 1u ), "1 -2 0\n-1 0\n" );
+}
+
+TEST_F( CNFTest, dsd_encoding )
+{
+  const auto dsd = []( const auto& tt, const auto& inputs, auto& sink ) { return cnf_dsd_encoding( tt, inputs, sink ); };
+
+  /* constants and decomposable functions */
+  for ( const auto* expr : { "0", "a", "!a", "(ab)", "[ab]", "{(a!b)[cd]}", "([ab]{c(de)})", "<a[bc]{de}>" } )
+  {
+    dynamic_truth_table tt( 5u );
+    create_from_expression( tt, expr );
+    check_encoding( tt, dsd );
+  }
+
+  /* small leaves force decomposition and Shannon expansion */
+  for ( auto n = 1u; n <= 9u; ++n )
+  {
+    dynamic_truth_table tt( n );
+    create_random( tt );
+    check_encoding( tt, dsd );
+    check_encoding( tt, []( const auto& tt, const auto& inputs, auto& sink ) {
+      cnf_encoding_params ps;
+      ps.leaf_vars = 2u;
+      return cnf_dsd_encoding( tt, inputs, sink, ps );
+    } );
+  }
+
+  /* AND of XORs is encoded with one gate per operator */
+  dynamic_truth_table tt( 8u );
+  create_from_expression( tt, "([ab](!c)[de]{fgh})" );
+  clause_arena arena;
+  std::vector<int> inputs;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    inputs.push_back( arena.add_variable() );
+  }
+  cnf_encoding_params ps;
+  ps.leaf_vars = 0u;
+  cnf_dsd_encoding( tt, inputs, arena, ps );
+  EXPECT_LE( arena.num_vars(), 8u + 7u );
+}
+
+TEST_F( CNFTest, mux_encoding )
+{
+  for ( auto n = 0u; n <= 9u; ++n )
+  {
+    dynamic_truth_table tt( n );
+    create_random( tt );
+    check_encoding( tt, []( const auto& tt, const auto& inputs, auto& sink ) { return cnf_mux_encoding( tt, inputs, sink ); } );
+    check_encoding( tt, []( const auto& tt, const auto& inputs, auto& sink ) {
+      cnf_encoding_params ps;
+      ps.leaf_vars = 1u;
+      return cnf_mux_encoding( tt, inputs, sink, ps );
+    } );
+  }
+
+  /* shared cofactors: majority of 15 has a quadratic number of distinct cofactors */
+  dynamic_truth_table maj( 15u );
+  create_majority( maj );
+  clause_arena arena;
+  std::vector<int> inputs;
+  for ( auto i = 0u; i < 15u; ++i )
+  {
+    inputs.push_back( arena.add_variable() );
+  }
+  cnf_mux_encoding( maj, inputs, arena );
+  EXPECT_LT( arena.num_vars(), 15u + 15u * 15u );
+}
+
+TEST_F( CNFTest, encoding_to_dimacs )
+{
+  dynamic_truth_table tt( 12u );
+  create_random( tt );
+
+  clause_arena arena;
+  std::stringstream streamed;
+  {
+    dimacs_writer writer( streamed );
+    std::vector<int> inputs_arena, inputs_writer;
+    for ( auto i = 0u; i < 12u; ++i )
+    {
+      inputs_arena.push_back( arena.add_variable() );
+      inputs_writer.push_back( writer.add_variable() );
+    }
+    cnf_mux_encoding( tt, inputs_arena, arena );
+    cnf_mux_encoding( tt, inputs_writer, writer );
+  }
+
+  std::stringstream written;
+  arena.write_dimacs( written );
+
+  std::string header1, header2;
+  std::getline( streamed, header1 );
+  std::getline( written, header2 );
+  EXPECT_EQ( header1.substr( 0u, header1.find_last_not_of( ' ' ) + 1u ), header2 );
+  EXPECT_EQ( streamed.str().substr( header1.size() + 1u ), written.str().substr( header2.size() + 1u ) );
+}
@@ -25,6 +25,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 #include <kitty/enumeration.hpp>
 #include <kitty/npn.hpp>
 #include <kitty/static_truth_table.hpp>
@@ -55,3 +59,59 @@ TEST( EnumerationTest, small_spectral_dynamic )
                                    { return exact_spectral_canonization( tt ); } );
   ASSERT_EQ( functions.size(), 8u );
 }
+
+template<uint32_t NumVars>
+void check_npn_bitmap_enumeration( uint32_t num_threads, uint64_t expected_classes )
+{
+  npn_bitmap_enumerator<NumVars> enumerator( num_threads, 64u );
+
+  uint64_t total_size{ 0u };
+  enumerator.run( [&]( const auto& repr, uint64_t class_size ) {
+    EXPECT_EQ( repr, std::get<0>( exact_npn_canonization( repr ) ) );
+    total_size += class_size;
+  } );
+
+  EXPECT_TRUE( enumerator.finished() );
+  EXPECT_EQ( enumerator.num_classes(), expected_classes );
+  EXPECT_EQ( total_size, npn_bitmap_enumerator<NumVars>::num_functions );
+}
+
+TEST( EnumerationTest, npn_bitmap )
+{
+  check_npn_bitmap_enumeration<0>( 1u, 1u );
+  check_npn_bitmap_enumeration<1>( 1u, 2u );
+  check_npn_bitmap_enumeration<2>( 1u, 4u );
+  check_npn_bitmap_enumeration<3>( 1u, 14u );
+  check_npn_bitmap_enumeration<4>( 1u, 222u );
+  check_npn_bitmap_enumeration<4>( 4u, 222u );
+}
+
+TEST( EnumerationTest, npn_bitmap_checkpoint )
+{
+  npn_bitmap_enumerator<4> enumerator( 2u, 256u );
+
+  std::vector<static_truth_table<4>> reprs;
+  const auto collect = [&]( const auto& repr, uint64_t ) { reprs.push_back( repr ); };
+
+  EXPECT_FALSE( enumerator.run( collect, 10000u ) );
+  EXPECT_EQ( enumerator.cursor(), 10000u );
+
+  std::stringstream checkpoint;
+  EXPECT_TRUE( enumerator.save( checkpoint ) );
+
+  npn_bitmap_enumerator<4> resumed( 3u, 256u );
+  EXPECT_TRUE( resumed.load( checkpoint ) );
+  EXPECT_EQ( resumed.cursor(), 10000u );
+  EXPECT_EQ( resumed.num_classes(), reprs.size() );
+
+  EXPECT_TRUE( resumed.run( collect ) );
+  EXPECT_EQ( resumed.num_classes(), 222u );
+
+  std::sort( reprs.begin(), reprs.end() );
+  EXPECT_EQ( std::unique( reprs.begin(), reprs.end() ), reprs.end() );
+  EXPECT_EQ( reprs.size(), 222u );
+
+  std::stringstream wrong_checkpoint;
+  npn_bitmap_enumerator<3>().save( wrong_checkpoint );
+  EXPECT_FALSE( resumed.load( wrong_checkpoint ) );
+}
@@ -0,0 +1,241 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <kitty/equivalence_classes.hpp>
+#include <kitty/operators.hpp>
+#include <kitty/partial_truth_table.hpp>
+#include <kitty/pattern_store.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class EquivalenceClassesTest : public kitty::testing::Test
+{
+protected:
+  /* signals are random functions over few base patterns, such that many
+     signals are equal or complemented */
+  static std::vector<uint64_t> random_words( uint32_t num_signals, uint32_t seed )
+  {
+    std::vector<uint64_t> words( num_signals );
+    std::mt19937_64 gen( seed );
+    for ( auto s = 0u; s < num_signals; ++s )
+    {
+      words[s] = gen();
+    }
+    return words;
+  }
+
+  /* signal s is derived from base pattern (s % num_base) and complemented
+     if (s / num_base) is odd; the base patterns differ only in late bits */
+  static void add_round( pattern_store& store, uint32_t round, uint32_t num_base, uint32_t num_bits = 64u )
+  {
+    const auto base = random_words( num_base, round );
+    std::vector<uint64_t> words( store.num_signals() );
+    for ( auto s = 0u; s < words.size(); ++s )
+    {
+      /* bases i and i + 1 only differ after round i */
+      const auto b = std::min( s % num_base, round );
+      words[s] = ( ( s / num_base ) & 1 ) ? ~base[b] : base[b];
+    }
+    store.add_bits( words.data(), num_bits );
+  }
+
+  /* reference partition by full comparison */
+  static void check( const equivalence_classes& ec, const pattern_store& store, bool complement )
+  {
+    std::map<partial_truth_table, uint32_t> classes;
+    for ( auto s = 0u; s < store.num_signals(); ++s )
+    {
+      auto tt = store.to_partial_truth_table( s );
+      if ( complement && tt.num_bits() > 0u && get_bit( tt, 0 ) )
+      {
+        tt = ~tt;
+        EXPECT_TRUE( ec.phase( s ) );
+      }
+      else
+      {
+        EXPECT_FALSE( ec.phase( s ) );
+      }
+
+      const auto it = classes.find( tt );
+      if ( it == classes.end() )
+      {
+        classes.emplace( tt, ec.class_of( s ) );
+      }
+      else
+      {
+        EXPECT_EQ( ec.class_of( s ), it->second );
+      }
+    }
+    EXPECT_EQ( ec.num_classes(), classes.size() );
+
+    for ( auto c = 0u; c < ec.num_classes(); ++c )
+    {
+      const auto& m = ec.members( c );
+      EXPECT_TRUE( std::is_sorted( m.begin(), m.end() ) );
+      for ( auto s : m )
+      {
+        EXPECT_EQ( ec.class_of( s ), c );
+      }
+    }
+  }
+};
+
+TEST_F( EquivalenceClassesTest, initial_split )
+{
+  for ( auto complement : { false, true } )
+  {
+    pattern_store store( 100u );
+    add_round( store, 3u, 4u );
+
+    equivalence_classes ec( { complement, 1u } );
+    ec.refine( store );
+    check( ec, store, complement );
+    EXPECT_EQ( ec.num_classes(), complement ? 4u : 8u );
+  }
+}
+
+TEST_F( EquivalenceClassesTest, incremental_refinement )
+{
+  for ( auto complement : { false, true } )
+  {
+    pattern_store store( 200u );
+    equivalence_classes ec( { complement, 1u } );
+
+    for ( auto round = 0u; round < 10u; ++round )
+    {
+      add_round( store, round, 10u, round % 2u ? 64u : 23u );
+      ec.refine( store );
+      check( ec, store, complement );
+    }
+    EXPECT_EQ( ec.num_classes(), complement ? 10u : 20u );
+    EXPECT_EQ( ec.stats().refinements, 10u );
+
+    /* from scratch gives the same partition in the same order */
+    equivalence_classes ec2( { complement, 1u } );
+    ec2.refine( store );
+    ASSERT_EQ( ec.num_classes(), ec2.num_classes() );
+    for ( auto s = 0u; s < store.num_signals(); ++s )
+    {
+      EXPECT_EQ( ec.members( ec.class_of( s ) ), ec2.members( ec2.class_of( s ) ) );
+    }
+  }
+}
+
+TEST_F( EquivalenceClassesTest, only_new_blocks_are_hashed )
+{
+  pattern_store store( 64u );
+  equivalence_classes ec;
+
+  /* all signals equal */
+  std::vector<uint64_t> words( 64u, 0u );
+  store.add_bits( words.data() );
+  ec.refine( store );
+  EXPECT_EQ( ec.num_classes(), 1u );
+
+  const auto before = ec.stats().hashed_blocks;
+  for ( auto s = 0u; s < 64u; ++s )
+  {
+    words[s] = s < 32u ? 0u : 2u;
+  }
+  store.add_bits( words.data() );
+  ec.refine( store );
+  EXPECT_EQ( ec.num_classes(), 2u );
+  EXPECT_EQ( ec.stats().hashed_blocks - before, 64u ); /* one block per signal */
+  EXPECT_EQ( ec.stats().split_classes, 1u );
+  EXPECT_EQ( ec.stats().new_classes, 1u );
+  EXPECT_EQ( ec.members( 0u ).front(), 0u );
+  EXPECT_EQ( ec.members( 1u ).front(), 32u );
+}
+
+TEST_F( EquivalenceClassesTest, new_signals )
+{
+  pattern_store store( 50u );
+  equivalence_classes ec;
+  for ( auto round = 0u; round < 6u; ++round )
+  {
+    add_round( store, round, 5u, 40u );
+    ec.refine( store );
+    check( ec, store, true );
+
+    store.add_signal();
+    store.add_signal();
+  }
+}
+
+TEST_F( EquivalenceClassesTest, vector_of_signatures )
+{
+  std::vector<partial_truth_table> tts( 30u, partial_truth_table( 100u ) );
+  for ( auto s = 0u; s < tts.size(); ++s )
+  {
+    for ( auto i = 0u; i < 100u; ++i )
+    {
+      if ( ( ( i * ( s % 3u + 1u ) ) % 7u ) < 3u )
+      {
+        set_bit( tts[s], i );
+      }
+    }
+    if ( s % 2u )
+    {
+      tts[s] = ~tts[s];
+    }
+  }
+
+  equivalence_classes ec;
+  ec.refine( tts );
+  EXPECT_EQ( ec.num_classes(), 3u );
+  for ( auto s = 0u; s < tts.size(); ++s )
+  {
+    EXPECT_EQ( ec.class_of( s ), ec.class_of( s % 3u ) );
+    EXPECT_EQ( ec.phase( s ), get_bit( tts[s], 0 ) );
+  }
+}
+
+TEST_F( EquivalenceClassesTest, parallel )
+{
+  pattern_store store( 5000u );
+  equivalence_classes ec1( { true, 1u } ), ec4( { true, 4u } );
+  for ( auto round = 0u; round < 12u; ++round )
+  {
+    add_round( store, round, 600u );
+    ec1.refine( store );
+    ec4.refine( store );
+
+    ASSERT_EQ( ec1.num_classes(), ec4.num_classes() );
+    for ( auto c = 0u; c < ec1.num_classes(); ++c )
+    {
+      EXPECT_EQ( ec1.members( c ), ec4.members( c ) );
+    }
+  }
+  check( ec4, store, true );
+}
@@ -0,0 +1,179 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/esop.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/static_truth_table.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class EsopTest : public kitty::testing::Test
+{
+protected:
+  /* cost of optimum PKRM expansion expanding the top-most variable first */
+  uint32_t pkrm_cost( const dynamic_truth_table& tt, int var_index )
+  {
+    if ( is_const0( tt ) )
+    {
+      return 0u;
+    }
+    if ( is_const0( ~tt ) )
+    {
+      return 1u;
+    }
+    const auto tt0 = cofactor0( tt, var_index );
+    const auto tt1 = cofactor1( tt, var_index );
+    const auto ex0 = pkrm_cost( tt0, var_index - 1 );
+    const auto ex1 = pkrm_cost( tt1, var_index - 1 );
+    const auto ex2 = pkrm_cost( tt0 ^ tt1, var_index - 1 );
+    return ex0 + ex1 + ex2 - std::max( std::max( ex0, ex1 ), ex2 );
+  }
+};
+
+TEST_F( EsopTest, optimum_pkrm_small )
+{
+  for ( auto n = 0u; n <= 8u; ++n )
+  {
+    for ( auto i = 0u; i < 20u; ++i )
+    {
+      dynamic_truth_table tt( n ), tt2( n );
+      create_random( tt );
+      const auto cubes = esop_from_optimum_pkrm( tt );
+      create_from_cubes( tt2, cubes, true );
+      EXPECT_EQ( tt, tt2 );
+      EXPECT_LE( cubes.size(), pkrm_cost( tt, static_cast<int>( n ) - 1 ) );
+    }
+  }
+
+  static_truth_table<4> tt, tt2;
+  for ( auto i = 0u; i < 100u; ++i )
+  {
+    create_random( tt );
+    const auto cubes = esop_from_optimum_pkrm( tt );
+    create_from_cubes( tt2, cubes, true );
+    EXPECT_EQ( tt, tt2 );
+  }
+}
+
+TEST_F( EsopTest, optimum_pkrm_parallel )
+{
+  for ( auto n : { 8u, 10u, 12u } )
+  {
+    dynamic_truth_table tt( n ), tt2( n );
+    create_random( tt );
+
+    pkrm_params ps;
+    ps.num_threads = 4u;
+    const auto cubes = esop_from_optimum_pkrm( tt, ps );
+    create_from_cubes( tt2, cubes, true );
+    EXPECT_EQ( tt, tt2 );
+    EXPECT_EQ( cubes.size(), esop_from_optimum_pkrm( tt ).size() );
+  }
+}
+
+TEST_F( EsopTest, pprm )
+{
+  for ( auto i = 0u; i < 20u; ++i )
+  {
+    dynamic_truth_table tt( 7u ), tt2( 7u ), tt3( 7u );
+    create_random( tt );
+    create_from_cubes( tt2, esop_from_pprm( tt ), true );
+    create_from_cubes( tt3, esop_from_pprm_slow( tt ), true );
+    EXPECT_EQ( tt, tt2 );
+    EXPECT_EQ( tt, tt3 );
+    EXPECT_EQ( esop_from_pprm( tt ).size(), esop_from_pprm_slow( tt ).size() );
+  }
+}
+
+TEST_F( EsopTest, algebraic_normal_form_inplace )
+{
+  for ( auto n : { 0u, 3u, 6u, 7u, 9u, 13u, 14u } )
+  {
+    dynamic_truth_table tt( n );
+    create_random( tt );
+
+    /* reference: monomials of the PPRM by positive Davio decomposition */
+    auto expected = tt.construct();
+    for ( const auto& c : esop_from_pprm_slow( tt ) )
+    {
+      set_bit( expected, c._mask );
+    }
+
+    auto anf = tt;
+    algebraic_normal_form_inplace( anf );
+    EXPECT_EQ( anf, expected );
+
+    auto anf_parallel = tt;
+    algebraic_normal_form_inplace( anf_parallel, 3u );
+    EXPECT_EQ( anf_parallel, expected );
+
+    algebraic_normal_form_inplace( anf );
+    EXPECT_EQ( anf, tt );
+  }
+
+  /* from 19 variables on, the transform is split into several chunks of
+     4096 words, which are processed in parallel */
+  for ( auto n : { 19u, 20u } )
+  {
+    dynamic_truth_table tt( n );
+    create_random( tt );
+
+    auto anf = tt;
+    algebraic_normal_form_inplace( anf );
+
+    /* the lower half is the ANF of the negative cofactor of the top variable */
+    dynamic_truth_table lower( n - 1u );
+    std::copy( tt.cbegin(), tt.cbegin() + lower.num_blocks(), lower.begin() );
+    algebraic_normal_form_inplace( lower );
+    EXPECT_TRUE( std::equal( lower.cbegin(), lower.cend(), anf.cbegin() ) );
+
+    auto anf_parallel = tt;
+    algebraic_normal_form_inplace( anf_parallel, 3u );
+    EXPECT_EQ( anf_parallel, anf );
+
+    algebraic_normal_form_inplace( anf_parallel, 2u );
+    EXPECT_EQ( anf_parallel, tt );
+  }
+
+  for ( auto i = 0u; i < 20u; ++i )
+  {
+    static_truth_table<5> tt;
+    create_random( tt );
+    auto anf = tt;
+    algebraic_normal_form_inplace( anf );
+    EXPECT_EQ( anf, detail::algebraic_normal_form( tt ) );
+    algebraic_normal_form_inplace( anf );
+    EXPECT_EQ( anf, tt );
+  }
+}
@@ -0,0 +1,119 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kitty/bit_operations.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/espresso.hpp>
+#include <kitty/isop.hpp>
+#include <kitty/static_truth_table.hpp>
+#include <kitty/ternary_truth_table.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class EspressoTest : public kitty::testing::Test
+{
+};
+
+TEST_F( EspressoTest, completely_specified )
+{
+  static_truth_table<5> tt, tt2;
+  for ( auto i = 0; i < 100; ++i )
+  {
+    create_random( tt );
+
+    espresso_stats st;
+    const auto cubes = espresso( tt, {}, &st );
+    create_from_cubes( tt2, cubes );
+    EXPECT_EQ( tt, tt2 );
+
+    EXPECT_EQ( st.initial_cubes, isop( tt ).size() );
+    EXPECT_EQ( st.cubes, cubes.size() );
+    EXPECT_LE( st.cubes, st.initial_cubes );
+    EXPECT_TRUE( st.cubes < st.initial_cubes || st.literals <= st.initial_literals );
+  }
+}
+
+TEST_F( EspressoTest, non_minimal_isop )
+{
+  /* the ISOP of this function has 4 cubes, but 3 prime implicants suffice */
+  static_truth_table<4> tt, tt2;
+  create_from_hex_string( tt, "01ad" );
+  EXPECT_EQ( isop( tt ).size(), 4u );
+
+  const auto cubes = espresso( tt );
+  EXPECT_EQ( cubes.size(), 3u );
+  create_from_cubes( tt2, cubes );
+  EXPECT_EQ( tt, tt2 );
+}
+
+TEST_F( EspressoTest, dont_cares )
+{
+  dynamic_truth_table on( 8u ), dc( 8u ), tt( 8u );
+
+  uint64_t sum_isop{ 0u }, sum_espresso{ 0u };
+  for ( auto i = 0; i < 50; ++i )
+  {
+    create_random( on );
+    create_random( dc );
+
+    espresso_stats st;
+    const auto cubes = espresso( on, dc, {}, &st );
+    create_from_cubes( tt, cubes );
+    EXPECT_TRUE( is_const0( on & ~dc & ~tt ) );
+    EXPECT_TRUE( is_const0( tt & ~( on | dc ) ) );
+
+    std::vector<cube> initial;
+    detail::isop_rec( on & ~dc, on | dc, 8u, initial );
+    EXPECT_EQ( st.initial_cubes, initial.size() );
+    EXPECT_LE( cubes.size(), initial.size() );
+
+    sum_isop += initial.size();
+    sum_espresso += cubes.size();
+  }
+  EXPECT_LT( sum_espresso, sum_isop );
+}
+
+TEST_F( EspressoTest, ternary )
+{
+  dynamic_truth_table bits( 6u ), care( 6u ), tt( 6u );
+  for ( auto i = 0; i < 20; ++i )
+  {
+    create_random( bits );
+    create_random( care );
+    const ternary_truth_table<dynamic_truth_table> ttt( bits, care );
+
+    const auto cubes = espresso( ttt );
+    create_from_cubes( tt, cubes );
+    EXPECT_EQ( tt & care, bits & care );
+  }
+}
@@ -0,0 +1,169 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kitty/bit_operations.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/espresso.hpp>
+#include <kitty/exact_sop.hpp>
+#include <kitty/implicant.hpp>
+#include <kitty/isop.hpp>
+#include <kitty/static_truth_table.hpp>
+#include <kitty/ternary_truth_table.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class ExactSopTest : public kitty::testing::Test
+{
+protected:
+  /* minimum number of primes that cover the care onset */
+  template<typename TT>
+  uint32_t brute_force( const TT& on, const TT& dc )
+  {
+    const auto primes = get_prime_implicants_morreale( on | dc );
+    const auto care_on = on & ~dc;
+    auto best = static_cast<uint32_t>( primes.size() );
+    for ( uint64_t subset = 0u; subset < ( uint64_t( 1 ) << primes.size() ); ++subset )
+    {
+      const auto size = static_cast<uint32_t>( __builtin_popcount( static_cast<uint32_t>( subset ) ) );
+      if ( size >= best )
+      {
+        continue;
+      }
+      std::vector<cube> cubes;
+      for ( auto i = 0u; i < primes.size(); ++i )
+      {
+        if ( ( subset >> i ) & 1 )
+        {
+          cubes.push_back( primes[i] );
+        }
+      }
+      auto tt = on.construct();
+      create_from_cubes( tt, cubes );
+      if ( is_const0( care_on & ~tt ) )
+      {
+        best = size;
+      }
+    }
+    return best;
+  }
+};
+
+TEST_F( ExactSopTest, all_3_input_functions )
+{
+  static_truth_table<3> tt, tt2;
+  for ( auto f = 0u; f < 256u; ++f )
+  {
+    tt._bits = f;
+    const auto cubes = exact_sop( tt );
+    create_from_cubes( tt2, cubes );
+    EXPECT_EQ( tt, tt2 );
+    EXPECT_EQ( cubes.size(), brute_force( tt, tt.construct() ) );
+  }
+}
+
+TEST_F( ExactSopTest, random_with_dont_cares )
+{
+  static_truth_table<4> on, dc, r, tt;
+  for ( auto i = 0; i < 100; ++i )
+  {
+    create_random( on );
+    create_random( dc );
+    create_random( r );
+    dc &= r;
+
+    if ( get_prime_implicants_morreale( on | dc ).size() > 16u )
+    {
+      continue;
+    }
+
+    exact_sop_stats st;
+    const auto cubes = exact_sop( on, dc, {}, &st );
+    EXPECT_TRUE( st.optimal );
+    create_from_cubes( tt, cubes );
+    EXPECT_TRUE( is_const0( on & ~dc & ~tt ) );
+    EXPECT_TRUE( is_const0( tt & ~( on | dc ) ) );
+    EXPECT_EQ( cubes.size(), brute_force( on, dc ) );
+  }
+}
+
+TEST_F( ExactSopTest, ternary_and_espresso )
+{
+  dynamic_truth_table bits( 8u ), care( 8u ), tt( 8u );
+  for ( auto i = 0; i < 20; ++i )
+  {
+    create_random( bits );
+    create_random( care );
+    create_random( tt );
+    care |= tt; /* mostly care minterms */
+    ASSERT_FALSE( is_const0( ~care ) );
+
+    const ternary_truth_table<dynamic_truth_table> ttt( bits, care );
+    const auto cubes = exact_sop( ttt );
+    create_from_cubes( tt, cubes );
+    EXPECT_EQ( tt & care, bits & care );
+    EXPECT_LE( cubes.size(), espresso( ttt ).size() );
+    EXPECT_LE( cubes.size(), exact_sop( bits & care ).size() );
+  }
+}
+
+TEST_F( ExactSopTest, sparse_14_inputs )
+{
+  dynamic_truth_table tt( 14u ), r( 14u ), tt2( 14u );
+  create_random( tt, 1 );
+  create_random( r, 2 );
+  tt &= r;
+  create_random( r, 3 );
+  tt &= r;
+
+  exact_sop_stats st;
+  const auto cubes = exact_sop( tt, {}, &st );
+  EXPECT_TRUE( st.optimal );
+  create_from_cubes( tt2, cubes );
+  EXPECT_EQ( tt, tt2 );
+}
+
+TEST_F( ExactSopTest, dense_10_inputs_node_limit )
+{
+  dynamic_truth_table tt( 10u ), tt2( 10u );
+  create_random( tt, 4 );
+
+  exact_sop_params ps;
+  ps.max_nodes = 50u;
+  exact_sop_stats st;
+  const auto cubes = exact_sop( tt, ps, &st );
+  EXPECT_FALSE( st.optimal );
+  EXPECT_EQ( st.nodes, 50u );
+  EXPECT_LE( cubes.size(), isop( tt ).size() );
+  create_from_cubes( tt2, cubes );
+  EXPECT_EQ( tt, tt2 );
+}
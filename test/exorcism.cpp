@@ -0,0 +1,153 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/esop.hpp>
+#include <kitty/exorcism.hpp>
+#include <kitty/static_truth_table.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class ExorcismTest : public kitty::testing::Test
+{
+};
+
+TEST_F( ExorcismTest, random_functions )
+{
+  for ( auto n = 2u; n <= 10u; ++n )
+  {
+    for ( auto i = 0u; i < 5u; ++i )
+    {
+      dynamic_truth_table tt( n ), tt2( n );
+      create_random( tt );
+
+      exorcism_stats st;
+      const auto cubes = exorcism( tt, {}, &st );
+      create_from_cubes( tt2, cubes, true );
+      EXPECT_EQ( tt, tt2 );
+      EXPECT_EQ( st.cubes, cubes.size() );
+      EXPECT_LE( cubes.size(), esop_from_optimum_pkrm( tt ).size() );
+    }
+  }
+}
+
+TEST_F( ExorcismTest, from_pprm )
+{
+  /* the PPRM of the majority function is x0 x1 ^ x0 x2 ^ x1 x2 */
+  static_truth_table<3> maj, tt;
+  create_majority( maj );
+
+  exorcism_stats st;
+  const auto cubes = exorcism( esop_from_pprm( maj ), 3u, {}, &st );
+  create_from_cubes( tt, cubes, true );
+  EXPECT_EQ( maj, tt );
+  EXPECT_EQ( st.initial_cubes, 3u );
+  EXPECT_LE( cubes.size(), 3u );
+
+  /* PPRM of a 6-input parity of products is improved */
+  static_truth_table<6> f, f2;
+  create_from_expression( f, "[(abc)(def)]" );
+  const auto pprm = esop_from_pprm( f );
+  const auto cubes2 = exorcism( pprm, 6u );
+  create_from_cubes( f2, cubes2, true );
+  EXPECT_EQ( f, f2 );
+  EXPECT_LE( cubes2.size(), pprm.size() );
+}
+
+TEST_F( ExorcismTest, known_minimum )
+{
+  /* the PPRM of an n-input OR has 2^n - 1 cubes, its minimum ESOP is 1 ^ !x0 ... !x(n-1) */
+  static_truth_table<4> f, f2;
+  create_from_expression( f, "{abcd}" );
+  const auto pprm = esop_from_pprm( f );
+  EXPECT_EQ( pprm.size(), 15u );
+
+  exorcism_stats st;
+  const auto cubes = exorcism( pprm, 4u, {}, &st );
+  create_from_cubes( f2, cubes, true );
+  EXPECT_EQ( f, f2 );
+  EXPECT_EQ( cubes.size(), 2u );
+  EXPECT_EQ( st.cubes, 2u );
+
+  /* the initial cover is merged to 4 cubes, which EXORLINK improves further */
+  EXPECT_EQ( st.initial_cubes, 4u );
+
+  /* x0 x1 ^ x0 !x1 = x0, and equal cubes cancel */
+  EXPECT_EQ( exorcism( std::vector<cube>{ cube( 0b11, 0b11 ), cube( 0b01, 0b11 ) }, 2u ), std::vector<cube>{ cube( 0b01, 0b01 ) } );
+  EXPECT_TRUE( exorcism( std::vector<cube>{ cube( 0b11, 0b11 ), cube( 0b11, 0b11 ) }, 2u ).empty() );
+}
+
+TEST_F( ExorcismTest, multi_output )
+{
+  std::vector<dynamic_truth_table> functions( 4u, dynamic_truth_table( 7u ) );
+  for ( auto& f : functions )
+  {
+    create_random( f );
+  }
+
+  exorcism_stats st;
+  const auto cubes = exorcism( functions, {}, &st );
+  EXPECT_LE( st.cubes, st.initial_cubes );
+
+  for ( auto i = 0u; i < functions.size(); ++i )
+  {
+    std::vector<cube> output_cubes;
+    for ( const auto& [c, outputs] : cubes )
+    {
+      if ( ( outputs >> i ) & 1 )
+      {
+        output_cubes.push_back( c );
+      }
+    }
+    dynamic_truth_table tt( 7u );
+    create_from_cubes( tt, output_cubes, true );
+    EXPECT_EQ( functions[i], tt );
+  }
+}
+
+TEST_F( ExorcismTest, cost_function_and_time_budget )
+{
+  dynamic_truth_table tt( 10u ), tt2( 10u );
+  create_random( tt );
+
+  exorcism_params ps;
+  ps.cost = []( uint64_t cubes, uint64_t literals ) { return cubes + literals; };
+  ps.time_budget = 0.05;
+
+  exorcism_stats st;
+  const auto cubes = exorcism( tt, ps, &st );
+  create_from_cubes( tt2, cubes, true );
+  EXPECT_EQ( tt, tt2 );
+  EXPECT_LE( st.cubes + st.literals, st.initial_cubes + st.initial_literals );
+  EXPECT_LT( st.time, 1.0 );
+}
@@ -26,12 +26,17 @@
 #include <cstdlib>
 #include <limits>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <kitty/dynamic_truth_table.hpp>
 #include <kitty/hash.hpp>
+#include <kitty/partial_truth_table.hpp>
+#include <kitty/quaternary_truth_table.hpp>
 #include <kitty/static_truth_table.hpp>
+#include <kitty/ternary_truth_table.hpp>
 
 #include "utility.hpp"
 
@@ -73,3 +78,106 @@ TEST_F( HashTest, hash_dynamic )
 
   EXPECT_LE( counts.size(), 10u );
 }
+
+TEST_F( HashTest, hash_words )
+{
+  std::vector<uint64_t> words( 40u, 0u );
+
+  /* hash values of all prefixes and of all single-bit changes are distinct */
+  std::unordered_set<uint64_t> values;
+  for ( auto n = 0u; n <= words.size(); ++n )
+  {
+    values.insert( hash_words( words.data(), n ) );
+  }
+  for ( auto i = 0u; i < words.size() * 64u; ++i )
+  {
+    words[i / 64u] ^= uint64_t( 1 ) << ( i % 64u );
+    values.insert( hash_words( words.data(), words.size() ) );
+    words[i / 64u] ^= uint64_t( 1 ) << ( i % 64u );
+  }
+  EXPECT_EQ( values.size(), words.size() + 1u + words.size() * 64u );
+
+  EXPECT_EQ( hash_words( words.data(), words.size(), 5u ), hash_words( words.data(), words.size(), 5u ) );
+  EXPECT_NE( hash_words( words.data(), words.size(), 5u ), hash_words( words.data(), words.size(), 6u ) );
+}
+
+TEST_F( HashTest, seed )
+{
+  static_truth_table<3> tt3;
+  static_truth_table<8> tt8;
+  dynamic_truth_table tt( 8u );
+  create_random( tt3 );
+  create_random( tt8 );
+  create_random( tt );
+
+  EXPECT_EQ( hash<static_truth_table<3>>()( tt3 ), hash<static_truth_table<3>>( 0u )( tt3 ) );
+  EXPECT_NE( hash<static_truth_table<3>>( 1u )( tt3 ), hash<static_truth_table<3>>( 2u )( tt3 ) );
+  EXPECT_NE( hash<static_truth_table<8>>( 1u )( tt8 ), hash<static_truth_table<8>>( 2u )( tt8 ) );
+  EXPECT_NE( hash<dynamic_truth_table>( 1u )( tt ), hash<dynamic_truth_table>( 2u )( tt ) );
+}
+
+TEST_F( HashTest, distribution_of_sparse_functions )
+{
+  /* minterm functions differ in a single bit; their hash values should
+     spread evenly over the buckets of an open-addressing table */
+  std::vector<uint32_t> buckets( 1024u, 0u );
+  for ( auto i = 0u; i < 1024u; ++i )
+  {
+    dynamic_truth_table tt( 10u );
+    set_bit( tt, i );
+    ++buckets[hash<dynamic_truth_table>()( tt ) & 1023u];
+  }
+
+  uint32_t max_load = 0u;
+  for ( auto b : buckets )
+  {
+    max_load = std::max( max_load, b );
+  }
+  EXPECT_LE( max_load, 8u );
+}
+
+TEST_F( HashTest, hash_partial )
+{
+  std::unordered_set<partial_truth_table, hash<partial_truth_table>> funcs;
+
+  /* constant 0 functions of different lengths are different */
+  for ( auto bits = 0u; bits < 130u; ++bits )
+  {
+    funcs.insert( partial_truth_table( bits ) );
+    funcs.insert( partial_truth_table( bits ) );
+  }
+  EXPECT_EQ( funcs.size(), 130u );
+
+  std::unordered_set<std::size_t> values;
+  for ( const auto& tt : funcs )
+  {
+    values.insert( hash<partial_truth_table>()( tt ) );
+  }
+  EXPECT_EQ( values.size(), 130u );
+
+  /* seed and length are not interchangeable */
+  EXPECT_NE( hash<partial_truth_table>( 1u )( partial_truth_table( 10u ) ), hash<partial_truth_table>( 0u )( partial_truth_table( 11u ) ) );
+}
+
+TEST_F( HashTest, hash_ternary_and_quaternary )
+{
+  dynamic_truth_table bits( 7u ), care( 7u );
+  create_random( bits );
+  create_random( care );
+
+  const ternary_truth_table<dynamic_truth_table> tt( bits, care );
+  const ternary_truth_table<dynamic_truth_table> tt2( bits, ~care );
+  EXPECT_EQ( hash<ternary_truth_table<dynamic_truth_table>>()( tt ), hash<ternary_truth_table<dynamic_truth_table>>()( ternary_truth_table<dynamic_truth_table>( bits, care ) ) );
+  EXPECT_NE( hash<ternary_truth_table<dynamic_truth_table>>()( tt ), hash<ternary_truth_table<dynamic_truth_table>>()( tt2 ) );
+
+  const quaternary_truth_table<dynamic_truth_table> qt( bits & care, ~bits & care );
+  const quaternary_truth_table<dynamic_truth_table> qt2( ~bits & care, bits & care );
+  EXPECT_EQ( hash<quaternary_truth_table<dynamic_truth_table>>()( qt ), hash<quaternary_truth_table<dynamic_truth_table>>()( quaternary_truth_table<dynamic_truth_table>( bits & care, ~bits & care ) ) );
+  EXPECT_NE( hash<quaternary_truth_table<dynamic_truth_table>>()( qt ), hash<quaternary_truth_table<dynamic_truth_table>>()( qt2 ) );
+
+  static_truth_table<4> sbits, scare;
+  create_random( sbits );
+  create_random( scare );
+  const ternary_truth_table<static_truth_table<4>> st( sbits, scare );
+  EXPECT_NE( hash<ternary_truth_table<static_truth_table<4>>>()( st ), hash<ternary_truth_table<static_truth_table<4>>>()( ternary_truth_table<static_truth_table<4>>( scare, sbits ) ) );
+}
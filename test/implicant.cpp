@@ -90,3 +90,33 @@ TEST_F( ImplicantTest, prime_implicants_morreale )
     }
   }
 }
+
+TEST_F( ImplicantTest, prime_implicants_blake )
+{
+  for ( auto n = 0u; n < 11u; ++n )
+  {
+    for ( auto i = 0u; i < 10u; ++i )
+    {
+      dynamic_truth_table func( n );
+      create_random( func );
+      if ( i == 0u )
+      {
+        create_majority( func );
+      }
+      const auto cubes = get_prime_implicants_blake( func );
+
+      auto expected = get_prime_implicants_morreale( func );
+      std::sort( expected.begin(), expected.end() );
+      EXPECT_EQ( cubes, expected );
+    }
+  }
+
+  for ( auto i = 0u; i < 100u; ++i )
+  {
+    static_truth_table<4> func;
+    create_random( func );
+    auto expected = get_prime_implicants_morreale( func );
+    std::sort( expected.begin(), expected.end() );
+    EXPECT_EQ( get_prime_implicants_blake( func ), expected );
+  }
+}
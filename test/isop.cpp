@@ -23,12 +23,15 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <atomic>
 #include <cstdint>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
 #include <kitty/isop.hpp>
 #include <kitty/static_truth_table.hpp>
 
@@ -69,3 +72,222 @@ TEST_F( IsopTest, random_isop )
     EXPECT_EQ( tt, tt_copy );
   }
 }
+
+TEST_F( IsopTest, isop_small_static_matches_generic )
+{
+  static_truth_table<5> tt;
+
+  for ( auto i = 0; i < 1000; ++i )
+  {
+    create_random( tt );
+    std::vector<cube> cubes;
+    detail::isop_rec( tt, tt, tt.num_vars(), cubes );
+    EXPECT_EQ( isop( tt ), cubes );
+  }
+
+  EXPECT_TRUE( isop( from_hex<0>( "0" ) ).empty() );
+  EXPECT_EQ( isop( from_hex<0>( "1" ) ).size(), 1u );
+}
+
+TEST_F( IsopTest, isop_engine )
+{
+  isop_engine engine;
+  std::vector<cube> cubes;
+
+  for ( auto num_vars = 0u; num_vars <= 12u; ++num_vars )
+  {
+    dynamic_truth_table tt( num_vars );
+    for ( auto i = 0; i < 20; ++i )
+    {
+      create_random( tt );
+      engine.run( tt, cubes );
+      EXPECT_EQ( cubes, isop( tt ) );
+
+      /* incompletely specified function */
+      auto dc = tt.construct();
+      create_random( dc );
+      tt &= dc;
+      engine.run( tt, dc, cubes );
+      std::vector<cube> expected;
+      detail::isop_rec( tt, dc, num_vars, expected );
+      EXPECT_EQ( cubes, expected );
+    }
+  }
+
+  /* functions with sparse support over many variables */
+  static_truth_table<14> tt;
+  tt = nth<14>( 13 ) & ( nth<14>( 2 ) | nth<14>( 7 ) );
+  engine.run( tt, cubes );
+  EXPECT_EQ( cubes, isop( tt ) );
+  auto tt_copy = tt.construct();
+  create_from_cubes( tt_copy, cubes );
+  EXPECT_EQ( tt, tt_copy );
+}
+
+TEST_F( IsopTest, isop_engine_with_cache )
+{
+  isop_cache_params ps;
+  ps.min_vars = 7u;
+  isop_cache cache( ps );
+  isop_engine engine( 12u, &cache );
+  std::vector<cube> cubes;
+
+  for ( auto num_vars = 0u; num_vars <= 12u; ++num_vars )
+  {
+    dynamic_truth_table tt( num_vars );
+    for ( auto i = 0; i < 10; ++i )
+    {
+      create_random( tt );
+      const auto expected = isop( tt );
+      engine.run( tt, cubes );
+      EXPECT_EQ( cubes, expected );
+      engine.run( tt, cubes );
+      EXPECT_EQ( cubes, expected );
+    }
+  }
+  EXPECT_GT( cache.statistics().hits, 0u );
+
+  /* different functions that share subfunctions */
+  cache.clear();
+  cache.reset_statistics();
+  dynamic_truth_table g( 10u ), h( 10u );
+  create_random( g );
+  create_random( h );
+  dynamic_truth_table ge( 12u ), he( 12u ), x( 12u ), y( 12u );
+  extend_to_inplace( ge, g );
+  extend_to_inplace( he, h );
+  create_nth_var( x, 10u );
+  create_nth_var( y, 11u );
+  const auto f1 = ( ge & x ) | ( he & ~x );
+  const auto f2 = ( f1 & y ) | ( ge & ~y );
+  engine.run( f1, cubes );
+  EXPECT_EQ( cubes, isop( f1 ) );
+  const auto misses = cache.statistics().misses;
+  engine.run( f2, cubes );
+  EXPECT_EQ( cubes, isop( f2 ) );
+  EXPECT_GT( cache.statistics().hits, 0u );
+  EXPECT_GT( cache.statistics().entries, 0u );
+  EXPECT_GT( cache.statistics().misses, misses );
+}
+
+TEST_F( IsopTest, isop_cache_shared_between_threads )
+{
+  isop_cache cache;
+
+  std::vector<dynamic_truth_table> funcs( 8u, dynamic_truth_table( 11u ) );
+  for ( auto& tt : funcs )
+  {
+    create_random( tt );
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<uint32_t> errors( 4u, 0u );
+  for ( auto t = 0u; t < 4u; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      isop_engine engine( 11u, &cache );
+      std::vector<cube> cubes;
+      for ( const auto& tt : funcs )
+      {
+        engine.run( tt, cubes );
+        if ( cubes != isop( tt ) )
+        {
+          ++errors[t];
+        }
+      }
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( auto e : errors )
+  {
+    EXPECT_EQ( e, 0u );
+  }
+  EXPECT_GT( cache.statistics().hits, 0u );
+}
+
+TEST_F( IsopTest, parallel_isop )
+{
+  parallel_isop_params ps;
+  ps.num_threads = 4u;
+  ps.min_vars = 8u;
+
+  for ( auto num_vars = 0u; num_vars <= 14u; num_vars += 2u )
+  {
+    dynamic_truth_table tt( num_vars );
+    for ( auto i = 0; i < 3; ++i )
+    {
+      create_random( tt );
+      EXPECT_EQ( parallel_isop( tt, ps ), isop( tt ) );
+
+      auto dc = tt.construct();
+      create_random( dc );
+      tt &= dc;
+      std::vector<cube> expected;
+      detail::isop_rec( tt, dc, num_vars, expected );
+      EXPECT_EQ( parallel_isop( tt, dc, ps ), expected );
+    }
+  }
+
+  /* larger function with default parameters */
+  dynamic_truth_table tt( 18u );
+  create_random( tt );
+  std::vector<cube> expected;
+  isop_engine( 18u ).run( tt, expected );
+  EXPECT_EQ( parallel_isop( tt ), expected );
+}
+
+TEST_F( IsopTest, nested_work_stealing_pool )
+{
+  detail::work_stealing_pool outer( 3u );
+  detail::task_group group;
+  std::atomic<uint32_t> errors{ 0u };
+
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    outer.submit( group, [&]() {
+      const auto index = outer.worker_index();
+      {
+        /* a pool created and destroyed inside a task of the outer pool */
+        detail::work_stealing_pool inner( 2u );
+        detail::task_group inner_group;
+        inner.submit( inner_group, []() {} );
+        inner.wait( inner_group );
+        if ( inner.worker_index() != 0u )
+        {
+          ++errors;
+        }
+      }
+      if ( outer.worker_index() != index )
+      {
+        ++errors;
+      }
+    } );
+  }
+  outer.wait( group );
+
+  EXPECT_EQ( errors.load(), 0u );
+  EXPECT_EQ( outer.worker_index(), 0u );
+
+  /* parallel ISOP inside tasks of another pool */
+  dynamic_truth_table tt( 10u );
+  create_random( tt );
+  const auto expected = isop( tt );
+  parallel_isop_params ps;
+  ps.num_threads = 2u;
+  ps.min_vars = 6u;
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    outer.submit( group, [&]() {
+      if ( parallel_isop( tt, ps ) != expected )
+      {
+        ++errors;
+      }
+    } );
+  }
+  outer.wait( group );
+  EXPECT_EQ( errors.load(), 0u );
+}
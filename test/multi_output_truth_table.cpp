@@ -0,0 +1,294 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <kitty/bit_operations.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/multi_output_truth_table.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/partial_truth_table.hpp>
+#include <kitty/static_truth_table.hpp>
+#include <kitty/detail/transpose.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class MultiOutputTruthTableTest : public kitty::testing::Test
+{
+};
+
+TEST_F( MultiOutputTruthTableTest, transpose64 )
+{
+  std::mt19937_64 gen( 1 );
+  std::vector<uint64_t> a( 64u ), b;
+  std::generate( a.begin(), a.end(), std::ref( gen ) );
+  b = a;
+  detail::transpose64( b.data() );
+  for ( auto i = 0u; i < 64u; ++i )
+  {
+    for ( auto j = 0u; j < 64u; ++j )
+    {
+      EXPECT_EQ( ( a[i] >> j ) & 1, ( b[j] >> i ) & 1 );
+    }
+  }
+  detail::transpose64( b.data() );
+  EXPECT_EQ( a, b );
+}
+
+TEST_F( MultiOutputTruthTableTest, minterm_major_round_trip )
+{
+  for ( auto num_vars : { 0u, 3u, 6u, 7u, 10u } )
+  {
+    for ( auto num_outputs : { 1u, 5u, 64u, 65u, 130u } )
+    {
+      std::vector<dynamic_truth_table> tts( num_outputs, dynamic_truth_table( num_vars ) );
+      for ( auto k = 0u; k < num_outputs; ++k )
+      {
+        create_random( tts[k], num_vars * 1000u + k );
+      }
+
+      const auto words = to_minterm_major( tts );
+      const auto w = ( num_outputs + 63u ) / 64u;
+      ASSERT_EQ( words.size(), w << num_vars );
+      for ( auto m = 0u; m < ( 1u << num_vars ); ++m )
+      {
+        for ( auto k = 0u; k < num_outputs; ++k )
+        {
+          EXPECT_EQ( ( words[m * w + k / 64u] >> ( k % 64u ) ) & 1, get_bit( tts[k], m ) );
+        }
+        if ( num_outputs % 64u )
+        {
+          EXPECT_EQ( words[m * w + w - 1u] >> ( num_outputs % 64u ), 0u );
+        }
+      }
+
+      std::vector<dynamic_truth_table> back( num_outputs, dynamic_truth_table( num_vars ) );
+      create_from_minterm_major( back, words.data() );
+      EXPECT_EQ( back, tts );
+    }
+  }
+}
+
+TEST_F( MultiOutputTruthTableTest, partial_truth_tables )
+{
+  std::vector<partial_truth_table> tts( 70u, partial_truth_table( 150u ) );
+  for ( auto k = 0u; k < tts.size(); ++k )
+  {
+    create_random( tts[k], k );
+  }
+
+  const auto words = to_minterm_major( tts );
+  ASSERT_EQ( words.size(), 300u );
+  for ( auto m = 0u; m < 150u; ++m )
+  {
+    for ( auto k = 0u; k < tts.size(); ++k )
+    {
+      EXPECT_EQ( ( words[m * 2u + k / 64u] >> ( k % 64u ) ) & 1, get_bit( tts[k], m ) );
+    }
+  }
+
+  std::vector<partial_truth_table> back( 70u, partial_truth_table( 150u ) );
+  create_from_minterm_major( back, words.data() );
+  EXPECT_EQ( back, tts );
+}
+
+TEST_F( MultiOutputTruthTableTest, construct_and_access )
+{
+  /* outputs are the 4 bits of the input plus one */
+  std::vector<static_truth_table<4>> tts( 4u );
+  for ( auto m = 0u; m < 16u; ++m )
+  {
+    for ( auto k = 0u; k < 4u; ++k )
+    {
+      if ( ( ( ( m + 1u ) % 16u ) >> k ) & 1 )
+      {
+        set_bit( tts[k], m );
+      }
+    }
+  }
+
+  multi_output_truth_table mo( tts );
+  EXPECT_EQ( mo.num_vars(), 4u );
+  EXPECT_EQ( mo.num_outputs(), 4u );
+  EXPECT_EQ( mo.num_minterms(), 16u );
+  EXPECT_EQ( mo.words_per_minterm(), 1u );
+  for ( auto m = 0u; m < 16u; ++m )
+  {
+    EXPECT_EQ( *mo.minterm( m ), ( m + 1u ) % 16u );
+  }
+  EXPECT_EQ( mo.outputs<static_truth_table<4>>(), tts );
+  EXPECT_EQ( mo.output<static_truth_table<4>>( 2u ), tts[2] );
+  EXPECT_EQ( mo.output( 3u ), from_hex( 4u, "7f80" ) );
+
+  multi_output_truth_table mo2( 4u, 4u );
+  for ( auto m = 0u; m < 16u; ++m )
+  {
+    for ( auto k = 0u; k < 4u; ++k )
+    {
+      if ( mo.get_bit( m, k ) )
+      {
+        mo2.set_bit( m, k );
+      }
+    }
+  }
+  EXPECT_EQ( mo, mo2 );
+  mo2.clear_bit( 0u, 0u );
+  EXPECT_NE( mo, mo2 );
+}
+
+TEST_F( MultiOutputTruthTableTest, bulk_operations )
+{
+  for ( auto num_vars : { 3u, 6u, 8u } )
+  {
+    std::vector<dynamic_truth_table> tts( 70u, dynamic_truth_table( num_vars ) );
+    for ( auto k = 0u; k < tts.size(); ++k )
+    {
+      create_random( tts[k], k );
+    }
+    const multi_output_truth_table mo( tts );
+
+    const auto check = [&]( auto&& mo_op, auto&& tt_op ) {
+      auto copy = mo;
+      mo_op( copy );
+      auto expected = tts;
+      for ( auto& tt : expected )
+      {
+        tt_op( tt );
+      }
+      EXPECT_EQ( copy.outputs(), expected );
+    };
+
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      check( [&]( auto& t ) { flip_inplace( t, i ); }, [&]( auto& t ) { flip_inplace( t, i ); } );
+      check( [&]( auto& t ) { cofactor0_inplace( t, i ); }, [&]( auto& t ) { cofactor0_inplace( t, i ); } );
+      check( [&]( auto& t ) { cofactor1_inplace( t, i ); }, [&]( auto& t ) { cofactor1_inplace( t, i ); } );
+      for ( auto j = 0u; j < num_vars; ++j )
+      {
+        check( [&]( auto& t ) { swap_inplace( t, i, j ); }, [&]( auto& t ) { swap_inplace( t, i, j ); } );
+      }
+    }
+
+    const auto extended = extend_to( mo, num_vars + 2u );
+    EXPECT_EQ( extended.num_vars(), num_vars + 2u );
+    for ( auto k = 0u; k < tts.size(); ++k )
+    {
+      EXPECT_EQ( extended.output( k ), extend_to( tts[k], num_vars + 2u ) );
+    }
+  }
+}
+
+TEST_F( MultiOutputTruthTableTest, canonization_single_output )
+{
+  for ( auto num_vars = 0u; num_vars <= 6u; ++num_vars )
+  {
+    for ( auto k = 0u; k < 20u; ++k )
+    {
+      dynamic_truth_table tt( num_vars );
+      create_random( tt, k );
+      const multi_output_truth_table mo( std::vector<dynamic_truth_table>{ tt } );
+
+      const auto [p_tt, p_phase, p_perm] = exact_p_canonization( tt );
+      const auto [p_mo, p_mo_phase, p_mo_perm] = exact_p_canonization( mo );
+      EXPECT_EQ( p_mo.output( 0u ), p_tt );
+      EXPECT_EQ( p_mo_phase, p_phase );
+      EXPECT_EQ( p_mo_perm, p_perm );
+
+      const auto [n_tt, n_phase, n_perm] = exact_npn_canonization( tt );
+      const auto [n_mo, n_mo_phase, n_mo_perm, n_mo_out] = exact_npn_canonization( mo );
+      EXPECT_EQ( n_mo.output( 0u ), n_tt );
+      EXPECT_EQ( n_mo_phase, n_phase & ~( 1u << num_vars ) );
+      EXPECT_EQ( n_mo_perm, n_perm );
+      EXPECT_EQ( n_mo_out[0u], ( n_phase >> num_vars ) & 1 );
+    }
+  }
+}
+
+TEST_F( MultiOutputTruthTableTest, canonization_invariance )
+{
+  std::mt19937 gen( 7 );
+  for ( auto num_vars : { 3u, 4u, 5u } )
+  {
+    std::vector<dynamic_truth_table> tts( 8u, dynamic_truth_table( num_vars ) );
+    for ( auto k = 0u; k < tts.size(); ++k )
+    {
+      create_random( tts[k], num_vars + k );
+    }
+    const multi_output_truth_table mo( tts );
+    const auto p_repr = std::get<0>( exact_p_canonization( mo ) );
+    const auto npn_repr = std::get<0>( exact_npn_canonization( mo ) );
+    EXPECT_FALSE( mo < p_repr );
+
+    for ( auto r = 0u; r < 10u; ++r )
+    {
+      auto p = mo;
+      for ( auto i = 0u; i < 5u; ++i )
+      {
+        swap_inplace( p, gen() % num_vars, gen() % num_vars );
+      }
+      EXPECT_EQ( std::get<0>( exact_p_canonization( p ) ), p_repr );
+
+      auto npn = p;
+      flip_inplace( npn, gen() % num_vars );
+      for ( auto m = 0u; m < npn.num_minterms(); ++m )
+      {
+        *npn.minterm( m ) ^= 0x5a; /* negate some outputs */
+      }
+      EXPECT_EQ( std::get<0>( exact_npn_canonization( npn ) ), npn_repr );
+    }
+  }
+}
+
+TEST_F( MultiOutputTruthTableTest, hash )
+{
+  std::unordered_set<multi_output_truth_table, hash<multi_output_truth_table>> set;
+  for ( auto num_vars = 0u; num_vars < 4u; ++num_vars )
+  {
+    for ( auto num_outputs = 1u; num_outputs < 4u; ++num_outputs )
+    {
+      set.insert( multi_output_truth_table( num_vars, num_outputs ) );
+      set.insert( multi_output_truth_table( num_vars, num_outputs ) );
+    }
+  }
+  EXPECT_EQ( set.size(), 12u );
+
+  multi_output_truth_table a( 3u, 100u ), b( 3u, 100u );
+  a.set_bit( 5u, 99u );
+  EXPECT_NE( hash<multi_output_truth_table>()( a ), hash<multi_output_truth_table>()( b ) );
+  b.set_bit( 5u, 99u );
+  EXPECT_EQ( hash<multi_output_truth_table>()( a ), hash<multi_output_truth_table>()( b ) );
+
+  /* seed and shape are not interchangeable */
+  EXPECT_NE( hash<multi_output_truth_table>( 1u )( multi_output_truth_table( 2u, 3u ) ), hash<multi_output_truth_table>( 0u )( multi_output_truth_table( 2u, 4u ) ) );
+}
@@ -25,13 +25,21 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <numeric>
+#include <random>
 #include <string>
 #include <vector>
 
 #include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/enumeration.hpp>
 #include <kitty/npn.hpp>
+#include <kitty/operations.hpp>
 #include <kitty/static_truth_table.hpp>
+#include <kitty/ternary_truth_table.hpp>
 
 #include "utility.hpp"
 
@@ -101,6 +109,51 @@ TEST_F( NPNTest, random_functions_sifting )
   }
 }
 
+TEST_F( NPNTest, random_functions_multi_start_sifting )
+{
+  kitty::static_truth_table<8> tt;
+
+  multi_start_sifting_params ps;
+  ps.num_restarts = 8u;
+
+  for ( auto i = 0; i < 100; ++i )
+  {
+    create_random( tt );
+    multi_start_sifting_stats st;
+    const auto res = multi_start_sifting_npn_canonization( tt, ps, &st );
+    EXPECT_EQ( create_from_npn_config( res ), tt );
+    EXPECT_FALSE( std::get<0>( sifting_npn_canonization( tt ) ) < std::get<0>( res ) );
+    EXPECT_EQ( st.restarts, 9u );
+  }
+}
+
+TEST_F( NPNTest, multi_start_sifting_threads_and_budget )
+{
+  kitty::dynamic_truth_table tt( 9u );
+
+  multi_start_sifting_params ps;
+  ps.num_restarts = 12u;
+
+  for ( auto i = 0; i < 10; ++i )
+  {
+    create_random( tt );
+    ps.num_threads = 1u;
+    const auto res1 = multi_start_sifting_npn_canonization( tt, ps );
+    ps.num_threads = 3u;
+    const auto res3 = multi_start_sifting_npn_canonization( tt, ps );
+    EXPECT_EQ( res1, res3 );
+    EXPECT_EQ( create_from_npn_config( res3 ), tt );
+  }
+
+  ps.num_restarts = 1000000u;
+  ps.time_budget = std::chrono::microseconds( 1000 );
+  multi_start_sifting_stats st;
+  const auto res = multi_start_sifting_npn_canonization( tt, ps, &st );
+  EXPECT_EQ( create_from_npn_config( res ), tt );
+  EXPECT_GE( st.restarts, 1u );
+  EXPECT_LT( st.restarts, 1000001u );
+}
+
 TEST_F( NPNTest, random_functions_exact_p )
 {
   kitty::static_truth_table<6> tt;
@@ -195,3 +248,139 @@ TEST_F( NPNTest, random_functions_exact_n_enumeration )
       EXPECT_EQ( create_from_npn_config( res ), tt ); } );
   }
 }
+
+TEST_F( NPNTest, npn_match_exact )
+{
+  kitty::static_truth_table<4> f, g;
+
+  for ( auto i = 0; i < 2000; ++i )
+  {
+    create_random( f );
+    create_random( g );
+    g._bits &= f._bits | ( i % 3 == 0 ? 0xffff : 0x0ff0 );
+
+    const auto match = npn_match( f, g );
+    EXPECT_EQ( match.has_value(), std::get<0>( exact_npn_canonization( f ) ) == std::get<0>( exact_npn_canonization( g ) ) );
+    if ( match )
+    {
+      EXPECT_EQ( std::get<0>( *match ), f );
+      EXPECT_EQ( create_from_npn_config( *match ), g );
+    }
+  }
+
+  /* functions in the same class */
+  for ( auto i = 0; i < 200; ++i )
+  {
+    create_random( f );
+    exact_npn_canonization( f, [&]( const auto& g ) {
+      const auto match = npn_match( f, g );
+      ASSERT_TRUE( match.has_value() );
+      EXPECT_EQ( create_from_npn_config( *match ), g );
+    } );
+  }
+}
+
+TEST_F( NPNTest, npn_match_large )
+{
+  kitty::dynamic_truth_table f( 10u );
+
+  for ( auto i = 0; i < 50; ++i )
+  {
+    create_random( f );
+
+    std::vector<uint8_t> perm( f.num_vars() );
+    std::iota( perm.begin(), perm.end(), 0u );
+    std::shuffle( perm.begin(), perm.end(), std::default_random_engine( i ) );
+    const auto g = create_from_npn_config( std::make_tuple( f, static_cast<uint32_t>( i * 37 ), perm ) );
+
+    const auto match = npn_match( f, g );
+    ASSERT_TRUE( match.has_value() );
+    EXPECT_EQ( create_from_npn_config( *match ), g );
+
+    auto h = g;
+    flip_bit( h, i );
+    EXPECT_FALSE( npn_match( f, h ).has_value() );
+  }
+
+  EXPECT_TRUE( npn_match( from_hex<0>( "0" ), from_hex<0>( "1" ) ).has_value() );
+  EXPECT_TRUE( npn_match( from_hex<1>( "1" ), from_hex<1>( "2" ) ).has_value() );
+  EXPECT_FALSE( npn_match( from_hex<1>( "1" ), from_hex<1>( "3" ) ).has_value() );
+}
+
+TEST_F( NPNTest, exact_np_canonization )
+{
+  kitty::static_truth_table<5> tt;
+
+  for ( auto i = 0; i < 100; ++i )
+  {
+    create_random( tt );
+    const auto res = exact_np_canonization( tt );
+    EXPECT_EQ( create_from_npn_config( res ), tt );
+    EXPECT_EQ( std::get<1>( res ) >> 5, 0u );
+    EXPECT_FALSE( std::get<0>( exact_npn_canonization( tt ) ) != std::min( std::get<0>( res ), std::get<0>( exact_np_canonization( ~tt ) ) ) );
+  }
+}
+
+TEST_F( NPNTest, ternary_canonization )
+{
+  using ternary_t = ternary_truth_table<static_truth_table<4>>;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    static_truth_table<4> bits, care;
+    create_random( bits );
+    create_random( care );
+    const ternary_t tt( bits & care, care );
+
+    const auto res = exact_npn_canonization( tt );
+    EXPECT_EQ( create_from_npn_config( res ), tt );
+
+    const auto res_np = exact_np_canonization( tt );
+    EXPECT_EQ( create_from_npn_config( res_np ), tt );
+
+    /* all members of the class have the same representative */
+    exact_npn_canonization( tt, [&]( const auto& member ) {
+      EXPECT_EQ( std::get<0>( exact_npn_canonization( member ) ), std::get<0>( res ) );
+    } );
+
+    /* heuristics return valid configurations that are not better than the exact one */
+    for ( const auto& heuristic : { sifting_npn_canonization( tt ), multi_start_sifting_npn_canonization( tt ) } )
+    {
+      EXPECT_EQ( create_from_npn_config( heuristic ), tt );
+      EXPECT_FALSE( detail::npn_less( std::get<0>( heuristic ), std::get<0>( res ) ) );
+    }
+    EXPECT_EQ( create_from_npn_config( sifting_np_canonization( tt ) ), tt );
+  }
+
+  /* single variable with one don't care */
+  const ternary_truth_table<dynamic_truth_table> single( from_hex( 1u, "1" ), from_hex( 1u, "1" ) );
+  const auto res = exact_npn_canonization( single );
+  EXPECT_EQ( std::get<0>( res )._care, from_hex( 1u, "1" ) );
+  EXPECT_EQ( std::get<0>( res )._bits, from_hex( 1u, "0" ) );
+  EXPECT_EQ( create_from_npn_config( res ), single );
+}
+
+TEST_F( NPNTest, ternary_npn_match )
+{
+  std::vector<static_truth_table<4>> library;
+  npn_bitmap_enumerator<4>().run( [&]( const auto& repr, uint64_t ) { library.push_back( repr ); } );
+
+  for ( auto i = 0; i < 100; ++i )
+  {
+    static_truth_table<4> func, care;
+    create_random( func );
+    create_random( care );
+    const ternary_truth_table<static_truth_table<4>> tt( func & care, care );
+
+    const auto match = find_npn_match( tt, library.begin(), library.end() );
+    ASSERT_TRUE( match.has_value() );
+    const auto impl = create_from_npn_config( match->second );
+    EXPECT_EQ( impl & care, func & care );
+
+    EXPECT_TRUE( npn_match( tt, func ).has_value() );
+  }
+
+  const ternary_truth_table<static_truth_table<4>> and4( from_hex<4>( "8000" ), from_hex<4>( "ffff" ) );
+  EXPECT_FALSE( npn_match( and4, from_hex<4>( "6996" ) ).has_value() );
+  EXPECT_TRUE( npn_match( and4, from_hex<4>( "fffe" ) ).has_value() );
+}
@@ -1481,3 +1481,121 @@ TEST_F( OperationsTest, shift_mask_for_quaternary )
   EXPECT_EQ( tttabd, quaternary_truth_table<dynamic_truth_table>( from_hex( 4, "a124" ), from_hex( 4, "55a5" ) ) );
   EXPECT_EQ( shift_with_mask( ttt, 0b1110 ), quaternary_truth_table<dynamic_truth_table>( from_hex( 4, "c142" ), from_hex( 4, "33c3" ) ) );
 }
+
+template<uint32_t NumVars>
+static void check_evaluate_batch_static( std::mt19937_64& gen )
+{
+  static_truth_table<NumVars> tt;
+  std::vector<uint64_t> inputs( NumVars );
+  for ( auto k = 0u; k < 20u; ++k )
+  {
+    create_random( tt, k );
+    if ( k == 0u )
+    {
+      tt = tt.construct(); /* constant */
+    }
+    std::generate( inputs.begin(), inputs.end(), std::ref( gen ) );
+
+    const auto result = evaluate_batch( tt, inputs.data() );
+    for ( auto p = 0u; p < 64u; ++p )
+    {
+      uint64_t index = 0u;
+      for ( auto j = 0u; j < NumVars; ++j )
+      {
+        index |= ( ( inputs[j] >> p ) & 1 ) << j;
+      }
+      EXPECT_EQ( ( result >> p ) & 1, get_bit( tt, index ) );
+    }
+  }
+}
+
+TEST_F( OperationsTest, evaluate_batch )
+{
+  std::mt19937_64 gen( 42 );
+  check_evaluate_batch_static<0>( gen );
+  check_evaluate_batch_static<1>( gen );
+  check_evaluate_batch_static<2>( gen );
+  check_evaluate_batch_static<3>( gen );
+  check_evaluate_batch_static<4>( gen );
+  check_evaluate_batch_static<5>( gen );
+  check_evaluate_batch_static<6>( gen );
+
+  for ( auto num_vars = 0u; num_vars <= 16u; ++num_vars )
+  {
+    dynamic_truth_table tt( num_vars );
+    std::vector<std::vector<uint64_t>> inputs( num_vars, std::vector<uint64_t>( 3u ) );
+    std::vector<const uint64_t*> ptrs;
+    for ( auto& in : inputs )
+    {
+      std::generate( in.begin(), in.end(), std::ref( gen ) );
+      ptrs.push_back( in.data() );
+    }
+
+    for ( auto k = 0u; k < 4u; ++k )
+    {
+      switch ( k )
+      {
+      case 0u:
+        create_random( tt, num_vars );
+        break;
+      case 1u: /* does not depend on the last variable */
+        create_random( tt, num_vars );
+        tt = cofactor0( tt, num_vars ? num_vars - 1u : 0u );
+        break;
+      case 2u:
+        tt = ~tt.construct();
+        break;
+      case 3u: /* parity */
+        tt = tt.construct();
+        for ( auto i = 0u; i < num_vars; ++i )
+        {
+          auto var = tt.construct();
+          create_nth_var( var, i );
+          tt ^= var;
+        }
+        break;
+      }
+
+      std::vector<uint64_t> output( 3u );
+      evaluate_batch( tt, ptrs.data(), output.data(), output.size() );
+      for ( auto w = 0u; w < output.size(); ++w )
+      {
+        for ( auto p = 0u; p < 64u; ++p )
+        {
+          uint64_t index = 0u;
+          for ( auto j = 0u; j < num_vars; ++j )
+          {
+            index |= ( ( inputs[j][w] >> p ) & 1 ) << j;
+          }
+          EXPECT_EQ( ( output[w] >> p ) & 1, get_bit( tt, index ) );
+        }
+      }
+    }
+  }
+}
+
+TEST_F( OperationsTest, compose_truth_table )
+{
+  EXPECT_EQ( compose_truth_table( from_hex( 2, "9" ), std::vector<dynamic_truth_table>{ from_hex( 2, "9" ), from_hex( 2, "a" ) } ), from_hex( 2, "c" ) );
+
+  for ( auto num_vars = 1u; num_vars <= 9u; ++num_vars )
+  {
+    dynamic_truth_table f( 3u );
+    create_random( f, num_vars );
+    std::vector<dynamic_truth_table> vars( 3u, dynamic_truth_table( num_vars ) );
+    for ( auto i = 0u; i < 3u; ++i )
+    {
+      create_random( vars[i], num_vars + i );
+    }
+
+    const auto composed = compose_truth_table( f, vars );
+    for ( auto b = 0u; b < composed.num_bits(); ++b )
+    {
+      EXPECT_EQ( get_bit( composed, b ), get_bit( f, get_bit( vars[0], b ) | ( get_bit( vars[1], b ) << 1 ) | ( get_bit( vars[2], b ) << 2 ) ) );
+    }
+    if ( num_vars < 6u )
+    {
+      EXPECT_EQ( *composed.cbegin() >> composed.num_bits(), 0u ); /* bits are masked */
+    }
+  }
+}
@@ -70,6 +70,18 @@ TEST( PartialTruthTableTest, add_bit )
   create_random( tt2 );
   tt1.add_bits( tt2._bits[0], 64 );
   EXPECT_EQ( to_binary( tt1 ), to_binary( tt2 ) + "011" + string_before );
+
+  /* adding to a full last block, bits above num_bits are ignored */
+  partial_truth_table tt3( 64 );
+  tt3.add_bits( 0xff, 3 );
+  EXPECT_EQ( tt3.num_blocks(), 2 );
+  EXPECT_EQ( tt3._bits[1], 0x7u );
+  tt3.add_bits( ~uint64_t( 0 ), 61 );
+  tt3.add_bits( 0x5, 64 );
+  EXPECT_EQ( tt3.num_bits(), 192 );
+  EXPECT_EQ( tt3.num_blocks(), 3 );
+  EXPECT_EQ( tt3._bits[1], ~uint64_t( 0 ) );
+  EXPECT_EQ( tt3._bits[2], 0x5u );
 }
 
 TEST( PartialTruthTableTest, hex_binary )
@@ -0,0 +1,141 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <kitty/bit_operations.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+#include <kitty/partial_truth_table.hpp>
+#include <kitty/pattern_store.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class PatternStoreTest : public kitty::testing::Test
+{
+};
+
+TEST_F( PatternStoreTest, append_and_compare )
+{
+  /* reference: one partial truth table per signal */
+  const auto num_signals = 150u; /* more than two chunks */
+  pattern_store store( num_signals );
+  std::vector<partial_truth_table> tts( num_signals );
+
+  std::vector<uint64_t> words( num_signals );
+  for ( auto round = 0u; round < 40u; ++round )
+  {
+    const auto num_bits = round % 3u == 0u ? 64u : ( round * 7u ) % 64u;
+    for ( auto s = 0u; s < num_signals; ++s )
+    {
+      words[s] = ( round + 1u ) * UINT64_C( 0x9e3779b97f4a7c15 ) * ( s + 1u );
+      tts[s].add_bits( words[s], num_bits );
+    }
+    store.add_bits( words.data(), num_bits );
+
+    EXPECT_EQ( store.num_bits(), tts[0].num_bits() );
+    EXPECT_GE( store.capacity(), store.num_blocks() );
+    EXPECT_EQ( store.capacity() % 8u, 0u );
+  }
+
+  for ( auto s = 0u; s < num_signals; ++s )
+  {
+    EXPECT_EQ( store.to_partial_truth_table( s ), tts[s] );
+
+    const auto v = store.view( s );
+    EXPECT_EQ( reinterpret_cast<uintptr_t>( &*v.begin() ) % 64u, 0u );
+    EXPECT_EQ( v.num_blocks(), tts[s].num_blocks() );
+    EXPECT_EQ( count_ones( v ), count_ones( tts[s] ) );
+    for ( auto i = 0u; i < v.num_bits(); i += 13u )
+    {
+      EXPECT_EQ( get_bit( v, i ), get_bit( tts[s], i ) );
+    }
+  }
+}
+
+TEST_F( PatternStoreTest, blocks_signals_and_resize )
+{
+  pattern_store store( 3u, 2u );
+  std::vector<partial_truth_table> tts( 3u );
+
+  /* unaligned bulk append of blocks */
+  const uint64_t first[] = { 0x5, 0x3, 0xf };
+  store.add_bits( first, 3u );
+  for ( auto s = 0u; s < 3u; ++s )
+  {
+    tts[s].add_bits( first[s], 3 );
+  }
+
+  std::vector<uint64_t> blocks( 3u * 5u );
+  for ( auto i = 0u; i < blocks.size(); ++i )
+  {
+    blocks[i] = ( i + 1u ) * UINT64_C( 0xc6a4a7935bd1e995 );
+  }
+  store.add_blocks( blocks.data(), 5u );
+  for ( auto s = 0u; s < 3u; ++s )
+  {
+    for ( auto j = 0u; j < 5u; ++j )
+    {
+      tts[s].add_bits( blocks[s * 5u + j] );
+    }
+    EXPECT_EQ( store.to_partial_truth_table( s ), tts[s] );
+  }
+
+  /* new signals are 0 and keep their bits when the capacity grows */
+  const auto s = store.add_signal();
+  EXPECT_EQ( s, 3u );
+  EXPECT_TRUE( is_const0( store.view( s ) ) );
+  auto v = store.view( s );
+  set_bit( v, 100u );
+  store.reserve( 10000u );
+  EXPECT_EQ( count_ones( store.view( s ) ), 1u );
+  EXPECT_TRUE( get_bit( store.view( s ), 100u ) );
+
+  /* resize masks and clears bits */
+  store.resize( 70u );
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    tts[i].resize( 70 );
+    EXPECT_EQ( store.to_partial_truth_table( i ), tts[i] );
+  }
+  store.resize( 200u );
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    tts[i].resize( 200 );
+    EXPECT_EQ( store.to_partial_truth_table( i ), tts[i] );
+  }
+
+  /* views write into the store */
+  store.view( 1u ).assign( ~tts[1] );
+  EXPECT_EQ( store.to_partial_truth_table( 1u ), ~tts[1] );
+  const pattern_store& cstore = store;
+  const partial_truth_table_view<const uint64_t> cv = store.view( 1u );
+  EXPECT_EQ( count_ones( cstore.view( 1u ) ), count_ones( cv ) );
+}
@@ -188,4 +188,24 @@ TEST_F( PropertiesTest, polynomial_degree )
   EXPECT_EQ( polynomial_degree( from_hex<3>( "aa" ) ), 1u );
   EXPECT_EQ( polynomial_degree( from_hex<3>( "ff" ) ), 0u );
   EXPECT_EQ( polynomial_degree( from_hex<3>( "00" ) ), 0u );
+
+  for ( auto n : { 5u, 8u, 14u } )
+  {
+    dynamic_truth_table tt( n );
+    create_majority( tt );
+
+    auto expected = 0;
+    for ( const auto& c : esop_from_pprm( tt ) )
+    {
+      expected = std::max( expected, c.num_literals() );
+    }
+    EXPECT_EQ( polynomial_degree( tt ), static_cast<uint32_t>( expected ) );
+
+    /* odd number of ones implies the largest monomial */
+    create_random( tt );
+    if ( count_ones( tt ) % 2u == 1u )
+    {
+      EXPECT_EQ( polynomial_degree( tt ), n );
+    }
+  }
 }
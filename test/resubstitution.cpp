@@ -0,0 +1,256 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <kitty/bit_operations.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operators.hpp>
+#include <kitty/partial_truth_table.hpp>
+#include <kitty/properties.hpp>
+#include <kitty/resubstitution.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class ResubstitutionTest : public kitty::testing::Test
+{
+protected:
+  /* checks that the candidate implements the target on the care set */
+  template<typename TT>
+  static void check( const TT& target, const TT& care, const std::vector<TT>& divisors, const resubstitution_candidate& res )
+  {
+    for ( auto i = 0u; i < target.num_bits(); ++i )
+    {
+      if ( !get_bit( care, i ) )
+      {
+        continue;
+      }
+      auto m = 0u;
+      for ( auto v = 0u; v < res.divisors.size(); ++v )
+      {
+        m |= get_bit( divisors[res.divisors[v]], i ) << v;
+      }
+      EXPECT_TRUE( get_bit( res.care, m ) );
+      EXPECT_EQ( get_bit( res.function, m ), get_bit( target, i ) );
+    }
+  }
+
+  /* smallest number of divisors (up to 3) by exhaustive search */
+  template<typename TT>
+  static uint32_t minimum_divisors( const TT& target, const TT& care, const std::vector<TT>& divisors )
+  {
+    const auto dependent = [&]( std::vector<uint32_t> const& ds ) {
+      std::vector<int> value( 1u << ds.size(), -1 );
+      for ( auto i = 0u; i < target.num_bits(); ++i )
+      {
+        if ( !get_bit( care, i ) )
+        {
+          continue;
+        }
+        auto m = 0u;
+        for ( auto v = 0u; v < ds.size(); ++v )
+        {
+          m |= get_bit( divisors[ds[v]], i ) << v;
+        }
+        const int b = get_bit( target, i );
+        if ( value[m] != -1 && value[m] != b )
+        {
+          return false;
+        }
+        value[m] = b;
+      }
+      return true;
+    };
+
+    const auto n = static_cast<uint32_t>( divisors.size() );
+    if ( dependent( {} ) )
+    {
+      return 0u;
+    }
+    for ( auto a = 0u; a < n; ++a )
+    {
+      if ( dependent( { a } ) )
+      {
+        return 1u;
+      }
+    }
+    for ( auto a = 0u; a < n; ++a )
+    {
+      for ( auto b = a + 1u; b < n; ++b )
+      {
+        if ( dependent( { a, b } ) )
+        {
+          return 2u;
+        }
+      }
+    }
+    for ( auto a = 0u; a < n; ++a )
+    {
+      for ( auto b = a + 1u; b < n; ++b )
+      {
+        for ( auto c = b + 1u; c < n; ++c )
+        {
+          if ( dependent( { a, b, c } ) )
+          {
+            return 3u;
+          }
+        }
+      }
+    }
+    return 4u;
+  }
+};
+
+TEST_F( ResubstitutionTest, simple_gates )
+{
+  std::vector<dynamic_truth_table> divisors( 4u, dynamic_truth_table( 4u ) );
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    create_nth_var( divisors[i], i );
+  }
+
+  const auto check_size = [&]( const dynamic_truth_table& target, uint32_t size ) {
+    const auto res = find_resubstitution( target, divisors );
+    ASSERT_TRUE( res );
+    EXPECT_EQ( res->divisors.size(), size );
+    check( target, ~target.construct(), divisors, *res );
+  };
+
+  check_size( divisors[0].construct(), 0u );
+  check_size( ~divisors[2], 1u );
+  check_size( divisors[0] & ~divisors[3], 2u );
+  check_size( ~divisors[1] | divisors[2], 2u );
+  check_size( divisors[1] ^ divisors[3], 2u );
+  check_size( divisors[0] & divisors[1] & ~divisors[2], 3u );
+  check_size( ternary_majority( divisors[0], divisors[2], divisors[3] ), 3u );
+  check_size( divisors[0] ^ divisors[1] ^ divisors[3], 3u );
+
+  const auto res = find_resubstitution( divisors[0] & divisors[1] & divisors[2] & divisors[3], divisors );
+  EXPECT_FALSE( res );
+
+  resubstitution_params ps;
+  ps.use_xor = false;
+  ps.max_divisors = 2u;
+  EXPECT_FALSE( find_resubstitution( divisors[1] ^ divisors[3], divisors, ps ) );
+}
+
+TEST_F( ResubstitutionTest, random_partial )
+{
+  std::vector<uint32_t> num_solutions( 5u, 0u );
+  for ( auto t = 0u; t < 60u; ++t )
+  {
+    const auto num_bits = 50u + 37u * t;
+    std::vector<partial_truth_table> divisors( 16u, partial_truth_table( num_bits ) );
+    for ( auto i = 0u; i < divisors.size(); ++i )
+    {
+      create_random( divisors[i], t * 16u + i );
+    }
+
+    /* target is a function of some divisors, or a random function */
+    auto target = divisors[3].construct();
+    auto care = ~target.construct();
+    create_random( care, t + 100u );
+    switch ( t % 5u )
+    {
+    case 0u:
+      target = ( divisors[3] & ~divisors[9] ) | divisors[12];
+      break;
+    case 1u:
+      target = ~( divisors[5] ^ divisors[14] );
+      break;
+    case 2u:
+      target = ternary_majority( divisors[1], ~divisors[2], divisors[6] ) ^ ( divisors[2] & divisors[1] );
+      break;
+    case 3u:
+      target = ~divisors[4] & divisors[7];
+      break;
+    case 4u:
+      create_random( target, t + 200u );
+      break;
+    }
+    if ( t % 8u >= 4u )
+    {
+      care = ~target.construct();
+    }
+
+    const auto expected = minimum_divisors( target, care, divisors );
+    ++num_solutions[expected];
+    for ( auto num_threads : { 1u, 3u } )
+    {
+      resubstitution_params ps;
+      ps.num_threads = num_threads;
+      resubstitution_stats st;
+      const auto res = find_resubstitution( target, care, divisors, ps, &st );
+      if ( expected == 4u )
+      {
+        EXPECT_FALSE( res );
+      }
+      else
+      {
+        ASSERT_TRUE( res );
+        EXPECT_EQ( res->divisors.size(), expected );
+        check( target, care, divisors, *res );
+      }
+    }
+  }
+
+  /* the searches for two and three divisors are exercised */
+  EXPECT_GT( num_solutions[2u], 10u );
+  EXPECT_GT( num_solutions[3u], 10u );
+  EXPECT_GT( num_solutions[4u], 0u );
+}
+
+TEST_F( ResubstitutionTest, parallel_is_deterministic )
+{
+  std::vector<partial_truth_table> divisors( 60u, partial_truth_table( 500u ) );
+  for ( auto i = 0u; i < divisors.size(); ++i )
+  {
+    create_random( divisors[i], i );
+  }
+  /* many solutions */
+  for ( auto i = 30u; i < divisors.size(); ++i )
+  {
+    divisors[i] = divisors[i - 30u] & divisors[i - 29u];
+  }
+  const auto target = divisors[10] ^ divisors[40] ^ divisors[50];
+
+  const auto r1 = find_resubstitution( target, divisors );
+  ASSERT_TRUE( r1 );
+  for ( auto num_threads : { 2u, 4u } )
+  {
+    resubstitution_params ps;
+    ps.num_threads = num_threads;
+    const auto r = find_resubstitution( target, divisors, ps );
+    ASSERT_TRUE( r );
+    EXPECT_EQ( r->divisors, r1->divisors );
+    EXPECT_EQ( r->function, r1->function );
+  }
+}
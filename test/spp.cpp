@@ -25,9 +25,15 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <sstream>
+
 #include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
 #include <kitty/esop.hpp>
+#include <kitty/isop.hpp>
 #include <kitty/print.hpp>
+#include <kitty/pseudo_cube.hpp>
 #include <kitty/spp.hpp>
 
 using namespace kitty;
@@ -65,4 +71,131 @@ TEST( SppTest, random_examples )
 
     EXPECT_EQ( tt, tt_check );
   }
-}
\ No newline at end of file
+}
+
+TEST( SppTest, pseudo_cube )
+{
+  pseudo_cube c( 0b0101 );
+  EXPECT_EQ( c.dimension(), 0u );
+  EXPECT_TRUE( c.contains( 0b0101 ) );
+  EXPECT_FALSE( c.contains( 0b0100 ) );
+
+  EXPECT_TRUE( c.add_direction( 0b0011 ) );
+  EXPECT_TRUE( c.add_direction( 0b0110 ) );
+  EXPECT_FALSE( c.add_direction( 0b0101 ) );
+  EXPECT_EQ( c.dimension(), 2u );
+  EXPECT_EQ( c.pivots(), 0b0110u );
+
+  std::vector<uint32_t> minterms;
+  c.foreach_minterm( [&]( auto m ) { minterms.push_back( m ); } );
+  std::sort( minterms.begin(), minterms.end() );
+  EXPECT_EQ( minterms, ( std::vector<uint32_t>{ 0b0000, 0b0011, 0b0101, 0b0110 } ) );
+  for ( auto m = 0u; m < 16u; ++m )
+  {
+    EXPECT_EQ( c.contains( m ), std::find( minterms.begin(), minterms.end(), m ) != minterms.end() );
+  }
+
+  /* canonical representation does not depend on the generators */
+  pseudo_cube c2( 0b0110 );
+  c2.add_direction( 0b0101 );
+  c2.add_direction( 0b0011 );
+  EXPECT_EQ( c, c2 );
+  EXPECT_EQ( hash<pseudo_cube>{}( c ), hash<pseudo_cube>{}( c2 ) );
+
+  /* !x3 (x0^x1^x2) */
+  std::vector<std::pair<uint32_t, bool>> factors;
+  c.foreach_factor( 4u, [&]( auto mask, auto value ) { factors.emplace_back( mask, value ); } );
+  EXPECT_EQ( factors.size(), 2u );
+  EXPECT_EQ( c.num_literals( 4u ), 4u );
+  std::stringstream s;
+  c.print( 4u, s );
+  EXPECT_EQ( s.str(), "!(x0^x1^x2) !x3" );
+
+  const pseudo_cube from_cube( cube( "1-0-" ), 4u );
+  EXPECT_EQ( from_cube.dimension(), 2u );
+  EXPECT_EQ( from_cube.num_literals( 4u ), 2u );
+  EXPECT_TRUE( from_cube.contains( pseudo_cube( 0b1001 ) ) );
+  EXPECT_FALSE( from_cube.contains( c ) );
+}
+
+TEST( SppTest, minimize_spp_parity )
+{
+  for ( auto n = 1u; n <= 16u; ++n )
+  {
+    dynamic_truth_table tt( n ), tt_check( n );
+    create_parity( tt );
+
+    spp_stats st;
+    const auto spp = minimize_spp( tt, {}, &st );
+    EXPECT_EQ( spp.size(), 1u );
+    EXPECT_EQ( st.literals, n );
+    create_from_spp( tt_check, spp );
+    EXPECT_EQ( tt, tt_check );
+  }
+}
+
+TEST( SppTest, minimize_spp_random )
+{
+  for ( auto n = 0u; n <= 10u; ++n )
+  {
+    for ( auto i = 0u; i < 10u; ++i )
+    {
+      dynamic_truth_table tt( n ), dc( n ), tt_check( n );
+      create_random( tt );
+      create_random( dc );
+      create_random( tt_check );
+      dc &= tt_check; /* about a quarter of the minterms are don't cares */
+
+      const auto spp = minimize_spp( tt, dc );
+      create_from_spp( tt_check, spp );
+      EXPECT_TRUE( is_const0( ( tt & ~dc ) & ~tt_check ) );
+      EXPECT_TRUE( is_const0( tt_check & ~( tt | dc ) ) );
+
+      /* at most as many pseudo products as cubes in an irredundant SOP */
+      const auto cubes = isop( tt );
+      EXPECT_LE( minimize_spp( tt ).size(), cubes.size() );
+    }
+  }
+}
+
+TEST( SppTest, minimize_spp_exact )
+{
+  for ( auto i = 0u; i < 50u; ++i )
+  {
+    static_truth_table<5> tt, tt_check;
+    create_random( tt );
+
+    spp_stats st_greedy, st_exact;
+    const auto greedy = minimize_spp( tt, {}, &st_greedy );
+
+    spp_params ps;
+    ps.exact = true;
+    ps.max_spaces = 1000000u;
+    const auto exact = minimize_spp( tt, ps, &st_exact );
+    EXPECT_TRUE( st_exact.optimal );
+    EXPECT_LE( exact.size(), greedy.size() );
+    create_from_spp( tt_check, exact );
+    EXPECT_EQ( tt, tt_check );
+  }
+
+  /* x0 (x1^x2) | !x0 x3 x4 */
+  static_truth_table<5> tt, tt_check;
+  create_from_expression( tt, "{(a[bc])(!ade)}" );
+  spp_params ps;
+  ps.exact = true;
+  const auto spp = minimize_spp( tt, ps );
+  EXPECT_EQ( spp.size(), 2u );
+  create_from_spp( tt_check, spp );
+  EXPECT_EQ( tt, tt_check );
+
+  /* falls back to greedy cover for too many pseudo cubes */
+  dynamic_truth_table large( 12 );
+  create_majority( large );
+  ps.max_spaces = 100u;
+  spp_stats st;
+  const auto fallback = minimize_spp( large, ps, &st );
+  EXPECT_FALSE( st.optimal );
+  dynamic_truth_table large_check( 12 );
+  create_from_spp( large_check, fallback );
+  EXPECT_EQ( large, large_check );
+}
@@ -0,0 +1,236 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/partial_truth_table.hpp>
+#include <kitty/static_truth_table.hpp>
+#include <kitty/truth_table_store.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class TruthTableStoreTest : public kitty::testing::Test
+{
+};
+
+TEST_F( TruthTableStoreTest, deduplicate_static )
+{
+  truth_table_store<static_truth_table<4>> store;
+
+  std::vector<static_truth_table<4>> funcs( 500u );
+  for ( auto& tt : funcs )
+  {
+    create_random( tt );
+  }
+
+  std::vector<uint32_t> ids;
+  for ( const auto& tt : funcs )
+  {
+    ids.push_back( store.insert( tt ) );
+  }
+
+  std::unordered_set<static_truth_table<4>, hash<static_truth_table<4>>> reference( funcs.begin(), funcs.end() );
+  EXPECT_EQ( store.size(), reference.size() );
+
+  for ( auto i = 0u; i < funcs.size(); ++i )
+  {
+    EXPECT_LT( ids[i], store.size() );
+    EXPECT_EQ( store[ids[i]], funcs[i] );
+    EXPECT_EQ( store.insert( funcs[i] ), ids[i] );
+    EXPECT_EQ( store.find( funcs[i] ), ids[i] );
+    for ( auto j = 0u; j < i; ++j )
+    {
+      EXPECT_EQ( ids[i] == ids[j], funcs[i] == funcs[j] );
+    }
+  }
+
+  const auto st = store.statistics();
+  EXPECT_EQ( st.entries, reference.size() );
+  EXPECT_EQ( st.insertions, 2u * funcs.size() );
+  EXPECT_EQ( st.duplicates, 2u * funcs.size() - reference.size() );
+}
+
+TEST_F( TruthTableStoreTest, consecutive_ids )
+{
+  truth_table_store<dynamic_truth_table> store;
+
+  for ( auto i = 0u; i < 4096u; ++i )
+  {
+    dynamic_truth_table tt( 12u );
+    tt._bits[i / 64u] = uint64_t( 1 ) << ( i % 64u );
+    EXPECT_EQ( store.insert( tt ), i );
+  }
+  EXPECT_EQ( store.size(), 4096u );
+
+  /* words of earlier entries are not moved by later insertions */
+  const auto words = store.words( 0u );
+  for ( auto i = 0u; i < 4096u; ++i )
+  {
+    dynamic_truth_table tt( 12u );
+    tt._bits[i / 64u] = uint64_t( 1 ) << ( i % 64u );
+    EXPECT_EQ( store.find( tt ), i );
+    EXPECT_EQ( store.num_blocks( i ), 64u );
+    EXPECT_TRUE( std::equal( tt.cbegin(), tt.cend(), store.words( i ) ) );
+  }
+  EXPECT_EQ( store.words( 0u ), words );
+}
+
+TEST_F( TruthTableStoreTest, mixed_sizes )
+{
+  truth_table_store<dynamic_truth_table> store( { 4u, 16u } );
+
+  std::vector<dynamic_truth_table> funcs;
+  for ( auto n = 0u; n <= 10u; ++n )
+  {
+    /* constant 0 in every size is a different truth table */
+    funcs.emplace_back( n );
+    for ( auto i = 0u; i < 10u; ++i )
+    {
+      funcs.emplace_back( n );
+      create_random( funcs.back() );
+    }
+  }
+
+  std::vector<uint32_t> ids;
+  for ( const auto& tt : funcs )
+  {
+    ids.push_back( store.insert( tt ) );
+  }
+
+  for ( auto i = 0u; i < funcs.size(); ++i )
+  {
+    const auto tt = store[ids[i]];
+    EXPECT_EQ( tt.num_vars(), funcs[i].num_vars() );
+    EXPECT_EQ( tt, funcs[i] );
+    EXPECT_EQ( store.find( funcs[i] ), ids[i] );
+  }
+
+  dynamic_truth_table tt( 11u );
+  EXPECT_FALSE( store.find( tt ) );
+}
+
+TEST_F( TruthTableStoreTest, partial )
+{
+  truth_table_store<partial_truth_table> store;
+
+  std::vector<partial_truth_table> funcs;
+  for ( auto bits : { 0u, 1u, 5u, 63u, 64u, 65u, 200u } )
+  {
+    funcs.emplace_back( bits );
+    funcs.emplace_back( bits );
+    create_random( funcs.back() );
+  }
+
+  std::vector<uint32_t> ids;
+  for ( const auto& tt : funcs )
+  {
+    ids.push_back( store.insert( tt ) );
+  }
+
+  for ( auto i = 0u; i < funcs.size(); ++i )
+  {
+    const auto tt = store[ids[i]];
+    EXPECT_EQ( tt.num_bits(), funcs[i].num_bits() );
+    EXPECT_EQ( tt, funcs[i] );
+    EXPECT_EQ( store.insert( funcs[i] ), ids[i] );
+  }
+}
+
+TEST_F( TruthTableStoreTest, concurrent_insertion )
+{
+  truth_table_store<static_truth_table<8>> store( { 8u, 64u } );
+
+  std::vector<static_truth_table<8>> funcs( 2000u );
+  for ( auto& tt : funcs )
+  {
+    create_random( tt );
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<uint32_t>> ids( 4u );
+  for ( auto t = 0u; t < 4u; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      /* each thread inserts in a different order */
+      for ( auto i = 0u; i < funcs.size(); ++i )
+      {
+        const auto j = ( i * ( 2u * t + 1u ) + 17u * t ) % funcs.size();
+        ids[t].push_back( j );
+        ids[t].push_back( store.insert( funcs[j] ) );
+        store[ids[t].back()];
+      }
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ( store.size(), funcs.size() );
+  for ( auto t = 0u; t < 4u; ++t )
+  {
+    for ( auto i = 0u; i < ids[t].size(); i += 2u )
+    {
+      const auto j = ids[t][i];
+      EXPECT_EQ( store[ids[t][i + 1u]], funcs[j] );
+      EXPECT_EQ( store.find( funcs[j] ), ids[t][i + 1u] );
+    }
+  }
+
+  const auto st = store.statistics();
+  EXPECT_EQ( st.insertions, 4u * funcs.size() );
+  EXPECT_EQ( st.duplicates, 3u * funcs.size() );
+}
+
+TEST_F( TruthTableStoreTest, memory_usage )
+{
+  truth_table_store<static_truth_table<10>> store( { 16u, 1024u } );
+
+  const auto empty = store.statistics();
+  EXPECT_EQ( empty.entries, 0u );
+  EXPECT_EQ( empty.arena_bytes, 0u );
+
+  for ( auto i = 0u; i < 100u; ++i )
+  {
+    static_truth_table<10> tt;
+    create_random( tt );
+    store.insert( tt );
+  }
+
+  /* 16 words per truth table, 64 truth tables per page */
+  const auto st = store.statistics();
+  EXPECT_EQ( st.entries, 100u );
+  EXPECT_EQ( st.arena_bytes, 2u * 1024u * sizeof( uint64_t ) );
+  EXPECT_GT( st.index_bytes, empty.index_bytes );
+  EXPECT_EQ( st.memory_usage(), st.arena_bytes + st.index_bytes );
+}
@@ -0,0 +1,203 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kitty/cnf.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/implicant.hpp>
+#include <kitty/isop.hpp>
+#include <kitty/static_truth_table.hpp>
+#include <kitty/wide_cube.hpp>
+
+#include "utility.hpp"
+
+using namespace kitty;
+
+class WideCubeTest : public kitty::testing::Test
+{
+protected:
+  template<typename Cube>
+  std::string to_string( const Cube& c, uint32_t num_vars )
+  {
+    std::stringstream ss;
+    c.print( num_vars, ss );
+    return ss.str();
+  }
+
+  /* compares literals of two cube types */
+  template<typename Cube1, typename Cube2>
+  bool same_literals( const Cube1& c1, const Cube2& c2, uint32_t num_vars )
+  {
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      if ( c1.get_mask( i ) != c2.get_mask( i ) || c1.get_bit( i ) != c2.get_bit( i ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+TEST_F( WideCubeTest, construction_and_printing )
+{
+  const std::string str = "1-0" + std::string( 60, '-' ) + "01-1";
+
+  EXPECT_EQ( to_string( wide_cube<67>( str ), 67 ), str );
+  EXPECT_EQ( to_string( dynamic_cube( str ), 67 ), str );
+  EXPECT_EQ( to_string( wide_cube<67>( str + "111" ), 67 ), str );
+
+  EXPECT_EQ( wide_cube<67>( str ).num_literals(), 5 );
+  EXPECT_EQ( dynamic_cube( str ).num_literals(), 5 );
+
+  EXPECT_EQ( to_string( wide_cube<100>::pos_cube( 70 ), 70 ), std::string( 70, '1' ) );
+  EXPECT_EQ( to_string( dynamic_cube::neg_cube( 70 ), 70 ), std::string( 70, '0' ) );
+  EXPECT_EQ( to_string( wide_cube<40>( 5u, 7u ), 3 ), "101" );
+}
+
+TEST_F( WideCubeTest, distance_and_merge )
+{
+  wide_cube<80> a( "1-0" + std::string( 70, '-' ) + "1" );
+  wide_cube<80> b( "1-0" + std::string( 70, '-' ) + "0" );
+  wide_cube<80> c( "1-0" + std::string( 70, '-' ) + "-" );
+
+  EXPECT_EQ( a.distance( b ), 1 );
+  EXPECT_EQ( a.distance( c ), 1 );
+  EXPECT_EQ( b.distance( ~a ), 2 );
+
+  /* negation keeps bits outside the mask 0 */
+  EXPECT_EQ( ~wide_cube<80>( "1-0" ), wide_cube<80>( "0-1" ) );
+  EXPECT_EQ( ~dynamic_cube( "1-0" ), dynamic_cube( "0-1" ) );
+  EXPECT_EQ( ~~a, a );
+  EXPECT_EQ( a.merge( b ), c );
+  EXPECT_EQ( a.merge( c ), b ); /* a xor c = b */
+
+  dynamic_cube da( "1-0" + std::string( 70, '-' ) + "1" );
+  dynamic_cube db( "1-0" + std::string( 70, '-' ) + "0" );
+  dynamic_cube dc( "1-0" );
+  EXPECT_EQ( da.distance( db ), 1 );
+  EXPECT_EQ( da.merge( db ), dc );
+  EXPECT_EQ( da.merge( dc ), db );
+
+  /* trailing zero words are ignored */
+  auto d = dc;
+  d.add_literal( 100 );
+  d.remove_literal( 100 );
+  EXPECT_EQ( d, dc );
+  EXPECT_EQ( hash<dynamic_cube>()( d ), hash<dynamic_cube>()( dc ) );
+  EXPECT_FALSE( d < dc );
+  EXPECT_FALSE( dc < d );
+}
+
+TEST_F( WideCubeTest, ordering )
+{
+  /* both cube types order cubes from the highest word, mask before bits */
+  std::vector<std::string> strs;
+  for ( auto i = 0u; i < 30u; ++i )
+  {
+    std::string str( 70u, '-' );
+    for ( auto j = 0u; j < 4u; ++j )
+    {
+      str[( i * 17u + j * 23u ) % 70u] = "01"[( i >> j ) & 1u];
+    }
+    strs.push_back( str );
+  }
+
+  for ( const auto& a : strs )
+  {
+    for ( const auto& b : strs )
+    {
+      EXPECT_EQ( wide_cube<70>( a ) < wide_cube<70>( b ), dynamic_cube( a ) < dynamic_cube( b ) );
+    }
+  }
+
+  EXPECT_TRUE( wide_cube<70>( "1" ) < wide_cube<70>( std::string( 69u, '-' ) + "0" ) );
+  EXPECT_TRUE( dynamic_cube( "1" ) < dynamic_cube( std::string( 69u, '-' ) + "0" ) );
+}
+
+TEST_F( WideCubeTest, hashing )
+{
+  std::unordered_set<wide_cube<70>, hash<wide_cube<70>>> set;
+  for ( auto i = 0u; i < 70u; ++i )
+  {
+    set.insert( wide_cube<70>::nth_var_cube( i ) );
+    set.insert( ~wide_cube<70>::nth_var_cube( i ) );
+  }
+  set.insert( wide_cube<70>::nth_var_cube( 69 ) );
+  EXPECT_EQ( set.size(), 140u );
+}
+
+TEST_F( WideCubeTest, isop_and_create_from_cubes )
+{
+  dynamic_truth_table tt( 9u ), tt2( 9u );
+  for ( auto i = 0; i < 20; ++i )
+  {
+    create_random( tt );
+
+    const auto cubes = isop( tt );
+    const auto wcubes = isop<dynamic_truth_table, wide_cube<64>>( tt );
+    const auto dcubes = isop<dynamic_truth_table, dynamic_cube>( tt );
+    ASSERT_EQ( cubes.size(), wcubes.size() );
+    ASSERT_EQ( cubes.size(), dcubes.size() );
+    for ( auto j = 0u; j < cubes.size(); ++j )
+    {
+      EXPECT_TRUE( same_literals( cubes[j], wcubes[j], 9u ) );
+      EXPECT_TRUE( same_literals( cubes[j], dcubes[j], 9u ) );
+    }
+
+    create_from_cubes( tt2, wcubes );
+    EXPECT_EQ( tt, tt2 );
+    create_from_cubes( tt2, dcubes );
+    EXPECT_EQ( tt, tt2 );
+
+    const auto primes = get_prime_implicants_morreale( tt );
+    const auto wprimes = get_prime_implicants_morreale<dynamic_truth_table, wide_cube<40>>( tt );
+    ASSERT_EQ( primes.size(), wprimes.size() );
+    for ( auto j = 0u; j < primes.size(); ++j )
+    {
+      EXPECT_TRUE( same_literals( primes[j], wprimes[j], 9u ) );
+    }
+  }
+}
+
+TEST_F( WideCubeTest, cnf_characteristic )
+{
+  dynamic_truth_table f( 8u ), f_c1( 9u ), f_c2( 9u );
+  for ( auto i = 0; i < 20; ++i )
+  {
+    create_random( f );
+    create_from_clauses( f_c1, cnf_characteristic<dynamic_truth_table, dynamic_cube>( f ) );
+    create_characteristic( f_c2, f );
+    EXPECT_EQ( f_c1, f_c2 );
+  }
+}